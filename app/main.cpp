@@ -2,7 +2,13 @@
 
 #include "commands/ResumeDump.hpp"
 #include "commands/analyze.hpp"
+#include "commands/bench.hpp"
+#include "commands/check.hpp"
 #include "commands/embed.hpp"
+#include "commands/evalRetrieval.hpp"
+#include "commands/extract.hpp"
+#include "commands/llmCache.hpp"
+#include "commands/llmMock.hpp"
 #include "commands/build.hpp"
 #include "commands/run.hpp"
 #include "commands/validate.hpp"
@@ -18,7 +24,14 @@ static int print_usage() {
         << "  resume-agent resume dump [path]\n"
         << "  resume-agent analyze [args]\n"
         << "  resume-agent embed [args]\n"
+        << "  resume-agent extract [args]\n"
         << "  resume-agent build [args]\n"
+        << "  resume-agent bench extract [args]\n"
+        << "  resume-agent bench rerank [args]\n"
+        << "  resume-agent check shrink|proc|http [args]\n"
+        << "  resume-agent eval-retrieval --labels <path> [args]\n"
+        << "  resume-agent llm-cache stats|compact [args]\n"
+        << "  resume-agent llm-mock pack --llm_mock <dir> --out <path>\n"
         << "  resume-agent help\n";
     return 1;
 }
@@ -26,7 +39,8 @@ static int print_usage() {
 static int print_run_help() {
     std::cerr
         << "usage:\n"
-        << "  resume-agent run --role \"<job title>\" --resume <path> [--outdir <dir>]\n"
+        << "  resume-agent run --role \"<job title>\" --resume <path> [--outdir <dir>] [--profile_cache <dir>]\n"
+        << "                   [--semantic_cache <path>]\n"
         << "\n"
         << "required:\n"
         << "  --role <str>                 (required)\n"
@@ -34,6 +48,9 @@ static int print_run_help() {
         << "\n"
         << "optional:\n"
         << "  --outdir <dir>               default: out\n"
+        << "  --profile_cache <dir>        default: out/profile_cache (\"\" disables)\n"
+        << "  --semantic_cache <path>      default: out/semantic_cache/profile_skill_index.bin\n"
+        << "                               (skill vectors shared by every role; \"\" disables)\n"
         << "\n"
         << "notes:\n"
         << "  This runs:\n"
@@ -62,23 +79,53 @@ static int print_analyze_help() {
     std::cerr
         << "usage:\n"
         << "  resume-agent analyze --role \"<job title>\" [options]\n"
+        << "  resume-agent analyze --roles <file> [options]\n"
         << "\n"
         << "common:\n"
-        << "  --role <str>                 (required)\n"
+        << "  --role <str>                 (required unless --roles)\n"
+        << "  --roles <path>               one role per line; loads corpus/index/model once, ranks roles\n"
+        << "                               in parallel, writes <outdir>/<role>/profile.json + mentions.jsonl\n"
+        << "  --threads <n>                --roles ranking threads, default: 0 (one per core)\n"
         << "  --jobs <dir>                 default: data/jobs/raw\n"
         << "  --topk <n>                   default: 15\n"
         << "  --min_score <f>              default: 0.30\n"
         << "  --out <path>                 optional: mirror console output to a file\n"
         << "  --outdir <dir>               default: out\n"
+        << "  --emb <path>                 default: data/embeddings/jobs.bin\n"
+        << "  --corpus_index <path>        default: <emb>.corpus.bin (written by embed; rebuilt in memory if stale)\n"
+        << "  --skills <path>              extra skills TSV for non-LLM extraction (e.g. data/skills/skills.tsv)\n"
+        << "  --mentions_store <path>      default: <emb>.mentions.bin (written by extract; used when it matches\n"
+        << "                               the jobs dir and extraction mode, else mentions are extracted live)\n"
         << "\n"
         << "profile:\n"
         << "  --profile                    write out/profile.json + out/mentions.jsonl\n"
+        << "  --profile_cache <dir>        default: out/profile_cache (reuse profiles whose role, corpus,\n"
+        << "                               jobs.bin and parameters are unchanged; \"\" disables)\n"
         << "\n"
         << "llm:\n"
         << "  --llm                        enable LLM extraction path\n"
         << "  --llm_model <str>            default: llama3.1:8b\n"
         << "  --llm_cache <dir>            default: out/llm_cache\n"
-        << "  --llm_mock <dir>             use mock responses from dir (disables real ollama)\n";
+        << "  --llm_mock <dir|pack>        use mock responses from a dir or llm-mock pack (disables real ollama)\n"
+        << "  --llm_mock_latency <ms>      mock: delay per posting, default: 0\n"
+        << "  --llm_mock_jitter <ms>       mock: extra delay of up to this much, fixed per posting, default: 0\n"
+        << "  --llm_concurrency <n>        postings sent to the model at once, default: 4\n"
+        << "  --llm_timeout <sec>          per-request timeout, default: 300\n"
+        << "  --llm_no_stream              wait for whole responses instead of streaming them and\n"
+        << "                               stopping once the JSON is complete\n"
+        << "  --llm_batch <n>              uncached postings per request, default: 4 (1 = one each)\n"
+        << "  --llm_batch_tokens <n>       posting text per batched request, default: 6000 tokens\n"
+        << "  --llm_posting_tokens <n>     each posting is cut to its best sections within this many\n"
+        << "                               tokens (counted with --vocab), default: 512\n"
+        << "  --llm_hybrid                 run the skill extractor first and send only postings it is\n"
+        << "                               unsure about to the LLM (implies --llm)\n"
+        << "  --llm_min_confidence <f>     hybrid: extractor confidence (0..1) below which a posting\n"
+        << "                               goes to the LLM, default: 0.5\n"
+        << "  --llm_record <path>          log every LLM call (cache key, prompt tokens, latency, first\n"
+        << "                               byte, cache hit, evidence) for --llm_replay\n"
+        << "  --llm_replay <path>          serve LLM calls from a --llm_record log, with its latencies\n"
+        << "                               (implies --llm)\n"
+        << "  --llm_replay_speed <x>       replay at x times the recorded speed, default: 1 (0 = no waits)\n";
     return 0;
 }
 
@@ -92,7 +139,97 @@ static int print_embed_help() {
         << "  --out <path>                 default: data/embeddings/jobs.bin\n"
         << "  --model <path>               default: models/emb/model.onnx\n"
         << "  --vocab <path>               default: models/emb/vocab.txt\n"
-        << "  --max_len <n>                default: 256\n";
+        << "  --max_len <n>                default: 256\n"
+        << "  --corpus_index <path>        default: <out>.corpus.bin (token/zone sidecar for analyze)\n"
+        << "  --index_only                 only rebuild the corpus index, skip embedding\n";
+    return 0;
+}
+
+static int print_extract_help() {
+    std::cerr
+        << "usage:\n"
+        << "  resume-agent extract [options]\n"
+        << "\n"
+        << "Extracts skill mentions from every posting and writes one JSON line per posting\n"
+        << "(sorted by posting id) plus the mentions store analyze aggregates from.\n"
+        << "The non-LLM extractor runs in parallel.\n"
+        << "\n"
+        << "options:\n"
+        << "  --jobs <dir>                 default: data/jobs/raw\n"
+        << "  --out <path>                 default: out/corpus_mentions.jsonl\n"
+        << "  --store <path>               default: data/embeddings/jobs.mentions.bin (\"\" to skip)\n"
+        << "  --threads <n>                default: 0 (one per core)\n"
+        << "  --skills <path>              extra skills TSV, added to the built-in lexicon\n"
+        << "\n"
+        << "llm:\n"
+        << "  --llm                        extract with the LLM instead (same args as analyze)\n"
+        << "  --llm_model <str>            default: llama3.2:3b\n"
+        << "  --llm_cache <dir>            default: out/llm_cache\n"
+        << "  --llm_mock <dir|pack>        use mock responses from a dir or llm-mock pack\n"
+        << "  --llm_mock_latency <ms>      mock: delay per posting, default: 0\n"
+        << "  --llm_mock_jitter <ms>       mock: extra delay of up to this much, fixed per posting, default: 0\n"
+        << "  --llm_concurrency <n>        postings sent to the model at once, default: 4\n"
+        << "  --llm_timeout <sec>          per-request timeout, default: 300\n"
+        << "  --llm_no_stream              wait for whole responses instead of streaming them and\n"
+        << "                               stopping once the JSON is complete\n"
+        << "  --llm_batch <n>              uncached postings per request, default: 4 (1 = one each)\n"
+        << "  --llm_batch_tokens <n>       posting text per batched request, default: 6000 tokens\n"
+        << "  --llm_posting_tokens <n>     each posting is cut to its best sections within this many\n"
+        << "                               tokens (counted with --vocab), default: 512\n"
+        << "  --vocab <path>               default: models/emb/vocab.txt\n";
+    return 0;
+}
+
+static int print_eval_retrieval_help() {
+    std::cerr
+        << "usage:\n"
+        << "  resume-agent eval-retrieval --labels <path> [options]\n"
+        << "\n"
+        << "Runs analyze's retrieval + rerank for each labelled role under every config and reports\n"
+        << "recall@k, nDCG@k, MRR and p50/p99 stage latency.\n"
+        << "\n"
+        << "options:\n"
+        << "  --labels <path>              (required) file or dir of files: role<TAB>posting_id[ ,posting_id...]\n"
+        << "  --configs <path>             one per line: name key=value ... (bigk_floor, min_score, topn_seed,\n"
+        << "                               topx_tokens, title, lead, req, body_query, body_lex, emb,\n"
+        << "                               penalty_title_conflict, penalty_missing_identity,\n"
+        << "                               bonus_identity_in_title); default: a bigk_floor/min_score sweep\n"
+        << "  --k <n>                      default: 10\n"
+        << "  --min_score <f>              default: 0.30 (base for every config)\n"
+        << "  --iters <n>                  timed runs per role and config, default: 5\n"
+        << "  --jobs <dir>                 default: data/jobs/sample500\n"
+        << "  --emb <path>                 default: data/embeddings/jobs.bin\n"
+        << "  --corpus_index <path>        default: <emb>.corpus.bin\n"
+        << "  --out <path>                 optional: JSON report\n";
+    return 0;
+}
+
+static int print_llm_cache_help() {
+    std::cerr
+        << "usage:\n"
+        << "  resume-agent llm-cache stats [options]\n"
+        << "  resume-agent llm-cache compact [options]\n"
+        << "\n"
+        << "LLM responses are appended to <llm_cache>/llm_cache.kv; a re-asked prompt adds a record\n"
+        << "and the old one stays until compact rewrites the log with the newest record per key.\n"
+        << "Safe to run while analyze/extract are using the cache.\n"
+        << "\n"
+        << "options:\n"
+        << "  --llm_cache <dir>            default: out/llm_cache\n";
+    return 0;
+}
+
+static int print_llm_mock_help() {
+    std::cerr
+        << "usage:\n"
+        << "  resume-agent llm-mock pack --llm_mock <dir> --out <path>\n"
+        << "\n"
+        << "Packs a directory of mock responses (<posting_id>.json) into one file that --llm_mock\n"
+        << "also accepts; it loads without parsing any JSON.\n"
+        << "\n"
+        << "options:\n"
+        << "  --llm_mock <dir>             fixture directory\n"
+        << "  --out <path>                 pack to write\n";
     return 0;
 }
 
@@ -113,7 +250,8 @@ static int print_build_help() {
         << "  --emb_vocab <path>           default: models/emb/vocab.txt\n"
         << "  --semantic_threshold <f>      default: 0.66\n"
         << "  --semantic_topk <n>           default: 1\n"
-        << "  --semantic_cache <path>       default: (none)\n"
+        << "  --semantic_cache <path>       default: (none); skill vectors, reused across profiles\n"
+        << "                                and re-embedded when the model or vocab changes\n"
         << "\n"
         << "selection (only used when NOT --scores_only):\n"
         << "  --scores_only                only write out/bullet_scores.json\n"
@@ -125,6 +263,51 @@ static int print_build_help() {
     return 0;
 }
 
+static int print_bench_help() {
+    std::cerr
+        << "usage:\n"
+        << "  resume-agent bench extract [options]\n"
+        << "\n"
+        << "options:\n"
+        << "  --jobs <dir>                 default: data/jobs/sample500\n"
+        << "  --skills <path>              extra skills TSV, added to the built-in lexicon\n"
+        << "  --synthetic_skills <n>       pad the dictionary with n never-matching skills\n"
+        << "  --iters <n>                  default: 5\n"
+        << "\n"
+        << "  resume-agent bench rerank [options]\n"
+        << "\n"
+        << "options:\n"
+        << "  --jobs <dir>                 default: data/jobs/sample500\n"
+        << "  --role <text>                default: C++ Backend Engineer\n"
+        << "  --candidates <n>             rows scored per pass (postings repeated; default: 10000)\n"
+        << "  --iters <n>                  default: 20\n";
+    return 0;
+}
+
+static int print_check_help() {
+    std::cerr
+        << "usage:\n"
+        << "  resume-agent check shrink [options]\n"
+        << "\n"
+        << "options:\n"
+        << "  --posting <path>             also shrink this posting and print the result\n"
+        << "  --budget <n>                 token budget for --posting (default: 300)\n"
+        << "  --vocab <path>               count --posting tokens with this WordPiece vocab\n"
+        << "                               (default: ~4 chars per token)\n"
+        << "\n"
+        << "  resume-agent check proc\n"
+        << "\n"
+        << "  no options; runs shell children through procutil (streams, output caps,\n"
+        << "  timeouts, run_async, run_capture_stdout)\n"
+        << "\n"
+        << "  resume-agent check http [--host <host:port>]\n"
+        << "\n"
+        << "  talks to the local stand-in server (python ollama_standin.py; default\n"
+        << "  --host 127.0.0.1:11435): keep-alive, chunked streams, reconnects, timeouts;\n"
+        << "  also checks OLLAMA_HOST-style endpoint parsing, e.g. [::1]:11434\n";
+    return 0;
+}
+
 int main(int argc, char** argv) {
     if (argc < 2) return print_usage();
 
@@ -144,13 +327,25 @@ int main(int argc, char** argv) {
     if (cmd == "validate" && (argc >= 3 && std::string(argv[2]) == "--help")) return print_validate_help();
     if (cmd == "analyze"  && (argc >= 3 && std::string(argv[2]) == "--help")) return print_analyze_help();
     if (cmd == "embed"    && (argc >= 3 && std::string(argv[2]) == "--help")) return print_embed_help();
+    if (cmd == "extract"  && (argc >= 3 && std::string(argv[2]) == "--help")) return print_extract_help();
     if (cmd == "build"    && (argc >= 3 && std::string(argv[2]) == "--help")) return print_build_help();
+    if (cmd == "bench"    && (argc < 3 || std::string(argv[2]) == "--help")) return print_bench_help();
+    if (cmd == "check"    && (argc < 3 || std::string(argv[2]) == "--help")) return print_check_help();
+    if (cmd == "eval-retrieval" && (argc < 3 || std::string(argv[2]) == "--help")) return print_eval_retrieval_help();
+    if (cmd == "llm-cache" && (argc < 3 || std::string(argv[2]) == "--help")) return print_llm_cache_help();
+    if (cmd == "llm-mock" && (argc < 3 || std::string(argv[2]) == "--help")) return print_llm_mock_help();
 
     if (cmd == "run")      return cmd_run(argc - 1, argv + 1);
     if (cmd == "validate") return cmd_validate(argc - 1, argv + 1);
     if (cmd == "analyze")  return cmd_analyze(argc - 1, argv + 1);
     if (cmd == "embed")    return cmd_embed(argc - 1, argv + 1);
+    if (cmd == "extract")  return cmd_extract(argc - 1, argv + 1);
     if (cmd == "build")    return cmd_build(argc - 1, argv + 1);
+    if (cmd == "bench")    return cmd_bench(argc - 1, argv + 1);
+    if (cmd == "check")    return cmd_check(argc - 1, argv + 1);
+    if (cmd == "eval-retrieval") return cmd_eval_retrieval(argc - 1, argv + 1);
+    if (cmd == "llm-cache") return cmd_llm_cache(argc - 1, argv + 1);
+    if (cmd == "llm-mock")  return cmd_llm_mock(argc - 1, argv + 1);
 
     std::cerr << "unknown command\n";
     return print_usage();
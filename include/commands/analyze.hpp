@@ -1,5 +1,14 @@
 #pragma once
+#include <string>
 
 // usage:
 //   resume-agent analyze --role "C++ backend engineer" [--jobs data/jobs/raw] [--topk 25]
-int cmd_analyze(int argc, char** argv);
+//   resume-agent analyze --roles roles.txt --profile
+
+// what an in-process caller (run) may want to record about a single-role analyze
+struct AnalyzeResult {
+    bool profile_cache_hit = false;
+    std::string profile_cache_key; // empty when the cache was off
+};
+
+int cmd_analyze(int argc, char** argv, AnalyzeResult* result = nullptr);
@@ -0,0 +1,2 @@
+#pragma once
+int cmd_bench(int argc, char** argv);
@@ -0,0 +1,11 @@
+#pragma once
+
+// usage:
+//   resume-agent check shrink [--posting <path> --budget <n> --vocab <path>]
+//   resume-agent check proc
+//   resume-agent check http [--host <host:port>]     (against ollama_standin.py)
+//
+// Self-checks for pieces with no other caller-visible output; each prints one line per
+// case and exits non-zero if any case failed.
+
+int cmd_check(int argc, char** argv);
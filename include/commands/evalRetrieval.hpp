@@ -0,0 +1,6 @@
+#pragma once
+
+// usage:
+//   resume-agent eval-retrieval --labels labels.tsv [--configs configs.txt] [--k 10]
+
+int cmd_eval_retrieval(int argc, char** argv);
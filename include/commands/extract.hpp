@@ -0,0 +1,2 @@
+#pragma once
+int cmd_extract(int argc, char** argv);
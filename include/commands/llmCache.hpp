@@ -0,0 +1,6 @@
+#pragma once
+
+// usage:
+//   resume-agent llm-cache stats|compact [--llm_cache out/llm_cache]
+
+int cmd_llm_cache(int argc, char** argv);
@@ -0,0 +1,6 @@
+#pragma once
+
+// usage:
+//   resume-agent llm-mock pack --llm_mock <dir> --out <path>
+
+int cmd_llm_mock(int argc, char** argv);
@@ -13,6 +13,9 @@ public:
     // L2-normalized embedding
     std::vector<float> embed(const std::string& text, size_t max_len = 256) const;
 
+    // one session run over all texts (padded to the longest); same vectors as embed()
+    std::vector<std::vector<float>> embed_batch(const std::vector<std::string>& texts, size_t max_len = 256) const;
+
 private:
     WordPieceTokenizer m_tok;
 
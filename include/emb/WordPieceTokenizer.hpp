@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -10,6 +12,9 @@ public:
     // Returns token ids including [CLS] ... [SEP], truncated to max_len
     std::vector<int64_t> encode(const std::string& text, size_t max_len) const;
 
+    // number of word pieces in text (no [CLS]/[SEP], no truncation)
+    size_t count_tokens(const std::string& text) const;
+
     int64_t pad_id() const { return id_or(-1, "[PAD]"); }
     int64_t unk_id() const { return id_or(-1, "[UNK]"); }
     int64_t cls_id() const { return id_or(-1, "[CLS]"); }
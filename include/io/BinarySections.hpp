@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// Little helpers for the mmapped sidecar formats (CorpusIndex, MentionStore):
+// flat sections written back to back, each padded to 8 bytes so typed arrays can be
+// read in place from the mapping.
+
+struct SectionWriter {
+    std::ostream& out;
+
+    void bytes(const void* p, size_t n) { out.write((const char*)p, (std::streamsize)n); }
+
+    template <class T>
+    void pod(const T& v) { bytes(&v, sizeof(T)); }
+
+    template <class T>
+    void array(const std::vector<T>& v) { bytes(v.data(), v.size() * sizeof(T)); }
+
+    void pad() {
+        static const char zeros[8] = {};
+        const size_t at = (size_t)out.tellp();
+        if (at % 8) bytes(zeros, 8 - at % 8);
+    }
+
+    // u64 offs[n + 1], then the bytes of get(0..n-1)
+    template <class Get>
+    void strtab(size_t n, Get get) {
+        std::vector<uint64_t> offs(n + 1, 0);
+        for (size_t i = 0; i < n; ++i) offs[i + 1] = offs[i] + std::string_view(get(i)).size();
+        array(offs);
+        for (size_t i = 0; i < n; ++i) {
+            std::string_view s = get(i);
+            bytes(s.data(), s.size());
+        }
+        pad();
+    }
+
+    // u64 offs[rows + 1], then every row's elements
+    template <class T>
+    void csr(const std::vector<std::vector<T>>& rows) {
+        std::vector<uint64_t> offs(rows.size() + 1, 0);
+        for (size_t i = 0; i < rows.size(); ++i) offs[i + 1] = offs[i] + rows[i].size();
+        array(offs);
+        for (const auto& r : rows) array(r);
+        pad();
+    }
+};
+
+// bounds-checked walk over mapped bytes; any overrun clears `ok`
+struct SectionReader {
+    const char* base;
+    size_t size;
+    size_t at = 0;
+    bool ok = true;
+
+    const char* take(size_t n) {
+        if (!ok || n > size - at) { ok = false; return nullptr; }
+        const char* p = base + at;
+        at += n;
+        return p;
+    }
+
+    template <class T>
+    T pod() {
+        T v{};
+        if (const char* p = take(sizeof(T))) std::memcpy(&v, p, sizeof(T));
+        return v;
+    }
+
+    template <class T>
+    const T* array(size_t count) {
+        if (count > (size - at) / sizeof(T)) { ok = false; return nullptr; }
+        return reinterpret_cast<const T*>(take(count * sizeof(T)));
+    }
+
+    void pad() {
+        if (at % 8) take(8 - at % 8);
+    }
+
+    // offsets must start at 0 and never decrease; returns the total length
+    bool offsets(const uint64_t* offs, size_t n, uint64_t& total) {
+        if (!ok || offs[0] != 0) return false;
+        for (size_t i = 0; i < n; ++i) {
+            if (offs[i + 1] < offs[i]) return false;
+        }
+        total = offs[n];
+        return true;
+    }
+};
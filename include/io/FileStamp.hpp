@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+
+// Cheap change detection for caches built from files on disk.
+
+// size + mtime ("size@ticks"); "-" if the file is missing
+std::string file_stamp(const std::string& path);
+
+// one "name\tstamp\n" line per regular file directly in `dir`, in name order; editing,
+// adding or removing a file changes it ("" if the directory is missing)
+std::string dir_stamps(const std::string& dir);
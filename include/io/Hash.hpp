@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// FNV-1a (64-bit) for cache keys and fingerprints: cheap and stable across runs,
+// not meant to stand up to deliberately colliding inputs.
+
+constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+
+inline void fnv1a64(uint64_t& h, const void* p, size_t n) {
+    const unsigned char* b = (const unsigned char*)p;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= (uint64_t)b[i];
+        h *= 1099511628211ull;
+    }
+}
+
+// length-prefixed, so ("ab", "c") and ("a", "bc") hash differently
+inline void hash_str(uint64_t& h, const std::string& s) {
+    const uint64_t n = s.size();
+    fnv1a64(h, &n, sizeof(n));
+    fnv1a64(h, s.data(), s.size());
+}
+
+// 16 lowercase hex digits
+inline std::string hex_u64(uint64_t x) {
+    const char* hex = "0123456789abcdef";
+    std::string out(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        out[i] = hex[x & 0xF];
+        x >>= 4;
+    }
+    return out;
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Nearest-rank percentile (p in 0..100) of unsorted samples; 0 if there are none.
+inline double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t rank = (size_t)std::ceil(p / 100.0 * (double)v.size());
+    if (rank == 0) rank = 1;
+    return v[std::min(rank, v.size()) - 1];
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "io/MappedFile.hpp"
+#include "jobs/JobCorpus.hpp"
+#include "jobs/TokenSet.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Tokens as analyze sees them: sorted, unique, interned.
+std::vector<textutil::TokenId> body_token_ids(std::string_view raw);
+
+// Same, with "cpp" folded into "c++" (zones and the role query).
+std::vector<textutil::TokenId> zone_token_ids(std::string_view raw);
+
+// Role-independent features of one posting read by analyze's rescue/rerank.
+struct PostingFeatures {
+    std::string title;
+    std::vector<textutil::TokenId> title_toks;
+    std::vector<textutil::TokenId> lead_toks;
+    std::vector<textutil::TokenId> req_toks;
+};
+
+PostingFeatures compute_posting_features(const std::string& raw);
+
+// Persisted, memory-mapped corpus sidecar (written by `embed`): per-posting body
+// and zone token ids, titles and the global DF table, so analyze does not
+// re-tokenize or re-zone the corpus on every run.
+//
+// Token ids in the file are remapped into textutil::SymbolTable on load. When the
+// table is fresh (the usual case) the ids line up and the arrays are used in place.
+class CorpusIndex {
+public:
+    // sidecar next to the embeddings cache: jobs.bin -> jobs.corpus.bin
+    static std::string default_path(const std::string& emb_path);
+
+    static bool build_and_save(const JobCorpus& corpus, const std::string& jobs_dir, const std::string& path);
+
+    bool load(const std::string& path);
+
+    // true if this index was built from `jobs_dir` and no posting was added, removed
+    // or edited since
+    bool matches(const std::string& jobs_dir) const;
+
+    size_t size() const { return m_n; }
+    std::optional<size_t> find(std::string_view posting_id) const;
+
+    std::string_view id(size_t i) const { return str_at(m_ids, i); }
+    std::string_view title(size_t i) const { return str_at(m_titles, i); }
+
+    textutil::TokenSpan body(size_t i) const { return csr_at(m_body, i); }
+    textutil::TokenSpan title_toks(size_t i) const { return csr_at(m_title_toks, i); }
+    textutil::TokenSpan lead_toks(size_t i) const { return csr_at(m_lead_toks, i); }
+    textutil::TokenSpan req_toks(size_t i) const { return csr_at(m_req_toks, i); }
+
+    // document frequency indexed by global token id (ids past the end have df 0)
+    std::span<const uint32_t> df() const { return m_df; }
+
+    std::string_view jobs_dir() const { return m_jobs_dir; }
+
+private:
+    struct StrTab {
+        const uint64_t* offs = nullptr;
+        const char* bytes = nullptr;
+    };
+    struct Csr {
+        const uint64_t* offs = nullptr;
+        const uint32_t* ids = nullptr;
+        std::vector<uint32_t> owned; // remapped ids when the symbol table was not fresh
+    };
+
+    static std::string_view str_at(const StrTab& t, size_t i) {
+        return std::string_view(t.bytes + t.offs[i], (size_t)(t.offs[i + 1] - t.offs[i]));
+    }
+    static textutil::TokenSpan csr_at(const Csr& c, size_t i) {
+        return textutil::TokenSpan(c.ids + c.offs[i], (size_t)(c.offs[i + 1] - c.offs[i]));
+    }
+
+    MappedFile m_file;
+    size_t m_n = 0;
+    std::string_view m_jobs_dir;
+    std::string_view m_stamps;
+    StrTab m_ids;
+    StrTab m_titles;
+    const uint32_t* m_sorted = nullptr; // posting indexes ordered by id, for find()
+    std::span<const uint32_t> m_df;
+    std::vector<uint32_t> m_df_owned;
+    Csr m_body, m_title_toks, m_lead_toks, m_req_toks;
+};
@@ -14,6 +14,10 @@ public:
 
     std::vector<EmbHit> topk(const std::vector<float>& query_vec, size_t k) const;
 
+    // topk() for several queries (packed, dim floats each) in one pass over the index;
+    // out[q] is exactly what topk() returns for query q
+    std::vector<std::vector<EmbHit>> topk_batch(const std::vector<float>& queries, size_t k) const;
+
     // cache I/O (binary)
     bool save(const std::string& path) const;
     bool load(const std::string& path);
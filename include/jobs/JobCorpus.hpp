@@ -6,6 +6,7 @@
 class JobCorpus {
 public:
     static JobCorpus load_from_dir(const std::string& dir); // loads *.txt
+    static std::string read_posting(const std::string& dir, const std::string& id); // <dir>/<id>.txt
     const std::vector<JobPosting>& postings() const { return m_posts; }
 
 private:
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace textutil {
+
+// Aho-Corasick automaton over a fixed keyword set, ASCII case-insensitive.
+// Built once; scan() reports every occurrence (overlaps included) in one pass
+// over the raw bytes, without lowercasing a copy of the text first.
+//
+// Transitions are a dense DFA over byte classes (one class per distinct pattern
+// byte, plus "other"), so each input byte costs one table lookup.
+class KeywordScanner {
+public:
+    // patterns must be distinct and non-empty; matched ASCII case-insensitively
+    KeywordScanner(std::initializer_list<std::string_view> patterns);
+    explicit KeywordScanner(const std::vector<std::string>& patterns);
+
+    size_t size() const { return m_len.size(); }
+    size_t pattern_len(uint32_t p) const { return m_len[p]; }
+
+    // on_match(start_pos, pattern_index) for every occurrence, in order of end position
+    template <class F>
+    void scan(std::string_view text, F&& on_match) const {
+        uint32_t s = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            s = m_next[(size_t)s * m_classes + m_class[(unsigned char)text[i]]];
+            for (uint32_t k = m_out_begin[s]; k < m_out_begin[s + 1]; ++k) {
+                const uint32_t p = m_out[k];
+                on_match(i + 1 - m_len[p], p);
+            }
+        }
+    }
+
+    // index of the pattern equal to `text` (case-insensitive), or -1
+    int find_exact(std::string_view text) const;
+
+private:
+    void build(const std::vector<std::string>& patterns);
+
+    uint8_t m_class[256] = {};
+    uint32_t m_classes = 1;
+    std::vector<uint32_t> m_next;      // state * m_classes + class -> state
+    std::vector<uint32_t> m_depth;     // length of the prefix a state spells
+    std::vector<int> m_pattern;        // pattern ending exactly at a state, or -1
+    std::vector<uint32_t> m_out_begin; // CSR over m_out (own + suffix matches)
+    std::vector<uint32_t> m_out;
+    std::vector<uint32_t> m_len;
+};
+
+}
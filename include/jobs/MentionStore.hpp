@@ -0,0 +1,83 @@
+#pragma once
+#include "io/MappedFile.hpp"
+#include "jobs/Mentions.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Corpus-wide skill mentions written offline by `extract --store`, memory-mapped by
+// analyze so a profile is an aggregation over the selected postings instead of an
+// extraction pass on the request path.
+//
+// Columnar: one row per mention, rows grouped by posting (postings sorted by id).
+// String-valued columns hold ids into one shared string table.
+class MentionStore {
+public:
+    // sidecar next to the embeddings cache: jobs.bin -> jobs.mentions.bin
+    static std::string default_path(const std::string& emb_path);
+
+    // rows[i] are the mentions of posting_ids[i], in emission order
+    static bool save(const std::string& path,
+                     const std::string& source,
+                     const std::string& jobs_dir,
+                     const std::vector<std::string>& posting_ids,
+                     const std::vector<std::vector<Mention>>& rows);
+
+    bool load(const std::string& path);
+
+    // true if built from `jobs_dir` by the same extraction setup (see mention_source)
+    // and no posting was added, removed or edited since
+    bool matches(const std::string& jobs_dir, const std::string& source) const;
+
+    size_t size() const { return m_n; }
+    size_t rows() const { return m_rows; }
+    std::optional<size_t> find(std::string_view posting_id) const;
+
+    std::string_view id(size_t i) const { return str_at(m_ids, i); }
+    std::string_view source() const { return m_source; }
+
+    // posting i's mentions, materialized
+    std::vector<Mention> mentions(size_t i) const;
+
+    // same result as aggregate_mentions() over the postings' mentions concatenated
+    // in the given order
+    std::vector<SkillTotal> aggregate(const std::vector<size_t>& postings) const;
+
+private:
+    struct StrTab {
+        const uint64_t* offs = nullptr;
+        const char* bytes = nullptr;
+    };
+
+    static std::string_view str_at(const StrTab& t, size_t i) {
+        return std::string_view(t.bytes + t.offs[i], (size_t)(t.offs[i + 1] - t.offs[i]));
+    }
+    std::string str(uint32_t sid) const { return std::string(str_at(m_strings, sid)); }
+
+    MappedFile m_file;
+    size_t m_n = 0;
+    size_t m_rows = 0;
+    size_t m_n_strings = 0;
+    std::string_view m_source;
+    std::string_view m_jobs_dir;
+    std::string_view m_stamps;
+    StrTab m_strings;
+    StrTab m_ids;
+    const uint64_t* m_row_offs = nullptr; // posting i owns rows [offs[i], offs[i + 1])
+
+    // columns
+    const uint32_t* m_skill = nullptr;
+    const uint32_t* m_raw = nullptr;
+    const uint32_t* m_category = nullptr;
+    const uint32_t* m_strength = nullptr;
+    const uint32_t* m_polarity = nullptr;
+    const uint32_t* m_span_type = nullptr;
+    const double* m_confidence = nullptr;
+    const double* m_contrib = nullptr;
+    const uint8_t* m_best = nullptr;
+
+    uint32_t m_negated = UINT32_MAX; // string id of "negated", if present
+};
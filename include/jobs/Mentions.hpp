@@ -0,0 +1,63 @@
+#pragma once
+#include "jobs/RequirementExtractor.hpp"
+#include "llm/LLMClient.hpp"
+
+#include <string>
+#include <vector>
+
+// One skill mention in a posting (mentions.jsonl, the mention store, profile aggregation).
+struct Mention {
+    std::string posting_id;
+    std::string category;   // for non-LLM mode
+    std::string raw;
+    std::string canonical;
+    std::string strength;
+    std::string polarity;
+    std::string span_type;  // LLM evidence span type ("" for non-LLM)
+    double confidence = 0.0;
+    double contrib = 0.0;
+    bool best = false;      // counted for the profile: top contrib for its skill in this posting
+};
+
+std::string canonicalize_skill(const std::string& raw);
+
+double span_weight_from_category(const std::string& cat);
+double span_weight_from_span_type(const std::string& t);
+double strength_weight(const std::string& s);
+
+// A posting's mentions in emission order. `best` is set on the first mention with the
+// highest contrib for each canonical skill. Non-LLM items that canonicalize to "" are
+// kept (they still print) but never best; negated LLM evidence is dropped.
+std::vector<Mention> mentions_from_reqs(const std::string& posting_id, const ExtractedReqs& r);
+std::vector<Mention> mentions_from_evidence(const std::string& posting_id,
+                                            const std::vector<llm::EvidenceSpan>& evidence);
+
+// inverse of mentions_from_reqs, for printing
+ExtractedReqs reqs_from_mentions(const std::vector<Mention>& mentions);
+
+// Per-skill totals over `best` mentions, in first-seen order.
+struct SkillTotal {
+    std::string skill;
+    int count = 0;
+    double sum_contrib = 0.0;
+    std::vector<std::string> evidence; // first 3 raw strings
+};
+
+std::vector<SkillTotal> aggregate_mentions(const std::vector<Mention>& mentions);
+
+// The extraction setup behind a set of mentions (extract / analyze arguments).
+struct MentionSetup {
+    bool use_llm = false;
+    std::string llm_mock_dir;      // fixture dir or pack; else the real model below
+    std::string llm_model;
+    size_t llm_posting_tokens = 0; // real model only, like the batch/stream settings
+    size_t llm_batch = 1;
+    size_t llm_batch_tokens = 0;
+    bool llm_stream = true;
+    std::string skills_path;       // non-LLM only
+};
+
+// What produced a set of mentions ("regex[:<dict>#<hash>]", "llm:<model>#<settings>",
+// "llm_mock:<path>#<fixture stamps>"), so stored mentions are only reused for the same
+// extraction setup.
+std::string mention_source(const MentionSetup& s);
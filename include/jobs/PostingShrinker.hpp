@@ -0,0 +1,52 @@
+#pragma once
+#include "jobs/KeywordScanner.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Fits a posting into a token budget for an LLM prompt. The posting is cut into pieces
+// (lines; long lines into sentences) and each piece is ranked by its section: the
+// title first, then requirements/qualifications, then responsibilities and preferences, then plain
+// text, with boilerplate (benefits, EEO, about us) last. The best pieces that fit are
+// kept, in posting order. A posting that already fits is returned unchanged.
+//
+// Tokens come from a pluggable counter (analyze/extract use WordPieceTokenizer); without
+// one, ~4 chars per token is assumed.
+class PostingShrinker {
+public:
+    using TokenCounter = std::function<size_t(std::string_view)>;
+
+    explicit PostingShrinker(size_t token_budget = 512, TokenCounter count = {});
+
+    // Counts with the WordPiece vocab at vocab_path (the embedding model's): not the chat
+    // model's tokenizer, but close enough on English text to size prompts. If the vocab
+    // can't be loaded, falls back to the length estimate (has_counter() false).
+    static PostingShrinker with_vocab(const std::string& vocab_path, size_t token_budget);
+
+    std::string shrink(const std::string& raw) const;
+
+    size_t token_budget() const { return m_budget; }
+    size_t count_tokens(std::string_view s) const;
+    bool has_counter() const { return (bool)m_count; }
+
+private:
+    struct Piece {
+        size_t begin = 0;
+        size_t end = 0;
+        size_t line = 0;
+        int rank = 0;
+        size_t tokens = 0;
+    };
+
+    std::vector<Piece> split(const std::string& raw) const;
+    int heading_rank(std::string_view s, size_t& first) const;
+
+    size_t m_budget;
+    TokenCounter m_count;
+    std::vector<int8_t> m_rank; // per heading pattern
+    textutil::KeywordScanner m_headings;
+};
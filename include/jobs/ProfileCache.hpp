@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+// Everything analyze's profile.json / mentions.jsonl for one role depend on.
+struct ProfileKey {
+    std::string role;
+    std::string jobs_dir;
+    std::string emb_path;
+    size_t topk = 0;
+    double min_score = 0.0;
+    bool use_llm = false;
+    std::string llm_model;
+    std::string llm_mock_dir;
+    std::string skills_path;
+    size_t llm_posting_tokens = 0; // prompt budget per posting (real model only)
+    size_t llm_batch = 1;          // postings per request (real model only)
+    size_t llm_batch_tokens = 0;   // posting tokens per batched request (real model only)
+    bool llm_stream = true;        // streamed responses, cut off once complete (real model only)
+    bool llm_hybrid = false;       // extractor first, LLM only below llm_min_confidence
+    double llm_min_confidence = 0.0;
+    std::string llm_replay;        // recorded LLM calls served instead of a model
+};
+
+// Finished role profiles (profile.json + mentions.jsonl) keyed by a fingerprint of
+// their inputs, shared across output directories:
+//   <dir>/<fingerprint>/{profile.json, mentions.jsonl, key.txt}
+class ProfileCache {
+public:
+    // empty dir = disabled
+    explicit ProfileCache(std::string dir) : m_dir(std::move(dir)) {}
+
+    bool enabled() const { return !m_dir.empty(); }
+
+    // 16 hex digits over the key plus the current state of the files it names
+    // (posting names/sizes/mtimes, jobs.bin size/mtime, dictionary/mock contents)
+    static std::string fingerprint(const ProfileKey& key);
+
+    // copy a cached profile into outdir; false on a miss
+    bool restore(const std::string& fp, const std::filesystem::path& outdir) const;
+
+    // copy outdir's profile into the cache (atomic per entry)
+    bool store(const std::string& fp, const std::filesystem::path& outdir, const ProfileKey& key) const;
+
+private:
+    std::string m_dir;
+};
@@ -1,19 +1,75 @@
 #pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+namespace textutil { class KeywordScanner; }
+
 struct ExtractedReqs {
     // ordered categories for printing
     std::vector<std::pair<std::string, std::vector<std::string>>> by_category;
+
+    // how much of the posting the lexicon explained (see RequirementExtractor::confidence)
+    size_t section_lines = 0; // lines under requirement/preferred headings; 0 = none found
+    size_t covered_lines = 0; // of those, lines naming at least one known skill
+    size_t skills = 0;        // distinct known skills found
 };
 
+// Skill lexicon compiled into one token-boundary automaton (jobs/KeywordScanner):
+// a posting is scanned once per section regardless of how many skills are listed.
+// Safe to share across threads once built.
 class RequirementExtractor {
 public:
+    RequirementExtractor(); // built-in lexicon
+
     ExtractedReqs extract(const std::string& raw_text) const;
 
+    // 0..1: how far extract()'s result can be trusted without a closer (LLM) read.
+    // Mostly the share of requirement-section lines that named a known skill, plus a
+    // little for the number of skills found; a posting with no recognizable
+    // requirement section scores at most 0.6.
+    static double confidence(const ExtractedReqs& r);
+
+    // extract() over postings 0..n-1 on `threads` workers (0 = one per core).
+    // load(i) returns posting i's text and runs on a worker. on_result(i, reqs) runs on
+    // the calling thread strictly in index order, while later postings are still in
+    // flight; at most a small window of finished results is buffered. An exception from
+    // load/on_result stops the batch and is rethrown here.
+    void extract_batch(size_t n,
+                       const std::function<std::string(size_t)>& load,
+                       const std::function<void(size_t, ExtractedReqs&)>& on_result,
+                       size_t threads = 0) const;
+
+    // same, collecting results in input order
+    std::vector<ExtractedReqs> extract_batch(const std::vector<std::string>& texts, size_t threads = 0) const;
+
+    // Extend the lexicon from a tab-separated file, one skill per line:
+    //   category <TAB> canonical name <TAB> phrase [<TAB> alias ...]
+    // Blank lines and lines starting with '#' are skipped. Phrases are normalized like
+    // posting text. A known category or skill gains the new phrases (aliases); new
+    // categories print after the built-in ones, in first-seen order. Entries already
+    // in the lexicon are ignored. false (lexicon unchanged) on a missing/bad file.
+    bool load_dictionary(const std::string& path);
+
+    size_t dictionary_size() const { return m_entries.size(); }
+
 private:
-    static std::string to_lower_ascii(const std::string& s);
+    struct Entry {
+        uint32_t cat;
+        std::string canon;
+        std::string phrase; // normalized
+    };
+
+    void compile(std::vector<std::string> cats, std::vector<Entry> entries);
+
+    std::vector<std::string> m_cats;
+    std::vector<Entry> m_entries;                      // grouped by category, lexicon order
+    std::vector<std::vector<uint32_t>> m_phrase_entries; // matcher pattern -> entries
+    std::shared_ptr<const textutil::KeywordScanner> m_matcher;
+
     static std::string trim(const std::string& s);
     static std::vector<std::string> split_lines(const std::string& s);
 
@@ -23,6 +79,4 @@ private:
     };
 
     static SectionSlices slice_requirement_sections(const std::string& raw_text);
-
-    static bool contains_phrase(const std::string& normalized_haystack, const std::string& normalized_phrase);
 };
@@ -0,0 +1,63 @@
+#pragma once
+#include "jobs/TokenSet.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Header-first rerank weights: title dominates, embedding is only a tie-breaker.
+struct RerankWeights {
+    double title     = 200.0;
+    double lead      = 80.0;
+    double req       = 20.0;
+    double body_query = 4.0;  // query tokens anywhere in the body
+    double body_lex  = 1.0;   // seeded top tokens in the body
+    double emb       = 5.0;
+
+    // identity mismatch; only applied when the query asks for C++
+    double penalty_title_conflict   = 500.0; // "Java ..." title when query asks for C++
+    double penalty_missing_identity = 200.0;
+    double bonus_identity_in_title  = 120.0;
+};
+
+// Rerank candidates as columns (one entry per candidate). Inputs are pushed by the
+// caller; score() fills the outputs.
+struct RerankColumns {
+    // inputs
+    std::vector<textutil::TokenSpan> body, title, lead, req;
+    std::vector<uint8_t> has_title;
+    std::vector<float> emb_score;
+
+    // outputs
+    std::vector<double> s_title, s_lead, s_req, s_bodyq, base_lex;
+    std::vector<double> header;   // header-first score (everything but the embedding)
+    std::vector<double> combined; // header + weighted embedding
+    std::vector<uint8_t> identity_match, title_conflict, has_cpp;
+
+    size_t size() const { return body.size(); }
+    void clear();
+    void push(textutil::TokenSpan body_toks, textutil::TokenSpan title_toks, textutil::TokenSpan lead_toks,
+              textutil::TokenSpan req_toks, bool has_title_zone, float emb);
+};
+
+// Scores candidates for one query. Token membership (query, seeded top tokens, C++ and
+// competing-language ids) is folded into one flag byte per token id up front, so each
+// zone is a single branch-free pass of flag/IDF gathers.
+class RerankScorer {
+public:
+    // `idf` must cover every token id in the candidates; `top_tokens` are the seeded
+    // body-lex tokens (query tokens are always added)
+    RerankScorer(textutil::TokenSpan q_tokens, const std::vector<textutil::TokenId>& top_tokens,
+                 const std::vector<double>& idf, const RerankWeights& w);
+
+    bool wants_cpp() const { return m_wants_cpp; }
+
+    void score(RerankColumns& c) const;
+
+private:
+    enum : uint8_t { kQuery = 1, kTop = 2, kCpp = 4, kLang = 8 };
+
+    const std::vector<double>& m_idf;
+    RerankWeights m_w;
+    std::vector<uint8_t> m_flags; // per token id
+    bool m_wants_cpp = false;
+};
@@ -0,0 +1,109 @@
+#pragma once
+#include "jobs/CorpusIndex.hpp"
+#include "jobs/EmbeddingIndex.hpp"
+#include "jobs/JobCorpus.hpp"
+#include "jobs/Rerank.hpp"
+#include "jobs/TokenSet.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Knobs of analyze's two ranking stages: embedding retrieval (+ title/lead rescue)
+// and the header-first rerank.
+struct RetrievalConfig {
+    size_t topk        = 10;
+    size_t bigk_floor  = 80;   // embedding candidates: max(topk, bigk_floor)
+    double min_score   = 0.30; // below this a hit survives only on a title/lead match
+    size_t topn_seed   = 10;   // kept hits whose body tokens seed the lex set
+    size_t topx_tokens = 30;   // seeded lex tokens
+    RerankWeights weights;
+};
+
+struct RankedHit {
+    std::string job_id;
+
+    double emb_score = 0.0;
+    double lex_score = 0.0;      // still printed (now mostly header-driven)
+    double combined  = 0.0;      // now effectively "header-first"
+
+    // debug flags
+    bool has_cpp = false;
+    bool has_title = false;
+    bool title_conflict = false;
+    bool identity_match = false;
+
+    // debug scores
+    double s_title = 0.0;
+    double s_lead  = 0.0;
+    double s_req   = 0.0;
+};
+
+struct RetrievalResult {
+    size_t raw_hits = 0;            // embedding top-bigk
+    size_t kept = 0;                // after the min_score / rescue filter
+    std::vector<RankedHit> ranked;  // best first, at most topk
+
+    double retrieve_ms = 0.0;       // embedding top-bigk + filter
+    double rerank_ms = 0.0;         // seeding, scoring and the final sort
+};
+
+// Posting features the ranking stages read: the corpus sidecar written by `embed`
+// when it matches the jobs dir, otherwise the postings tokenized here (zones are
+// then computed on first use).
+class RetrievalCorpus {
+public:
+    struct ZoneToks {
+        std::string_view title;
+        textutil::TokenSpan title_toks, lead_toks, req_toks;
+    };
+
+    // false if the jobs dir is missing, or had to be read and holds no postings
+    bool load(const std::string& jobs_dir, const std::string& cindex_path);
+
+    bool uses_index() const { return m_use_cindex; }
+    size_t size() const { return m_n; }
+
+    std::optional<size_t> find(const std::string& job_id) const;
+    textutil::TokenSpan body(size_t pi) const;
+    ZoneToks zones(size_t pi) const;
+
+    // raw text; with the sidecar it is read from the jobs dir into `buf`
+    const std::string& text(size_t pi, std::string& buf) const;
+
+    double idf(textutil::TokenId tok) const;
+
+    // flat IDF table over every id interned so far
+    std::vector<double> idf_table() const;
+
+    // compute every zone up front; required before ranking from several threads
+    void warm_zones() const;
+
+private:
+    std::string m_jobs_dir;
+    bool m_use_cindex = false;
+    size_t m_n = 0;
+
+    CorpusIndex m_cindex;
+    JobCorpus m_corpus;
+
+    // posting id -> index into m_post_tokens (same order as m_corpus.postings())
+    std::unordered_map<std::string, size_t> m_post_index;
+    textutil::PostingTokenSets m_post_tokens;
+
+    // document frequency, indexed by global token id
+    std::vector<uint32_t> m_df_local;
+    std::span<const uint32_t> m_df;
+
+    mutable std::vector<std::optional<PostingFeatures>> m_zone_memo;
+};
+
+// Embedding retrieval + rerank for one query. `idf` must cover every token id of
+// the candidates' zones; nullptr builds one after the filter has computed them.
+RetrievalResult retrieve(const RetrievalCorpus& corpus, const EmbeddingIndex& idx,
+                         const std::vector<float>& query, textutil::TokenSpan q_tokens,
+                         const RetrievalConfig& cfg, const std::vector<double>* idf = nullptr);
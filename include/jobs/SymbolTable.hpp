@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace textutil {
+
+using TokenId = uint32_t;
+constexpr TokenId kNoToken = 0xFFFFFFFFu;
+
+// Process-wide interning of normalized tokens and skill strings into dense ids.
+// Ids are assigned in first-seen order and never change for the life of the process,
+// so callers can index flat arrays by id. Safe to share across threads.
+class SymbolTable {
+public:
+    static SymbolTable& global();
+
+    // returns the existing id or assigns the next one
+    TokenId intern(std::string_view s);
+
+    // kNoToken if `s` was never interned (does not grow the table)
+    TokenId find(std::string_view s) const;
+
+    // view stays valid for the life of the table
+    std::string_view str(TokenId id) const;
+
+    size_t size() const;
+
+private:
+    std::deque<std::string> m_storage;   // stable addresses for the views below
+    std::vector<std::string_view> m_by_id;
+    std::unordered_map<std::string_view, TokenId> m_ids;
+    mutable std::shared_mutex m_mu;
+};
+
+// shorthand for SymbolTable::global()
+inline TokenId intern(std::string_view s) { return SymbolTable::global().intern(s); }
+inline TokenId find_token(std::string_view s) { return SymbolTable::global().find(s); }
+inline std::string_view token_str(TokenId id) { return SymbolTable::global().str(id); }
+
+}
@@ -1,9 +1,14 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace textutil {
 
+// ASCII-only lowercasing ('A'..'Z'), vectorized where SSE2 is available
+std::string lower_ascii(std::string_view s);
+void lower_ascii_inplace(std::string& s);
+
 // lowercase, keep letters/digits/+/#, turn everything else into spaces, collapse spaces
 std::string normalize(const std::string& s);
 
@@ -13,4 +18,16 @@ std::vector<std::string> tokenize(const std::string& normalized);
 // synonym folding + phrase merging
 std::vector<std::string> normalize_tokens(const std::vector<std::string>& tokens);
 
-}
\ No newline at end of file
+// Output of scan_tokens: token views point into `arena` (or into static storage
+// for folded synonyms), so they stay valid until the buffer is scanned into again.
+struct TokenBuffer {
+    std::string arena;
+    std::vector<std::string_view> tokens;
+};
+
+// Fused normalize + tokenize (+ normalize_tokens when fold=true) in a single pass
+// over raw text. Produces exactly the same token sequence as the three-step path,
+// without allocating a string per token.
+void scan_tokens(std::string_view raw, TokenBuffer& out, bool fold = true);
+
+}
@@ -2,7 +2,6 @@
 #include "jobs/JobCorpus.hpp"
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <cstdint>
 
 
@@ -27,11 +26,9 @@ private:
         double norm = 0.0;
     };
 
-    // vocab
-    std::vector<std::string> m_terms;             // term_id -> term
+    // vocab: term_id is the global textutil::SymbolTable id; df == 0 => not in this corpus
     std::vector<uint32_t> m_df;                   // term_id -> document frequency
     std::vector<double> m_idf;                    // term_id -> idf
-    std::unordered_map<std::string, uint32_t> m_term_to_id;
 
     std::vector<PostingVec> m_postings;
 
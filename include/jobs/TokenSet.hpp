@@ -0,0 +1,56 @@
+#pragma once
+#include "jobs/SymbolTable.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace textutil {
+
+// Sorted, de-duplicated token ids. Membership is a binary search; overlap with a
+// TokenBitset is one linear pass of bit tests (no hashing).
+using TokenSpan = std::span<const TokenId>;
+
+void sort_unique(std::vector<TokenId>& ids);
+bool contains(TokenSpan sorted, TokenId id);
+
+// Dense bitmap over the token id space, grown to the highest id set.
+// Meant for the small probe side (query tokens, seeded top tokens).
+class TokenBitset {
+public:
+    void set(TokenId id);
+
+    bool test(TokenId id) const {
+        const size_t w = id >> 6;
+        return w < m_words.size() && ((m_words[w] >> (id & 63)) & 1u);
+    }
+
+private:
+    std::vector<uint64_t> m_words;
+};
+
+bool intersects(TokenSpan toks, const TokenBitset& probe);
+
+// sum of weights[id] over ids in both `toks` and `probe`.
+// Every id set in `probe` must be < weights.size().
+double weighted_overlap(TokenSpan toks, const TokenBitset& probe, const std::vector<double>& weights);
+
+// Per-posting token sets in one flat CSR array: 4 bytes per (posting, distinct token).
+class PostingTokenSets {
+public:
+    void reserve(size_t postings, size_t total_ids);
+
+    // sorts + de-dupes `ids`; returns the posting's index
+    size_t add(std::vector<TokenId> ids);
+
+    TokenSpan at(size_t i) const {
+        return TokenSpan(m_ids.data() + m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+    }
+
+    size_t size() const { return m_offsets.size() - 1; }
+
+private:
+    std::vector<TokenId> m_ids;
+    std::vector<size_t> m_offsets{0};
+};
+
+}
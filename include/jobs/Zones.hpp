@@ -0,0 +1,36 @@
+#pragma once
+#include "jobs/KeywordScanner.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Role-independent zones of a posting used by analyze's rescue/rerank.
+struct Zones {
+    std::string title;
+    std::string lead;
+    std::string req;
+};
+
+Zones extract_zones(const std::string& raw);
+
+// up to two requirement-ish blocks (heading -> next stop heading), capped at 6000 chars
+std::string extract_requirements_block(const std::string& raw);
+
+// Start/stop heading keywords compiled into one case-insensitive automaton, so all
+// of them are located in a single pass over the posting.
+class HeadingBlocks {
+public:
+    HeadingBlocks(std::initializer_list<std::string_view> starts, std::initializer_list<std::string_view> stops);
+
+    // Up to `max_blocks` slices, each from a start keyword to the next stop keyword after
+    // it (at most `block_cap` bytes), joined by blank lines. Each search resumes where the
+    // previous block ended.
+    std::string blocks(const std::string& raw, int max_blocks, size_t block_cap) const;
+
+private:
+    std::vector<uint8_t> m_kind; // per pattern: 1 = start, 2 = stop
+    textutil::KeywordScanner m_scanner;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace llm {
+
+// 128-bit content hash (MurmurHash3 x64/128)
+struct CacheKey {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+    bool operator==(const CacheKey& o) const { return hi == o.hi && lo == o.lo; }
+};
+
+CacheKey cache_hash(std::string_view data);
+
+std::string to_hex(const CacheKey& k);
+
+// Append-only key/value log in one file, for LLM responses:
+//   "RLLMKV01" then records of [magic, value length, 128-bit key, checksum] + value.
+// The index (key -> newest record) is built by one scan on open and extended when a
+// lookup misses, so records appended by other processes are picked up. Appends are
+// single writes under an exclusive file lock; a torn record left by a crash is
+// skipped (the scan resyncs on the next valid record). Thread-safe.
+class CacheLog {
+public:
+    struct Stats {
+        size_t records = 0;    // valid records in the file
+        size_t keys = 0;       // distinct keys
+        uint64_t bytes = 0;    // file size
+        uint64_t live_bytes = 0;
+    };
+
+    CacheLog() = default;
+    ~CacheLog();
+
+    CacheLog(const CacheLog&) = delete;
+    CacheLog& operator=(const CacheLog&) = delete;
+
+    // creates the file (and nothing else) if missing
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const;
+
+    bool get(const CacheKey& key, std::string& value);
+    bool put(const CacheKey& key, std::string_view value);
+
+    Stats stats();
+
+    // Rewrite `path` keeping only the newest record per key, then swap it in. Runs
+    // under the file lock; other processes notice the swap on their next write or miss.
+    static bool compact(const std::string& path, Stats* before, Stats* after, std::string* error);
+
+private:
+    struct Entry {
+        uint64_t offset = 0; // of the value
+        uint32_t length = 0;
+    };
+    struct KeyHash {
+        size_t operator()(const CacheKey& k) const { return (size_t)(k.lo ^ (k.hi * 0x9e3779b97f4a7c15ull)); }
+    };
+
+    bool reopen_locked();
+    bool replaced_locked() const; // the path now names a different file (compaction)
+    void scan_locked();           // index records from scanned_ to EOF
+
+    std::mutex mu_;
+    std::string path_;
+    std::intptr_t fd_ = -1;
+    uint64_t scanned_ = 0;
+    size_t records_ = 0;
+    std::unordered_map<CacheKey, Entry, KeyHash> index_;
+};
+
+} // namespace llm
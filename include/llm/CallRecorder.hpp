@@ -0,0 +1,130 @@
+#pragma once
+
+#include "llm/LLMClient.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llm {
+
+// One posting's part of a recorded request (a batch records one per posting, all
+// sharing the request's number and timings).
+struct CallRecord {
+    uint32_t request = 0;      // request number, in send order
+    uint32_t batch = 1;        // postings in that request
+    double start_ms = 0.0;     // since the recorder was created
+    double wall_ms = 0.0;
+    double ttfb_ms = -1.0;     // first response byte; < 0 = nothing was sent (cache hit, mock)
+    CacheKey key;              // the client's response cache key (else a hash of id + text)
+    uint32_t prompt_tokens = 0;
+    bool cache_hit = false;
+    std::string posting_id;
+    std::string evidence_json; // {"evidence":[...]}
+};
+
+// Latency summary over the requests that reached the model (cache hits excluded);
+// percentiles are nearest-rank, in ms.
+struct LatencyReport {
+    size_t requests = 0;
+    size_t postings = 0;
+    size_t cache_hits = 0;
+    double p50 = 0.0, p95 = 0.0, p99 = 0.0;
+    double ttfb_p50 = 0.0;
+};
+
+// Wraps another client and records every analyze_posting / analyze_batch call: cache
+// key, prompt tokens, wall time, time to first byte and whether it was a cache hit.
+// Records are kept for latency_report() and, with open_log(), appended to a compact
+// binary log that ReplayLLMClient plays back. Safe to call concurrently if the
+// wrapped client is.
+//
+// Log: "RLLMREC1", then per record u32 payload length + payload:
+//   u32 request, u32 batch, f64 start_ms, f64 wall_ms, f64 ttfb_ms, u64 key hi, u64 key lo,
+//   u32 prompt_tokens, u8 cache_hit, u32 id length, id, u32 evidence length, evidence JSON
+class RecordingLLMClient final : public LLMClient {
+public:
+    explicit RecordingLLMClient(LLMClient& inner);
+
+    // truncates `path`; false if it cannot be written
+    bool open_log(const std::string& path);
+
+    std::vector<EvidenceSpan> analyze_posting(const std::string& posting_id,
+                                             const std::string& posting_text) override;
+
+    BatchLimits batch_limits() const override { return inner_.batch_limits(); }
+    size_t batch_cost(const std::string& posting_id, const std::string& posting_text) override {
+        return inner_.batch_cost(posting_id, posting_text);
+    }
+    std::vector<std::vector<EvidenceSpan>> analyze_batch(const std::vector<std::string>& posting_ids,
+                                                         const std::vector<std::string>& posting_texts) override;
+
+    size_t failed_requests() const override { return inner_.failed_requests(); }
+
+    std::vector<Span> segment(const std::string& posting_text) override { return inner_.segment(posting_text); }
+    EvidenceSpan extract(const Span& span) override { return inner_.extract(span); }
+
+    LatencyReport latency_report() const;
+
+private:
+    void record(const std::vector<std::string>& ids, const std::vector<std::string>& texts,
+                const std::vector<std::vector<EvidenceSpan>>& results, const CallTrace& trace,
+                std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1);
+
+    LLMClient& inner_;
+    std::chrono::steady_clock::time_point epoch_;
+
+    mutable std::mutex mu_;
+    uint32_t next_request_ = 0;
+    std::vector<CallRecord> records_;
+    std::ofstream log_;
+};
+
+// Plays a RecordingLLMClient log back: each posting gets its recorded evidence after
+// its recorded wall time divided by `speed` (0 = no waiting). Postings recorded in one
+// batch request are served in batches of the recording's largest size, waiting once
+// per batch. Postings missing from the log get no evidence, at once. Thread-safe.
+class ReplayLLMClient final : public LLMClient {
+public:
+    explicit ReplayLLMClient(double speed = 1.0) : speed_(speed) {}
+
+    // false (see last_error()) if the log is missing or damaged
+    bool load(const std::string& path);
+    const std::string& last_error() const { return error_; }
+
+    size_t size() const { return by_id_.size(); }
+
+    std::vector<EvidenceSpan> analyze_posting(const std::string& posting_id,
+                                             const std::string& posting_text) override;
+
+    BatchLimits batch_limits() const override { return BatchLimits{max_batch_, SIZE_MAX}; }
+    std::vector<std::vector<EvidenceSpan>> analyze_batch(const std::vector<std::string>& posting_ids,
+                                                         const std::vector<std::string>& posting_texts) override;
+
+    std::vector<Span> segment(const std::string&) override { return {}; }
+    EvidenceSpan extract(const Span&) override { return EvidenceSpan{}; }
+
+private:
+    struct Entry {
+        double wall_ms = 0.0;
+        double ttfb_ms = -1.0;
+        CacheKey key;
+        uint32_t prompt_tokens = 0;
+        bool cache_hit = false;
+        std::vector<EvidenceSpan> evidence;
+    };
+
+    // wait out the slowest of `entries` (scaled), reporting them to the active trace
+    void replay(const std::vector<const Entry*>& entries, const std::vector<std::string>& ids) const;
+
+    double speed_ = 1.0;
+    size_t max_batch_ = 1;
+    std::string error_;
+    std::unordered_map<std::string, Entry> by_id_; // newest record per posting
+};
+
+} // namespace llm
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace llm {
+
+struct HttpOptions {
+    int connect_timeout_ms = 2000;
+    int read_timeout_ms = 300000; // longest silence while waiting for a response (generation is slow)
+    bool keep_alive = true;
+};
+
+struct HttpResponse {
+    int status = 0;
+    std::string body;
+    bool stopped = false; // a body sink ended the read early (the connection was dropped)
+};
+
+// receives the body as it arrives (chunk framing removed); return false to stop reading
+using HttpBodySink = std::function<bool(const char* data, size_t n)>;
+
+// Minimal blocking HTTP/1.1 client for one plain-HTTP host (the local Ollama server).
+// Keeps one TCP connection open across requests; handles Content-Length, chunked and
+// read-to-close bodies. Not thread-safe: use one client per thread.
+class HttpClient {
+public:
+    HttpClient(std::string host, uint16_t port, HttpOptions opts = {});
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    // false on connect / send / read failure or timeout (see last_error()); any HTTP
+    // status counts as success. A reused connection the server already closed is
+    // retried once on a fresh one.
+    bool post(const std::string& path, const std::string& content_type, const std::string& body, HttpResponse& out);
+    bool get(const std::string& path, HttpResponse& out);
+
+    // like post(), but the body goes to `sink` instead of out.body. When the sink
+    // returns false the connection is closed, which is how a streaming server is told
+    // to stop; out.stopped is set and the call still succeeds.
+    bool post_stream(const std::string& path, const std::string& content_type, const std::string& body,
+                     const HttpBodySink& sink, HttpResponse& out);
+
+    void close();
+
+    const std::string& last_error() const { return last_error_; }
+
+    // TCP connections opened so far (1 after any number of keep-alive requests)
+    size_t connects() const { return connects_; }
+
+private:
+    bool request(const std::string& method, const std::string& path, const std::string& content_type,
+                 const std::string& body, const HttpBodySink* sink, HttpResponse& out);
+    bool exchange(const std::string& head, const std::string& body, const HttpBodySink* sink, HttpResponse& out,
+                  bool& reusable, bool& stale);
+
+    bool open_connection();
+    bool send_all(const char* p, size_t n);
+    int recv_some();                     // >0 bytes appended to buf_, 0 = peer closed, <0 = error/timeout
+    bool fill_until(const char* delim);  // read until buf_ holds delim
+    bool fill_to(size_t n);              // read until buf_ holds n bytes
+
+    std::string host_;
+    uint16_t port_ = 0;
+    HttpOptions opts_;
+
+    std::intptr_t sock_ = -1;
+    std::string buf_; // bytes received but not yet consumed
+    std::string last_error_;
+    size_t connects_ = 0;
+};
+
+// "host:port", "http://host:port/" or "host" (default_port) -> parts; false if unparsable.
+// IPv6 hosts take brackets when a port follows ("[::1]:11434"); the brackets are dropped.
+bool parse_http_endpoint(const std::string& s, uint16_t default_port, std::string& host, uint16_t& port);
+
+} // namespace llm
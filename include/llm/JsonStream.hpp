@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace llm {
+
+// Incremental scanner for one JSON object arriving in pieces (a model response
+// streamed token by token). Tracks only nesting and strings, so it can say when the
+// object is complete without parsing it; the values are parsed from text() afterwards.
+// Anything before the first '{' is skipped.
+class JsonStream {
+public:
+    // max_items > 0: also finish once that many objects/arrays have closed inside an
+    // array that is a direct member of the top-level object (e.g. {"evidence":[...]})
+    explicit JsonStream(size_t max_items = 0) : max_items_(max_items) {}
+
+    // true once the object is complete; later pieces are ignored
+    bool feed(std::string_view piece);
+
+    bool done() const { return done_; }
+    bool truncated() const { return truncated_; } // finished at the item limit
+    size_t items() const { return items_; }
+
+    // the object so far; after the item limit, with its open containers closed
+    const std::string& text() const { return text_; }
+
+private:
+    size_t max_items_ = 0;
+    std::string text_;
+    std::string open_; // closers of the containers still open, innermost last
+    bool started_ = false;
+    bool in_string_ = false;
+    bool escaped_ = false;
+    bool done_ = false;
+    bool truncated_ = false;
+    size_t items_ = 0;
+};
+
+} // namespace llm
@@ -1,5 +1,12 @@
 #pragma once
+#include "llm/CacheLog.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace llm {
@@ -23,6 +30,35 @@ struct EvidenceSpan {
     std::vector<SkillHit> skills;
 };
 
+// What a client knows about one analyze_posting / analyze_batch call beyond its result.
+// A tracing wrapper (RecordingLLMClient) installs one on the calling thread with
+// ScopedTrace; clients fill in what they can while it is active.
+struct CallTrace {
+    struct Posting {
+        CacheKey key;
+        bool cache_hit = false;
+    };
+    std::unordered_map<std::string, Posting> postings; // by posting id
+    size_t prompt_tokens = 0;                          // sent to the model during the call
+    bool got_first_byte = false;
+    std::chrono::steady_clock::time_point first_byte;  // of the first model response
+};
+
+// the trace installed on this thread, or nullptr
+CallTrace* active_trace();
+
+class ScopedTrace {
+public:
+    explicit ScopedTrace(CallTrace* t);
+    ~ScopedTrace();
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+private:
+    CallTrace* prev_;
+};
+
 class LLMClient {
 public:
     virtual ~LLMClient() = default;
@@ -31,11 +67,53 @@ public:
     virtual std::vector<EvidenceSpan> analyze_posting(const std::string& posting_id,
                                                      const std::string& posting_text) = 0;
 
+    // analyze_posting on its own thread. Clients whose analyze_posting is safe to call
+    // concurrently get this for free; per-request timeouts are the client's own.
+    virtual std::future<std::vector<EvidenceSpan>> analyze_posting_async(std::string posting_id,
+                                                                        std::string posting_text) {
+        return std::async(std::launch::async, [this, id = std::move(posting_id), text = std::move(posting_text)] {
+            return analyze_posting(id, text);
+        });
+    }
+
+    // Batching (optional): analyze_postings packs consecutive postings into one
+    // analyze_batch call while the batch has at most max_postings postings and the sum of
+    // their batch_cost() stays within budget. The default limits send each posting alone.
+    struct BatchLimits {
+        size_t max_postings = 1;
+        size_t budget = 0;
+    };
+    virtual BatchLimits batch_limits() const { return {}; }
+    virtual size_t batch_cost(const std::string& /*posting_id*/, const std::string& /*posting_text*/) { return 0; }
+
+    // one evidence list per posting, in order; called off the calling thread
+    virtual std::vector<std::vector<EvidenceSpan>> analyze_batch(const std::vector<std::string>& posting_ids,
+                                                                 const std::vector<std::string>& posting_texts) {
+        std::vector<std::vector<EvidenceSpan>> out;
+        for (size_t i = 0; i < posting_ids.size(); ++i) out.push_back(analyze_posting(posting_ids[i], posting_texts[i]));
+        return out;
+    }
+
+    // requests so far that failed or timed out, so their postings got no evidence;
+    // results from a run with failures are incomplete and should not be saved as final
+    virtual size_t failed_requests() const { return 0; }
+
     // Legacy (kept for compatibility / mock tooling; analyze.cpp won't use these anymore)
     virtual std::vector<Span> segment(const std::string& posting_text) = 0;
     virtual EvidenceSpan extract(const Span& span) = 0;
 };
 
+// analyze_posting_async over every id in `ids` with at most `window` requests in flight
+// (0 or 1 = one at a time); postings are grouped into analyze_batch calls as the
+// client's batch_limits() allow, a batch counting as one request. load(i) returns posting i's text and on_result(i, evidence)
+// runs for each posting; both run on the calling thread, on_result strictly in index
+// order, so callers merge results deterministically. A request that fails or times out
+// yields no evidence. An exception from load/on_result/the client is rethrown here
+// after the requests already in flight have finished.
+void analyze_postings(LLMClient& client, const std::vector<std::string>& ids, size_t window,
+                      const std::function<std::string(size_t)>& load,
+                      const std::function<void(size_t, std::vector<EvidenceSpan>&)>& on_result);
+
 class NullLLMClient final : public LLMClient {
 public:
     std::vector<EvidenceSpan> analyze_posting(const std::string&, const std::string&) override { return {}; }
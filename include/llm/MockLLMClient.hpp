@@ -2,17 +2,39 @@
 
 #include "llm/LLMClient.hpp"
 
+#include <cstdint>
 #include <filesystem>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace llm {
 
+// Canned responses for offline runs and load tests: <posting_id>.json files (the
+// {"evidence":[...]} shape the model returns) in a directory, or one pack of them
+// written by write_pack(). Everything is loaded once, on first use, into a columnar
+// in-memory table, so analyze_posting does no I/O. An optional synthetic latency
+// stands in for the model. Unknown posting ids get no evidence. Thread-safe.
 class MockLLMClient final : public LLMClient {
-    std::filesystem::path root_;
-
 public:
+    // root: a fixture directory or a pack file
     explicit MockLLMClient(const std::string& root_dir);
 
+    // load now instead of on first use; false (see last_error()) if root is missing,
+    // unreadable or a damaged pack. Later calls return the first result.
+    bool load();
+    const std::string& last_error() const { return error_; }
+
+    size_t size() const { return n_; } // postings with fixtures, once loaded
+
+    // every analyze_posting sleeps base_ms plus a share of jitter_ms fixed by the
+    // posting id, so a replay takes the same time each run
+    void set_latency(double base_ms, double jitter_ms = 0.0);
+
+    // every <posting_id>.json in `dir` -> one pack file at `path`
+    static bool write_pack(const std::string& dir, const std::string& path, size_t* postings, std::string* error);
+
     // Day 3 (B)
     std::vector<EvidenceSpan> analyze_posting(const std::string& posting_id,
                                              const std::string& posting_text) override;
@@ -25,7 +47,43 @@ public:
     std::vector<EvidenceSpan> evidence_for_posting_id(const std::string& posting_id);
 
 private:
-    std::vector<EvidenceSpan> load_file_for_posting_id(const std::string& posting_id);
+    struct StrTab {
+        const uint64_t* offs = nullptr;
+        const char* bytes = nullptr;
+    };
+
+    static std::string_view str_at(const StrTab& t, size_t i) {
+        return std::string_view(t.bytes + t.offs[i], (size_t)(t.offs[i + 1] - t.offs[i]));
+    }
+    std::string str(uint32_t sid) const { return std::string(str_at(strings_, sid)); }
+
+    bool load_once();
+    bool parse(); // data_ -> the columns below
+    std::optional<size_t> find(std::string_view posting_id) const;
+    std::vector<EvidenceSpan> evidence(size_t i) const;
+    void wait(const std::string& posting_id) const;
+
+    std::filesystem::path root_;
+    std::once_flag once_;
+    bool loaded_ = false;
+    std::string error_;
+
+    double latency_ms_ = 0.0;
+    double jitter_ms_ = 0.0;
+
+    std::string data_; // the pack bytes; everything below points into it
+    size_t n_ = 0;
+    StrTab strings_;
+    StrTab ids_;                          // sorted
+    const uint64_t* span_offs_ = nullptr; // posting i owns spans [offs[i], offs[i + 1])
+    const uint32_t* span_type_ = nullptr;
+    const uint32_t* span_text_ = nullptr;
+    const uint32_t* polarity_ = nullptr;
+    const uint32_t* strength_ = nullptr;
+    const uint64_t* skill_offs_ = nullptr; // span s owns skills [offs[s], offs[s + 1])
+    const uint32_t* raw_ = nullptr;
+    const uint32_t* canonical_ = nullptr;
+    const double* confidence_ = nullptr;
 };
 
 } // namespace llm
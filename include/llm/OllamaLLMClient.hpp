@@ -1,37 +1,94 @@
 #pragma once
 
+#include "llm/CacheLog.hpp"
+#include "llm/HttpClient.hpp"
 #include "llm/LLMClient.hpp"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace llm {
 
+// Talks to the local Ollama server (OLLAMA_HOST, default 127.0.0.1:11434) over
+// keep-alive HTTP connections. Safe to call concurrently: each request borrows an
+// idle connection or opens one; read_timeout_ms bounds each request. Responses are
+// streamed (unless stream=false) and cut off once the JSON object is complete, and
+// cached in one append-only log, <cache_dir>/llm_cache.kv (see CacheLog).
 class OllamaLLMClient final : public LLMClient {
     std::string model_;
     std::filesystem::path cache_dir_;
+    mutable CacheLog cache_;
+
+    std::string host_;
+    uint16_t port_ = 11434;
+    HttpOptions http_opts_;
+    bool stream_ = true;
+    size_t batch_postings_ = 1;
+    size_t batch_tokens_ = 0;
+    size_t num_ctx_ = 0; // fixed once batching is on, so Ollama never reloads the model for a new context size
+    mutable std::atomic<size_t> requests_{0};
+    mutable std::atomic<size_t> prompt_tokens_{0};
+    mutable std::atomic<size_t> failures_{0};
+    mutable std::mutex pool_mu_;
+    mutable std::vector<std::unique_ptr<HttpClient>> idle_;
 
 public:
-    OllamaLLMClient(const std::string& model, const std::string& cache_dir);
+    // the one-call prompt asks for at most this many evidence items; a streamed response
+    // is cut off after them and any longer answer is read only that far
+    static constexpr size_t kMaxEvidenceItems = 10;
+
+    OllamaLLMClient(const std::string& model, const std::string& cache_dir, const HttpOptions& http = {},
+                    bool stream = true);
+
+    // Pack up to max_postings uncached postings, prompt_tokens of posting text in all,
+    // into one request (max_postings <= 1: one posting per request). Each posting's
+    // evidence is cached under the same key a single-posting request would use.
+    void set_batching(size_t max_postings, size_t prompt_tokens);
 
     std::vector<EvidenceSpan> analyze_posting(const std::string& posting_id,
                                              const std::string& posting_text) override;
 
+    BatchLimits batch_limits() const override;
+    size_t batch_cost(const std::string& posting_id, const std::string& posting_text) override;
+    std::vector<std::vector<EvidenceSpan>> analyze_batch(const std::vector<std::string>& posting_ids,
+                                                         const std::vector<std::string>& posting_texts) override;
+
+    // requests sent to the model so far and their prompt size (estimated at ~4 chars/token)
+    size_t requests() const { return requests_; }
+    size_t prompt_tokens() const { return prompt_tokens_; }
+
+    // transport errors, timeouts, non-200 replies and unreadable bodies
+    size_t failed_requests() const override { return failures_; }
+
     std::vector<Span> segment(const std::string& posting_text) override;
     EvidenceSpan extract(const Span& span) override;
 
+    // the response log inside a cache dir
+    static std::filesystem::path cache_file(const std::filesystem::path& cache_dir);
+
 private:
     std::string prompt_analyzer_onecall(const std::string& posting_text) const;
+    std::string prompt_analyzer_batch(const std::vector<std::string>& posting_texts) const;
 
     std::string prompt_segmenter(const std::string& posting_text) const;
     std::string prompt_extractor(const Span& span) const;
 
-    std::string run_ollama_json(const std::string& prompt) const;
+    // the model's JSON text; max_items: see JsonStream (streaming only)
+    std::string run_ollama_json(const std::string& prompt, size_t max_items = 0, size_t num_predict = 3072) const;
+
+    // cached analyze_posting result for posting_id + "\n" + posting_text
+    bool cached_analysis(const std::string& input, std::vector<EvidenceSpan>& out) const;
 
-    std::string cache_key(const std::string& task, const std::string& input) const;
-    bool load_cache(const std::string& key, std::string& out) const;
-    void save_cache(const std::string& key, const std::string& content) const;
+    CacheKey cache_key(const std::string& task, const std::string& input) const;
+    std::string legacy_cache_name(const std::string& task, const std::string& input) const;
+    bool load_cache(const std::string& task, const std::string& input, std::string& out) const;
+    void save_cache(const std::string& task, const std::string& input, const std::string& content) const;
 
     std::vector<Span> parse_spans_json(const std::string& s) const;
     EvidenceSpan parse_evidence_json(const std::string& s) const;
@@ -1,10 +1,38 @@
 #pragma once
+#include <cstddef>
+#include <future>
 #include <string>
+#include <vector>
 
 namespace procutil {
 
-// Runs a command line and returns captured stdout+stderr (merged).
-// Returns "" on failure.
-std::string run_capture_stdout(const std::string& cmdline_utf8);
+struct RunOptions {
+    int timeout_ms = 0;              // 0 = no limit; on expiry the process (and its group) is killed
+    size_t max_output = 64u << 20;   // bytes kept per stream; the rest is read and dropped
+    bool merge_stderr = false;       // stderr goes to out, as on a terminal
+};
+
+struct RunResult {
+    bool started = false;
+    bool timed_out = false;
+    bool truncated = false;  // a stream passed max_output
+    int exit_code = -1;      // -1 unless the process exited normally
+    int term_signal = 0;     // POSIX: the signal that ended it, if any
+    std::string out;
+    std::string err;
+    std::string error;       // why it did not start
+};
+
+// Runs argv[0] (looked up on PATH) with stdin from the null device, capturing stdout
+// and stderr separately until both close and the process exits, or the timeout
+// expires. Output buffers grow as needed; neither pipe can fill up and stall the child.
+RunResult run(const std::vector<std::string>& argv, const RunOptions& opts = {});
+
+// run() on its own thread, so several processes can run side by side
+std::future<RunResult> run_async(std::vector<std::string> argv, RunOptions opts = {});
+
+// Runs a command line through the platform shell (/bin/sh -c; cmd.exe /S /C on Windows)
+// and returns captured stdout+stderr (merged). Returns "" on failure or timeout.
+std::string run_capture_stdout(const std::string& cmdline_utf8, int timeout_ms = 300000);
 
 } // namespace procutil
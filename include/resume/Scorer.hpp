@@ -1,11 +1,11 @@
 #pragma once
 
-#include <map>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "jobs/SymbolTable.hpp"
 #include "resume/Models.hpp"
 
 namespace resume {
@@ -13,7 +13,8 @@ namespace resume {
 struct RoleProfileLite {
     std::string role;
     std::vector<std::string> core_skills;
-    std::map<std::string, double> skill_weights;
+    // keyed by interned skill id (textutil::SymbolTable::global())
+    std::unordered_map<textutil::TokenId, double> skill_weights;
 };
 
 enum class MatchType {
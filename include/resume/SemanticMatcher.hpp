@@ -1,12 +1,13 @@
 #pragma once
 
-#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "emb/MiniLmEmbedder.hpp"
 #include "jobs/EmbeddingIndex.hpp"
+#include "jobs/SymbolTable.hpp"
 
 namespace resume {
 
@@ -20,18 +21,34 @@ struct SemanticMatcherConfig {
     float threshold = 0.66f; // accept match if similarity >= threshold
     size_t topk = 1;         // query topk; we use best hit (index 0)
     std::string cache_path;  // optional: load/save profile skill index
+
+    // what the vectors are embedded with; fingerprinted into the cache so a cache
+    // from another model or vocab is never used
+    std::string model_path;
+    std::string vocab_path;
+};
+
+struct SemanticIndexStats {
+    size_t skills = 0;          // profile skills in the index
+    size_t reused = 0;          // vectors taken from the cache
+    size_t embedded = 0;        // vectors computed this run
+    bool cache_written = false;
 };
 
 class SemanticMatcher {
 public:
     virtual ~SemanticMatcher() = default;
     virtual SemanticHit best_match(const std::string& text) const = 0;
+
+    // best_match() for each text, in order; the default just loops
+    virtual std::vector<SemanticHit> best_matches(const std::vector<std::string>& texts) const;
 };
 
 std::unique_ptr<SemanticMatcher> build_profile_semantic_matcher(
-    const std::map<std::string, double>& profile_skill_weights,
+    const std::unordered_map<textutil::TokenId, double>& profile_skill_weights,
     const MiniLmEmbedder& embedder,
-    const SemanticMatcherConfig& cfg
+    const SemanticMatcherConfig& cfg,
+    SemanticIndexStats* stats = nullptr
 );
 
 }  // namespace resume
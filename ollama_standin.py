@@ -0,0 +1,91 @@
+import argparse
+import json
+import socket
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+# Local stand-in for the Ollama server, for resume-agent check http (no model needed).
+#
+#   python ollama_standin.py [--bind 127.0.0.1] [--port 11435]
+#   resume-agent check http --host 127.0.0.1:11435
+#
+# GET  /api/version   small JSON (Content-Length, keep-alive); echoes the Host header
+# POST /api/generate  canned answer; "stream": true sends NDJSON lines chunked, like Ollama
+# GET  /drop          answers, then closes the connection without saying so
+# GET  /slow?ms=N     waits N ms before answering
+
+ANSWER = ['{"skills": [', '"c++", ', '"linux", ', '"networking"', ']}']
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'  # keep-alive unless told otherwise
+
+    def log_message(self, fmt, *args):
+        pass
+
+    def send_json(self, obj):
+        body = json.dumps(obj).encode('utf-8')
+        self.send_response(200)
+        self.send_header('Content-Type', 'application/json')
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        url = urlparse(self.path)
+        if url.path == '/api/version':
+            self.send_json({'version': 'standin', 'host': self.headers.get('Host', '')})
+        elif url.path == '/drop':
+            self.send_json({'dropped': True})
+            self.close_connection = True
+        elif url.path == '/slow':
+            ms = int(parse_qs(url.query).get('ms', ['2000'])[0])
+            time.sleep(ms / 1000.0)
+            self.send_json({'slow': ms})
+        else:
+            self.send_error(404)
+
+    def do_POST(self):
+        n = int(self.headers.get('Content-Length', '0'))
+        req = json.loads(self.rfile.read(n) or b'{}')
+        if urlparse(self.path).path != '/api/generate':
+            self.send_error(404)
+            return
+
+        if not req.get('stream', True):
+            self.send_json({'model': req.get('model', ''), 'response': ''.join(ANSWER), 'done': True})
+            return
+
+        self.send_response(200)
+        self.send_header('Content-Type', 'application/x-ndjson')
+        self.send_header('Transfer-Encoding', 'chunked')
+        self.end_headers()
+        try:
+            for i, piece in enumerate(ANSWER + ['']):
+                line = json.dumps({'response': piece, 'done': i == len(ANSWER)}) + '\n'
+                data = line.encode('utf-8')
+                self.wfile.write(b'%x\r\n%s\r\n' % (len(data), data))
+                self.wfile.flush()
+                time.sleep(0.02)
+            self.wfile.write(b'0\r\n\r\n')
+        except (BrokenPipeError, ConnectionResetError):
+            self.close_connection = True  # the client stopped reading
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument('--bind', default='127.0.0.1')
+    ap.add_argument('--port', type=int, default=11435)
+    args = ap.parse_args()
+
+    class Server(ThreadingHTTPServer):
+        address_family = socket.AF_INET6 if ':' in args.bind else socket.AF_INET
+
+    server = Server((args.bind, args.port), Handler)
+    print(f"ollama stand-in on {args.bind}:{args.port}")
+    server.serve_forever()
+
+
+if __name__ == '__main__':
+    main()
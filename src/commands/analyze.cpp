@@ -1,28 +1,45 @@
 #include "commands/analyze.hpp"
+#include "llm/CallRecorder.hpp"
 #include "llm/MockLLMClient.hpp"
 #include "llm/OllamaLLMClient.hpp"
 #include "llm/LLMClient.hpp"
 
+#include "jobs/CorpusIndex.hpp"
 #include "jobs/JobCorpus.hpp"
+#include "jobs/MentionStore.hpp"
+#include "jobs/Mentions.hpp"
+#include "jobs/PostingShrinker.hpp"
+#include "jobs/ProfileCache.hpp"
+#include "jobs/Retrieval.hpp"
 #include "jobs/RequirementExtractor.hpp"
+#include "jobs/SymbolTable.hpp"
 #include "jobs/TextUtil.hpp"
+#include "jobs/TokenSet.hpp"
 #include "jobs/EmbeddingIndex.hpp"
 #include "emb/MiniLmEmbedder.hpp"
 
 #include <algorithm>
-#include <cmath>
+#include <atomic>
+#include <cctype>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
-#include <functional>
 
 namespace fs = std::filesystem;
 
+using textutil::TokenId;
+using TokenSet = std::vector<TokenId>; // sorted, unique (see jobs/TokenSet.hpp)
+
 static bool has_flag(int argc, char** argv, const std::string& key) {
     for (int i = 0; i < argc; ++i) {
         if (std::string(argv[i]) == key) return true;
@@ -67,45 +84,9 @@ static bool open_out(std::ofstream& out, const std::string& out_path) {
 
 // ---------- tokenize helpers ----------
 
-static std::string to_lower_ascii(std::string s) {
-    for (char& c : s) if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
-    return s;
-}
-
-static std::string trim_ascii(const std::string& s) {
-    size_t i = 0;
-    while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) ++i;
-    size_t j = s.size();
-    while (j > i && (s[j - 1] == ' ' || s[j - 1] == '\t' || s[j - 1] == '\n' || s[j - 1] == '\r')) --j;
-    return s.substr(i, j - i);
-}
-
-static std::unordered_set<std::string> tokenize_post(const std::string& raw) {
-    std::string norm = textutil::normalize(raw);
-    auto toks = textutil::tokenize(norm);
-    auto ntoks = textutil::normalize_tokens(toks);
-
-    std::unordered_set<std::string> s;
-    s.reserve(ntoks.size());
-    for (auto& t : ntoks) {
-        if (!t.empty()) s.insert(t);
-    }
-    return s;
-}
+static TokenId tok_cplusplus() { static const TokenId id = textutil::intern("c++"); return id; }
+static TokenId tok_cpp()       { static const TokenId id = textutil::intern("cpp"); return id; }
 
-static std::unordered_set<std::string> tokenize_text(const std::string& raw) {
-    std::string norm = textutil::normalize(raw);
-    auto toks = textutil::tokenize(norm);
-    auto ntoks = textutil::normalize_tokens(toks);
-    std::unordered_set<std::string> s;
-    s.reserve(ntoks.size());
-    for (auto& t : ntoks) if (!t.empty()) s.insert(t);
-    if (s.find("cpp") != s.end()) {
-        s.erase("cpp");
-        s.insert("c++");
-    }
-    return s;
-}
 
 static void print_reqs(Printer& pr, const std::string& id, const ExtractedReqs& r) {
     pr << "\nPOST " << id << "\n";
@@ -122,38 +103,6 @@ static void print_reqs(Printer& pr, const std::string& id, const ExtractedReqs&
 
 // ---------- Day 3 helpers ----------
 
-static std::string canonicalize_skill(const std::string& raw) {
-    std::string s = trim_ascii(raw);
-    s = to_lower_ascii(s);
-
-    if (s == "c++17" || s == "c++20" || s == "c++14" || s == "c++11") return "c++";
-    if (s == "cpp") return "c++";
-    if (s == "js") return "javascript";
-    if (s == "ts") return "typescript";
-    if (s == "py") return "python";
-
-    return s;
-}
-
-static double span_weight_from_category(const std::string& cat) {
-    (void)cat;
-    return 1.0;
-}
-
-static double span_weight_from_span_type(const std::string& t) {
-    if (t == "requirement") return 1.0;
-    if (t == "preferred") return 0.6;
-    if (t == "responsibility") return 0.4;
-    return 0.2;
-}
-
-static double strength_weight(const std::string& s) {
-    if (s == "must") return 1.0;
-    if (s == "should") return 0.7;
-    if (s == "nice") return 0.4;
-    return 0.6;
-}
-
 static std::string json_escape(const std::string& s) {
     std::ostringstream oss;
     for (char c : s) {
@@ -174,23 +123,6 @@ static std::string json_escape(const std::string& s) {
     return oss.str();
 }
 
-struct Mention {
-    std::string posting_id;
-    std::string category;   // for non-LLM mode
-    std::string raw;
-    std::string canonical;
-    std::string strength;
-    std::string polarity;
-    double confidence = 0.0;
-    double contrib = 0.0;
-};
-
-struct SkillAgg {
-    int raw_count = 0;
-    double sum_contrib = 0.0;
-    std::vector<std::string> evidence;
-};
-
 static bool ensure_dir(const fs::path& p) {
     try {
         if (p.empty()) return true;
@@ -227,7 +159,7 @@ static void write_profile_json(
     const std::vector<std::string>& core,
     const std::vector<std::string>& secondary,
     const std::vector<std::string>& nice,
-    const std::unordered_map<std::string, SkillAgg>& agg
+    const std::vector<SkillTotal>& totals
 ) {
     std::ofstream f(path, std::ios::out | std::ios::trunc);
     if (!f) return;
@@ -261,6 +193,9 @@ static void write_profile_json(
     // evidence (cap to 50 keys, no trailing comma ever)
     f << "  \"evidence\": {\n";
 
+    std::unordered_map<std::string, const SkillTotal*> agg;
+    for (const auto& t : totals) agg.emplace(t.skill, &t);
+
     std::vector<std::string> keys;
     keys.reserve(std::min<size_t>(50, weights_sorted.size()));
 
@@ -273,7 +208,7 @@ static void write_profile_json(
     for (size_t i = 0; i < keys.size(); ++i) {
         const std::string& k = keys[i];
         auto it = agg.find(k);
-        const auto& ev = it->second.evidence;
+        const auto& ev = it->second->evidence;
 
         f << "    \"" << json_escape(k) << "\": [";
         for (size_t j = 0; j < ev.size(); ++j) {
@@ -289,270 +224,112 @@ static void write_profile_json(
 }
 
 
-// --- shrink what you send to the LLM ---
-static std::string shrink_posting_for_llm(const std::string& raw) {
-    std::string lower = to_lower_ascii(raw);
-
-    struct Key { const char* k; };
-    const Key starts[] = {
-        {"requirements"}, {"requirement"}, {"qualifications"}, {"qualification"},
-        {"responsibilities"}, {"responsibility"},
-        {"what you will do"}, {"what you'll do"}, {"what you bring"},
-        {"preferred"}, {"nice to have"}, {"nice-to-have"}, {"optional"}, {"bonus"}, {"plus"}
-    };
-
-    const Key stops[] = {
-        {"benefits"}, {"perks"}, {"about us"}, {"about the company"},
-        {"equal opportunity"}, {"eeo"}, {"privacy"}, {"legal"}, {"who we are"}
-    };
-
-    auto find_any = [&](const Key* arr, size_t n, size_t from) -> size_t {
-        size_t best = std::string::npos;
-        for (size_t i = 0; i < n; ++i) {
-            size_t pos = lower.find(arr[i].k, from);
-            if (pos != std::string::npos) {
-                if (best == std::string::npos || pos < best) best = pos;
-            }
-        }
-        return best;
-    };
-
-    std::string out;
-    out.reserve(9000);
-
-    size_t from = 0;
-    int blocks = 0;
-    while (blocks < 3) {
-        size_t s = find_any(starts, sizeof(starts)/sizeof(starts[0]), from);
-        if (s == std::string::npos) break;
-
-        size_t e = find_any(stops, sizeof(stops)/sizeof(stops[0]), s + 1);
-        if (e == std::string::npos) e = std::min(raw.size(), s + (size_t)4500);
-        else e = std::min(e, s + (size_t)4500);
-
-        if (!out.empty()) out += "\n\n";
-        out += raw.substr(s, e - s);
-
-        from = e;
-        blocks++;
-    }
-
-    if (out.empty()) {
-        size_t cap = std::min(raw.size(), (size_t)8000);
-        out = raw.substr(0, cap);
-    } else {
-        if (out.size() > 9000) out.resize(9000);
-    }
-
-    return out;
-}
-
-// ---------- NEW: zone extraction for rerank ----------
-
-struct Zones {
-    std::string title;
-    std::string lead;
-    std::string req;
-};
-
-static std::string extract_title_from_kv_blob(const std::string& raw) {
-    std::string lower = to_lower_ascii(raw);
-    size_t tpos = lower.find(":title");
-    if (tpos == std::string::npos) return "";
-
-    size_t start = raw.find_first_not_of(" \t\r\n", tpos + 6);
-    if (start == std::string::npos) return "";
-
-    while (start < raw.size() && (raw[start] == ' ' || raw[start] == '\t' || raw[start] == ':')) start++;
-    while (start < raw.size() && (raw[start] == ' ' || raw[start] == '\t')) start++;
-
-    size_t end = raw.find(", :description", start);
-    if (end == std::string::npos) end = raw.find(", :location", start);
-    if (end == std::string::npos) end = raw.find(", :employer", start);
-    if (end == std::string::npos) end = raw.find(", :skills", start);
-    if (end == std::string::npos) end = raw.find('\n', start);
-    if (end == std::string::npos) end = std::min(raw.size(), start + (size_t)160);
-
-    if (end <= start) return "";
-    std::string t = trim_ascii(raw.substr(start, end - start));
-    if (t.size() > 200) t.resize(200);
-    return t;
-}
-
-static std::string extract_title_fallback_line(const std::string& raw) {
-    size_t i = 0;
-    while (i < raw.size() && i < 2000) {
-        size_t j = raw.find('\n', i);
-        if (j == std::string::npos) j = raw.size();
-        std::string line = trim_ascii(raw.substr(i, j - i));
-        if (!line.empty()) {
-            if (line.size() <= 90) return line;
-            break;
-        }
-        i = (j == raw.size()) ? j : j + 1;
-    }
-    return "";
-}
-
-static std::string extract_requirements_block(const std::string& raw) {
-    std::string lower = to_lower_ascii(raw);
-
-    struct Key { const char* k; };
-    const Key starts[] = {
-        {"requirements"}, {"requirement"}, {"qualifications"}, {"qualification"},
-        {"what you bring"}, {"what you'll bring"}, {"skills"}, {"you have"}, {"must have"}
-    };
-
-    const Key stops[] = {
-        {"responsibilities"}, {"responsibility"},
-        {"benefits"}, {"perks"}, {"about us"}, {"about the company"},
-        {"equal opportunity"}, {"eeo"}, {"privacy"}, {"legal"}
-    };
-
-    auto find_any = [&](const Key* arr, size_t n, size_t from) -> size_t {
-        size_t best = std::string::npos;
-        for (size_t i = 0; i < n; ++i) {
-            size_t pos = lower.find(arr[i].k, from);
-            if (pos != std::string::npos) {
-                if (best == std::string::npos || pos < best) best = pos;
-            }
-        }
-        return best;
-    };
-
-    std::string out;
-    out.reserve(5000);
-
-    size_t from = 0;
-    int blocks = 0;
-    while (blocks < 2) {
-        size_t s = find_any(starts, sizeof(starts)/sizeof(starts[0]), from);
-        if (s == std::string::npos) break;
-
-        size_t e = find_any(stops, sizeof(stops)/sizeof(stops[0]), s + 1);
-        if (e == std::string::npos) e = std::min(raw.size(), s + (size_t)3500);
-        else e = std::min(e, s + (size_t)3500);
-
-        if (!out.empty()) out += "\n\n";
-        out += raw.substr(s, e - s);
-
-        from = e;
-        blocks++;
-    }
-
-    if (out.size() > 6000) out.resize(6000);
-    return out;
-}
-
-static Zones extract_zones(const std::string& raw) {
-    Zones z;
-
-    z.title = extract_title_from_kv_blob(raw);
-    if (z.title.empty()) z.title = extract_title_fallback_line(raw);
-
-    // lead: very top of posting, domain-agnostic
-    const size_t LEAD_CAP = 1400;
-    if (!raw.empty()) {
-        size_t cap = std::min(raw.size(), LEAD_CAP);
-        z.lead = raw.substr(0, cap);
-    }
-
-    z.req = extract_requirements_block(raw);
-    return z;
-}
-
 // --- tokenize the query/role so lex rerank is anchored to what user asked ---
-static std::unordered_set<std::string> tokenize_query(const std::string& role) {
-    std::string norm = textutil::normalize(role);
-    auto toks = textutil::tokenize(norm);
-    auto ntoks = textutil::normalize_tokens(toks);
-    std::unordered_set<std::string> s;
-    s.reserve(ntoks.size());
-    for (auto& t : ntoks) if (!t.empty()) s.insert(t);
-
-    if (s.find("cpp") != s.end()) {
-        s.erase("cpp");
-        s.insert("c++");
-    }
-    return s;
+static TokenSet tokenize_query(const std::string& role) {
+    return zone_token_ids(role);
 }
 
-static bool role_mentions_cpp(const std::unordered_set<std::string>& q) {
-    return (q.find("c++") != q.end() || q.find("cpp") != q.end());
+static bool has_cpp_token(textutil::TokenSpan toks) {
+    return textutil::contains(toks, tok_cplusplus()) || textutil::contains(toks, tok_cpp());
 }
 
-static bool post_has_cpp(const std::unordered_set<std::string>& toks) {
-    return (toks.find("c++") != toks.end() || toks.find("cpp") != toks.end());
+static bool role_mentions_cpp(const TokenSet& q) {
+    return has_cpp_token(q);
 }
 
-static bool tokens_has_any(const std::unordered_set<std::string>& toks, const std::unordered_set<std::string>& need) {
-    for (const auto& x : need) {
-        if (toks.find(x) != toks.end()) return true;
-    }
-    return false;
-}
+// one role per line; blank lines and '#' comments are skipped
+static bool read_roles_file(const std::string& path, std::vector<std::string>& roles) {
+    std::ifstream in(path);
+    if (!in) return false;
 
-static double zone_query_score(const std::unordered_set<std::string>& zone_toks,
-                               const std::unordered_set<std::string>& q_tokens,
-                               const std::function<double(const std::string&)>& idf) {
-    double s = 0.0;
-    for (const auto& qt : q_tokens) {
-        if (zone_toks.find(qt) != zone_toks.end()) s += idf(qt);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t a = line.find_first_not_of(" \t");
+        if (a == std::string::npos || line[a] == '#') continue;
+        size_t b = line.find_last_not_of(" \t");
+        roles.push_back(line.substr(a, b - a + 1));
     }
-    return s;
+    return true;
 }
 
-static bool title_has_conflicting_lang(const std::unordered_set<std::string>& title_toks,
-                                       const std::unordered_set<std::string>& q_tokens) {
-    const bool q_has_cpp = (q_tokens.find("c++") != q_tokens.end() || q_tokens.find("cpp") != q_tokens.end());
-    if (!q_has_cpp) return false;
-
-    const bool title_has_cpp = (title_toks.find("c++") != title_toks.end() || title_toks.find("cpp") != title_toks.end());
-    if (title_has_cpp) return false;
-
-    static const char* langs[] = {
-        "java","python","ruby","c#","csharp","javascript","typescript","php","scala","kotlin","golang","go"
-    };
-
-    for (const char* l : langs) {
-        if (title_toks.find(l) != title_toks.end()) return true;
-    }
-    return false;
+// per-role output directory name: lowercase ascii alnum, runs of anything else -> '_'
+static std::string role_slug(const std::string& role) {
+    std::string s;
+    for (unsigned char c : role) {
+        if (std::isalnum(c)) s.push_back((char)std::tolower(c));
+        else if (c == '+') s += "p";
+        else if (c == '#') s += "sharp";
+        else if (!s.empty() && s.back() != '_') s.push_back('_');
+    }
+    while (!s.empty() && s.back() == '_') s.pop_back();
+    return s.empty() ? "role" : s;
 }
 
 // ---------------------------------------------------
 
-int cmd_analyze(int argc, char** argv) {
+int cmd_analyze(int argc, char** argv, AnalyzeResult* result) {
     std::string role         = get_arg(argc, argv, "--role", "");
+    std::string roles_path   = get_arg(argc, argv, "--roles", "");
     std::string jobs_dir     = get_arg(argc, argv, "--jobs", "data/jobs/sample500");
     std::string topk_s       = get_arg(argc, argv, "--topk", "10"); // default changed to 15
+    std::string threads_s    = get_arg(argc, argv, "--threads", "0");
 
     // LLM args
     std::string llm_mock_dir = get_arg(argc, argv, "--llm_mock", "");
     std::string llm_model    = get_arg(argc, argv, "--llm_model", "llama3.2:3b");
     std::string llm_cache    = get_arg(argc, argv, "--llm_cache", "out/llm_cache");
+    std::string llm_conc_s   = get_arg(argc, argv, "--llm_concurrency", "4");
+    std::string llm_tmo_s    = get_arg(argc, argv, "--llm_timeout", "300");
+    std::string llm_batch_s  = get_arg(argc, argv, "--llm_batch", "4");
+    std::string llm_btok_s   = get_arg(argc, argv, "--llm_batch_tokens", "6000");
+    std::string llm_ptok_s   = get_arg(argc, argv, "--llm_posting_tokens", "512");
+    std::string llm_conf_s   = get_arg(argc, argv, "--llm_min_confidence", "0.5");
+    std::string llm_mlat_s   = get_arg(argc, argv, "--llm_mock_latency", "0");
+    std::string llm_mjit_s   = get_arg(argc, argv, "--llm_mock_jitter", "0");
+    std::string llm_record   = get_arg(argc, argv, "--llm_record", "");
+    std::string llm_replay   = get_arg(argc, argv, "--llm_replay", "");
+    std::string llm_rspeed_s = get_arg(argc, argv, "--llm_replay_speed", "1");
 
     std::string emb_path     = get_arg(argc, argv, "--emb", "data/embeddings/jobs.bin");
+    std::string cindex_path  = get_arg(argc, argv, "--corpus_index", CorpusIndex::default_path(emb_path));
+    std::string mstore_path  = get_arg(argc, argv, "--mentions_store", MentionStore::default_path(emb_path));
     std::string model        = get_arg(argc, argv, "--model", "models/emb/model.onnx");
     std::string vocab        = get_arg(argc, argv, "--vocab", "models/emb/vocab.txt");
 
     std::string min_score_s  = get_arg(argc, argv, "--min_score", "0.30");
+    std::string skills_path  = get_arg(argc, argv, "--skills", ""); // extra skills on top of the built-in lexicon
     std::string out_path     = get_arg(argc, argv, "--out", "");
+    std::string pcache_dir   = get_arg(argc, argv, "--profile_cache", "out/profile_cache");
 
-    bool use_llm    = has_flag(argc, argv, "--llm");
+    bool llm_hybrid = has_flag(argc, argv, "--llm_hybrid");
+    bool use_llm    = has_flag(argc, argv, "--llm") || llm_hybrid || !llm_replay.empty();
+    bool llm_stream = !has_flag(argc, argv, "--llm_no_stream");
     bool do_profile = has_flag(argc, argv, "--profile");
     std::string outdir_s = get_arg(argc, argv, "--outdir", "out");
 
     // IMPORTANT CHANGE:
-    // Title/top-part is FIRST PRIORITY now.
+    // Title/top-part is FIRST PRIORITY now (see RetrievalConfig / RerankWeights).
     // We still keep embedding in the mix, but it’s a *tie-breaker*.
-    const size_t topn_seed   = 10;
-    const size_t topx_tokens = 30;
-    const size_t bigk_floor  = 80; // increased so title-only postings have more chance to show up
-
-    if (role.empty()) {
+    RetrievalConfig rcfg;
+
+    // --roles: every role shares the corpus, index, embedder and extractor loaded below
+    std::vector<std::string> roles;
+    const bool multi = !roles_path.empty();
+    if (multi) {
+        if (!read_roles_file(roles_path, roles)) {
+            std::cerr << "error: failed to read --roles file: " << roles_path << "\n";
+            return 1;
+        }
+        if (roles.empty()) {
+            std::cerr << "error: no roles in " << roles_path << "\n";
+            return 1;
+        }
+    } else if (role.empty()) {
         std::cerr << "error: missing --role\n";
         return 1;
+    } else {
+        roles.push_back(role);
     }
 
     double min_score = 0.0;
@@ -570,6 +347,36 @@ int cmd_analyze(int argc, char** argv) {
     }
     if (topk == 0) topk = 1;
 
+    size_t threads = 0;
+    try { threads = (size_t)std::stoul(threads_s); }
+    catch (...) {
+        std::cerr << "error: invalid --threads\n";
+        return 1;
+    }
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    size_t llm_concurrency = 0, llm_batch = 0, llm_batch_tokens = 0, llm_posting_tokens = 0;
+    double llm_min_confidence = 0.0, llm_mock_latency = 0.0, llm_mock_jitter = 0.0, llm_replay_speed = 1.0;
+    llm::HttpOptions llm_http;
+    try {
+        llm_concurrency = (size_t)std::stoul(llm_conc_s);
+        llm_http.read_timeout_ms = (int)(std::stod(llm_tmo_s) * 1000.0);
+        llm_batch = (size_t)std::stoul(llm_batch_s);
+        llm_batch_tokens = (size_t)std::stoul(llm_btok_s);
+        llm_posting_tokens = (size_t)std::stoul(llm_ptok_s);
+        llm_min_confidence = std::stod(llm_conf_s);
+        llm_mock_latency = std::stod(llm_mlat_s);
+        llm_mock_jitter = std::stod(llm_mjit_s);
+        llm_replay_speed = std::stod(llm_rspeed_s);
+    } catch (...) {
+        std::cerr << "error: invalid --llm_concurrency / --llm_timeout / --llm_batch / --llm_batch_tokens / --llm_posting_tokens"
+                     " / --llm_min_confidence / --llm_mock_latency / --llm_mock_jitter / --llm_replay_speed\n";
+        return 1;
+    }
+
+    rcfg.topk = topk;
+    rcfg.min_score = min_score;
+
     std::ofstream out;
     bool write_out = false;
     if (!out_path.empty()) {
@@ -597,27 +404,81 @@ int cmd_analyze(int argc, char** argv) {
         }
     }
 
-    JobCorpus corpus = JobCorpus::load_from_dir(jobs_dir);
-
-    pr << "ROLE: " << role << "\n";
-    pr << "JOBS_DIR: " << jobs_dir << "\n";
-    pr << "POSTINGS: " << corpus.postings().size() << "\n";
+    // single role -> outdir; --roles -> outdir/<role_slug>, with the first free numeric
+    // suffix when the name is taken ("C", "C", "c 2" -> c, c_2, c_2_2)
+    std::vector<fs::path> role_outdirs;
+    if (!multi) {
+        role_outdirs.push_back(outdir);
+    } else {
+        std::unordered_set<std::string> taken;
+        for (const auto& r : roles) {
+            const std::string base = role_slug(r);
+            std::string slug = base;
+            for (int n = 2; !taken.insert(slug).second; ++n) slug = base + "_" + std::to_string(n);
+            role_outdirs.push_back(outdir / slug);
+        }
+    }
 
-    std::unordered_map<std::string, const JobPosting*> by_id;
-    by_id.reserve(corpus.postings().size());
-    for (const auto& p : corpus.postings()) by_id[p.id] = &p;
+    // finished profiles are reused when nothing they depend on changed
+    ProfileCache pcache(do_profile ? pcache_dir : std::string());
+    std::vector<ProfileKey> role_pkeys(roles.size());
+    std::vector<std::string> role_keys(roles.size());
+    std::vector<char> role_cached(roles.size(), 0);
+    size_t n_cached = 0;
+    if (pcache.enabled()) {
+        for (size_t r = 0; r < roles.size(); ++r) {
+            role_pkeys[r] = ProfileKey{roles[r], jobs_dir, emb_path, topk, min_score, use_llm, llm_model, llm_mock_dir,
+                                       skills_path, llm_posting_tokens, llm_batch, llm_batch_tokens, llm_stream,
+                                       llm_hybrid, llm_min_confidence, llm_replay};
+            role_keys[r] = ProfileCache::fingerprint(role_pkeys[r]);
+            role_cached[r] = pcache.restore(role_keys[r], role_outdirs[r]);
+            n_cached += role_cached[r] ? 1 : 0;
+        }
+    }
+    if (result && roles.size() == 1) {
+        result->profile_cache_hit = role_cached[0] != 0;
+        result->profile_cache_key = role_keys[0];
+    }
 
-    std::unordered_map<std::string, std::unordered_set<std::string>> post_tokens;
-    post_tokens.reserve(corpus.postings().size());
+    auto print_cache_hit = [&](size_t r) {
+        pr << "PROFILE_CACHE: hit " << role_keys[r] << "\n";
+        pr << "\nwrote " << (role_outdirs[r] / "mentions.jsonl").string() << "\n";
+        pr << "wrote " << (role_outdirs[r] / "profile.json").string() << "\n";
+    };
 
-    std::unordered_map<std::string, int> df;
-    df.reserve(4096);
+    if (n_cached == roles.size()) {
+        if (multi) pr << "ROLES: " << roles.size() << " (" << roles_path << ")\n";
+        else pr << "ROLE: " << role << "\n";
+        pr << "JOBS_DIR: " << jobs_dir << "\n";
+        for (size_t r = 0; r < roles.size(); ++r) {
+            if (multi) pr << "\n== ROLE: " << roles[r] << "\n";
+            print_cache_hit(r);
+        }
+        if (write_out) {
+            out.flush();
+            out.close();
+            std::cout << "\nWROTE: " << out_path << "\n";
+        }
+        return 0;
+    }
 
-    for (const auto& p : corpus.postings()) {
-        auto s = tokenize_post(p.raw_text);
-        for (const auto& tok : s) df[tok] += 1;
-        post_tokens.emplace(p.id, std::move(s));
+    // Corpus features come from the sidecar written by `embed` when it matches --jobs;
+    // otherwise the postings are tokenized here and zones are computed once per hit.
+    RetrievalCorpus corpus;
+    if (!corpus.load(jobs_dir, cindex_path)) {
+        std::cerr << "error: no postings in --jobs dir: " << jobs_dir << "\n";
+        return 1;
     }
+    const size_t M = corpus.size();
+
+    if (multi) pr << "ROLES: " << roles.size() << " (" << roles_path << ")\n";
+    else pr << "ROLE: " << role << "\n";
+    pr << "JOBS_DIR: " << jobs_dir << "\n";
+    if (corpus.uses_index()) pr << "CORPUS_INDEX: " << cindex_path << "\n";
+    pr << "POSTINGS: " << M << "\n";
+
+    auto find_posting = [&](const std::string& job_id) { return corpus.find(job_id); };
+    auto posting_text = [&](size_t pi, std::string& buf) -> const std::string& { return corpus.text(pi, buf); };
 
     EmbeddingIndex idx;
     if (!idx.load(emb_path)) {
@@ -632,379 +493,273 @@ int cmd_analyze(int argc, char** argv) {
         return 1;
     }
 
-    auto q = emb.embed(role, 64);
-    if (q.empty() || q.size() != idx.dim()) {
-        std::cerr << "error: query embedding dim mismatch\n";
-        return 1;
-    }
-
-    size_t bigk = std::max(topk, bigk_floor);
-    auto hits = idx.topk(q, bigk);
-
-    pr << "RAW_HITS: " << hits.size() << "\n";
-
-    if (hits.empty()) {
-        pr << "KEPT: 0 (min_score=" << min_score << ")\n";
-        if (write_out) { out.flush(); out.close(); }
-        return 0;
-    }
-
-    // query tokens early (so we can "rescue" strong-title hits even if emb score is low)
-    auto q_tokens = tokenize_query(role);
-    const bool wants_cpp = role_mentions_cpp(q_tokens);
+    // all role queries in one session run
+    std::vector<std::vector<float>> queries;
+    if (multi) queries = emb.embed_batch(roles, 64);
+    else queries.push_back(emb.embed(role, 64));
 
-    // IMPORTANT CHANGE:
-    // Do NOT throw away postings just because embedding is below min_score
-    // if the TITLE / TOP PART matches the query tokens.
-    std::vector<decltype(hits)::value_type> kept;
-    kept.reserve(hits.size());
-    for (const auto& h : hits) {
-        bool keep_by_emb = (h.score >= min_score);
-
-        bool keep_by_title_or_lead = false;
-        auto itp = by_id.find(h.job_id);
-        if (itp != by_id.end()) {
-            Zones z = extract_zones(itp->second->raw_text);
-            auto title_toks = tokenize_text(z.title);
-            auto lead_toks  = tokenize_text(z.lead);
-
-            // "title/top is first priority": if any query token appears in title OR lead, keep it.
-            // This is what makes your one-line "C++ Backend Engineer" reliably survive filtering.
-            keep_by_title_or_lead = tokens_has_any(title_toks, q_tokens) || tokens_has_any(lead_toks, q_tokens);
+    for (const auto& q : queries) {
+        if (q.empty() || q.size() != idx.dim()) {
+            std::cerr << "error: query embedding dim mismatch\n";
+            return 1;
         }
-
-        if (keep_by_emb || keep_by_title_or_lead) kept.push_back(h);
     }
-
-    pr << "KEPT: " << kept.size() << " (min_score=" << min_score << ", title/lead rescue enabled)\n";
-
-    if (kept.empty()) {
-        if (write_out) { out.flush(); out.close(); }
-        return 0;
+    if (queries.size() != roles.size()) {
+        std::cerr << "error: query embedding failed\n";
+        return 1;
     }
 
-    const size_t M = corpus.postings().size();
-
-    auto idf = [&](const std::string& tok) -> double {
-        auto it = df.find(tok);
-        int d = (it == df.end()) ? 0 : it->second;
-        return std::log((1.0 + (double)M) / (1.0 + (double)d));
-    };
-
-    // seed top tokens from seed hits (keeps your existing "top_tokens" flavor)
-    const size_t seedN = std::min(topn_seed, kept.size());
-    std::unordered_map<std::string, int> tf_top;
-    tf_top.reserve(1024);
-
-    for (size_t i = 0; i < seedN; ++i) {
-        const auto& h = kept[i];
-        auto pt_it = post_tokens.find(h.job_id);
-        if (pt_it == post_tokens.end()) continue;
-        for (const auto& tok : pt_it->second) tf_top[tok] += 1;
-    }
+    // query tokens early (so we can "rescue" strong-title hits even if emb score is low)
+    std::vector<TokenSet> role_tokens;
+    for (const auto& r : roles) role_tokens.push_back(tokenize_query(r));
 
-    struct TokScore { std::string tok; double score; };
-    std::vector<TokScore> scored;
-    scored.reserve(tf_top.size());
-    for (const auto& kv : tf_top) {
-        double s2 = (double)kv.second * idf(kv.first);
-        if (s2 > 0.0) scored.push_back({kv.first, s2});
+    // Roles rank concurrently: everything they would intern or memoize is settled here
+    // first, so the ranking below only reads shared state.
+    std::vector<double> idf_shared;
+    if (multi) {
+        corpus.warm_zones();
+        (void)tok_cplusplus();
+        (void)tok_cpp();
+        idf_shared = corpus.idf_table();
     }
 
-    std::sort(scored.begin(), scored.end(),
-              [](const TokScore& a, const TokScore& b){ return a.score > b.score; });
+    // retrieval + rerank for one role; nullopt when nothing survives filtering
+    auto rank_role = [&](size_t r, Printer& rp) -> std::optional<std::vector<RankedHit>> {
+        RetrievalResult res = retrieve(corpus, idx, queries[r], role_tokens[r], rcfg, multi ? &idf_shared : nullptr);
 
-    if (scored.size() > topx_tokens) scored.resize(topx_tokens);
+        rp << "RAW_HITS: " << res.raw_hits << "\n";
 
-    std::unordered_set<std::string> top_tokens;
-    top_tokens.reserve(scored.size() * 2);
-    for (const auto& ts : scored) top_tokens.insert(ts.tok);
-
-    // always include query tokens in lex scoring set
-    for (const auto& qt : q_tokens) {
-        if (!qt.empty()) top_tokens.insert(qt);
-    }
-
-    struct RankedHit {
-        std::string job_id;
+        if (res.raw_hits == 0) {
+            rp << "KEPT: 0 (min_score=" << min_score << ")\n";
+            return std::nullopt;
+        }
 
-        double emb_score = 0.0;
-        double lex_score = 0.0;      // still printed (now mostly header-driven)
-        double combined  = 0.0;      // now effectively "header-first"
+        rp << "KEPT: " << res.kept << " (min_score=" << min_score << ", title/lead rescue enabled)\n";
 
-        // debug flags
-        bool has_cpp = false;
-        bool has_title = false;
-        bool title_conflict = false;
-        bool identity_match = false;
+        if (res.kept == 0) return std::nullopt;
 
-        // debug scores
-        double s_title = 0.0;
-        double s_lead  = 0.0;
-        double s_req   = 0.0;
+        rp << "TOPK: " << res.ranked.size() << "\n";
+        return std::move(res.ranked);
     };
 
-    std::vector<RankedHit> ranked;
-    ranked.reserve(kept.size());
-
-    // IMPORTANT CHANGE: SUPER HEAVY title weighting.
-    // If you want “title/top part is first priority”, you do NOT want alpha=0.7 anymore.
-    // Here we make title dominate; embedding becomes a weak tie-breaker.
-    const double WT_TITLE = 200.0;
-    const double WT_LEAD  = 80.0;
-    const double WT_REQ   = 20.0;
-    const double WT_BODYQ = 4.0;
-    const double WT_BODYLEX = 1.0;
-
-    // penalties/bonuses for identity mismatch (C++ example, but only kicks in when query has C++)
-    const double PENALTY_TITLE_CONFLICT = 500.0; // "Java ..." title when query asks for C++
-    const double PENALTY_MISSING_IDENTITY = 200.0;
-    const double BONUS_IDENTITY_IN_TITLE  = 120.0;
-
-    for (const auto& h : kept) {
-        auto itp = by_id.find(h.job_id);
-        if (itp == by_id.end()) continue;
+    // single role: rank straight to the console, as before
+    std::vector<std::optional<std::vector<RankedHit>>> role_ranked(roles.size());
+    std::vector<std::ostringstream> role_logs(roles.size());
 
-        const auto& post = *itp->second;
-
-        auto pt_it = post_tokens.find(h.job_id);
-        if (pt_it == post_tokens.end()) continue;
-
-        const auto& body_toks = pt_it->second;
-
-        Zones z = extract_zones(post.raw_text);
-
-        auto title_toks = tokenize_text(z.title);
-        auto lead_toks  = tokenize_text(z.lead);
-        auto req_toks   = tokenize_text(z.req);
-
-        const bool has_title = !trim_ascii(z.title).empty();
-
-        // Title/lead identity match: query tokens appear in title or lead
-        const bool title_match = has_title ? tokens_has_any(title_toks, q_tokens) : false;
-        const bool lead_match  = tokens_has_any(lead_toks,  q_tokens);
-        const bool identity_match = (has_title ? (title_match || lead_match) : lead_match);
-
-        // base body lex (seeded tokens) — now small, since you want header first
-        double base_lex = 0.0;
-        for (const auto& tok : body_toks) {
-            if (top_tokens.find(tok) != top_tokens.end()) base_lex += idf(tok);
+    if (!multi) {
+        role_ranked[0] = rank_role(0, pr);
+        if (!role_ranked[0]) {
+            if (write_out) { out.flush(); out.close(); }
+            return 0;
         }
-
-        // query-token presence scores per zone
-        double s_title = zone_query_score(title_toks, q_tokens, idf);
-        double s_lead  = zone_query_score(lead_toks,  q_tokens, idf);
-        double s_req   = zone_query_score(req_toks,   q_tokens, idf);
-        double s_bodyq = zone_query_score(body_toks,  q_tokens, idf);
-
-        // C++ conflict logic retained (helps avoid "Java Software Engineer" when role says C++)
-        const bool title_conflict = title_has_conflicting_lang(title_toks, q_tokens);
-        const bool title_has_cpp = (title_toks.find("c++") != title_toks.end() || title_toks.find("cpp") != title_toks.end());
-        const bool lead_has_cpp  = (lead_toks.find("c++")  != lead_toks.end()  || lead_toks.find("cpp")  != lead_toks.end());
-
-        double identity_adj = 0.0;
-        if (wants_cpp) {
-            if (title_conflict) identity_adj -= PENALTY_TITLE_CONFLICT;
-
-            const bool in_title_or_lead = (title_has_cpp || lead_has_cpp);
-            if (!in_title_or_lead) identity_adj -= PENALTY_MISSING_IDENTITY;
-            else if (title_has_cpp) identity_adj += BONUS_IDENTITY_IN_TITLE;
-        }
-
-        // FINAL: Header-first score.
-        // This is what forces a one-line "C++ Backend Engineer" posting to rise to the top.
-        double header_first_score =
-            WT_TITLE * s_title +
-            WT_LEAD  * s_lead  +
-            WT_REQ   * s_req   +
-            WT_BODYQ * s_bodyq +
-            WT_BODYLEX * base_lex +
-            identity_adj;
-
-        // Embedding is now ONLY a tiny tie-breaker.
-        // (We keep it so the system still works when postings have no usable titles.)
-        const double emb_tiebreak = 5.0 * (double)h.score;
-
-        double combined = header_first_score + emb_tiebreak;
-
-        RankedHit rh;
-        rh.job_id = h.job_id;
-        rh.emb_score = (double)h.score;
-        rh.lex_score = header_first_score; // keep printing as "lex" for continuity
-        rh.combined  = combined;
-
-        rh.has_cpp = post_has_cpp(body_toks);
-        rh.has_title = has_title;
-        rh.title_conflict = title_conflict;
-        rh.identity_match = identity_match;
-
-        rh.s_title = s_title;
-        rh.s_lead  = s_lead;
-        rh.s_req   = s_req;
-
-        ranked.push_back(std::move(rh));
+    } else {
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t r = next++; r < roles.size(); r = next++) {
+                if (role_cached[r]) continue;
+                Printer rp;
+                rp.a = &role_logs[r];
+                role_ranked[r] = rank_role(r, rp);
+            }
+        };
+        std::vector<std::thread> pool;
+        const size_t n_threads = std::min(threads, roles.size());
+        for (size_t t = 1; t < n_threads; ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
     }
 
-    // HARD RULE: title/lead identity matches are always first.
-    // Then sort by the header-first score.
-    std::stable_partition(ranked.begin(), ranked.end(),
-                          [](const RankedHit& r){ return r.identity_match; });
-
-    std::sort(ranked.begin(), ranked.end(),
-              [](const RankedHit& a, const RankedHit& b){ return a.combined > b.combined; });
-
-    if (ranked.size() > topk) ranked.resize(topk);
-
-    pr << "TOPK: " << ranked.size() << "\n";
-
     // LLM clients
     llm::NullLLMClient null_llm;
     llm::MockLLMClient mock_llm(llm_mock_dir.empty() ? "llm_mock" : llm_mock_dir);
-    llm::OllamaLLMClient ollama_llm(llm_model, llm_cache);
+    llm::OllamaLLMClient ollama_llm(llm_model, llm_cache, llm_http, llm_stream);
+    ollama_llm.set_batching(llm_batch, llm_batch_tokens);
+    llm::ReplayLLMClient replay_llm(llm_replay_speed);
+    const PostingShrinker llm_shrinker =
+        use_llm ? PostingShrinker::with_vocab(vocab, llm_posting_tokens) : PostingShrinker(llm_posting_tokens);
+    if (use_llm && !llm_shrinker.has_counter()) {
+        std::cerr << "warning: cannot load " << vocab << "; estimating prompt tokens from length\n";
+    }
 
     llm::LLMClient* llm_client = nullptr;
 
     if (use_llm) {
-        if (!llm_mock_dir.empty()) {
+        if (!llm_replay.empty()) {
+            if (!replay_llm.load(llm_replay)) {
+                std::cerr << "error: " << replay_llm.last_error() << "\n";
+                return 1;
+            }
+            llm_client = (llm::LLMClient*)&replay_llm;
+        } else if (!llm_mock_dir.empty()) {
+            if (!mock_llm.load()) {
+                std::cerr << "error: " << mock_llm.last_error() << "\n";
+                return 1;
+            }
+            mock_llm.set_latency(llm_mock_latency, llm_mock_jitter);
             llm_client = (llm::LLMClient*)&mock_llm;
         } else {
             llm_client = (llm::LLMClient*)&ollama_llm;
         }
     }
 
-    RequirementExtractor ex;
-
-    std::vector<Mention> all_mentions;
-    all_mentions.reserve(ranked.size() * 32);
-
-    std::unordered_map<std::string, SkillAgg> agg;
-
-    // posting_id -> canonical skill -> best mention
-    std::unordered_map<std::string, std::unordered_map<std::string, Mention>> best_by_posting;
-    best_by_posting.reserve(ranked.size());
-
-    for (size_t i = 0; i < ranked.size(); ++i) {
-        const auto& rh = ranked[i];
-        auto it = by_id.find(rh.job_id);
-        if (it == by_id.end()) continue;
-
-        pr << "\n# hit " << rh.job_id
-           << " combined=" << rh.combined
-           << " emb=" << rh.emb_score
-           << " header=" << rh.lex_score
-           << " TITLE=" << rh.s_title
-           << " LEAD=" << rh.s_lead
-           << " REQ=" << rh.s_req
-           << " ID_MATCH=" << (rh.identity_match ? "yes" : "no");
-
-        if (wants_cpp) pr << " TITLE_CONFLICT=" << (rh.title_conflict ? "yes" : "no");
-        pr << "\n";
-
-        const std::string& post_id = it->second->id;
-        const std::string& text    = it->second->raw_text;
+    // every LLM call goes through the recorder, for the latency summary and --llm_record
+    llm::RecordingLLMClient llm_recorder(llm_client ? *llm_client : (llm::LLMClient&)null_llm);
+    if (!llm_record.empty() && !llm_recorder.open_log(llm_record)) {
+        std::cerr << "error: failed to open --llm_record path: " << llm_record << "\n";
+        return 1;
+    }
+    double llm_stage_sec = 0.0;
 
-        if (!use_llm) {
-            // ------- Non-LLM path -------
-            auto reqs = ex.extract(text);
-            print_reqs(pr, post_id, reqs);
+    RequirementExtractor ex;
+    if (!skills_path.empty() && !ex.load_dictionary(skills_path)) {
+        std::cerr << "error: failed to load --skills dictionary: " << skills_path << "\n";
+        return 1;
+    }
 
-            if (!do_profile) continue;
+    // precomputed mentions (extract --store): used for a role only if it covers every hit
+    // and was built by the same extraction setup (never in hybrid mode, which mixes two,
+    // or when replaying a recording)
+    MentionStore mstore;
+    const bool mstore_ok = !llm_hybrid && llm_replay.empty() && !mstore_path.empty() && mstore.load(mstore_path) &&
+                           mstore.matches(jobs_dir, mention_source({use_llm, llm_mock_dir, llm_model, llm_posting_tokens, llm_batch,
+                                                                    llm_batch_tokens, llm_stream, skills_path}));
+
+    // mentions + profile for one ranked role
+    auto profile_role = [&](size_t ri, const std::string& role_name, const TokenSet& q_tokens,
+                            const std::vector<RankedHit>& ranked, const fs::path& role_outdir) {
+        const bool wants_cpp = role_mentions_cpp(q_tokens);
+
+        std::vector<size_t> hit_rows(ranked.size(), 0);
+        bool use_mstore = mstore_ok;
+        for (size_t i = 0; use_mstore && i < ranked.size(); ++i) {
+            auto mi = mstore.find(ranked[i].job_id);
+            if (mi) hit_rows[i] = *mi;
+            else use_mstore = false;
+        }
+        if (use_mstore) pr << "MENTIONS_STORE: " << mstore_path << "\n";
+
+        // non-LLM path (and hybrid's first pass): extract every hit up front on the worker pool
+        std::vector<ExtractedReqs> hit_reqs;
+        if ((!use_llm || llm_hybrid) && !use_mstore) {
+            hit_reqs.resize(ranked.size());
+            ex.extract_batch(
+                ranked.size(),
+                [&](size_t i) {
+                    auto pi = find_posting(ranked[i].job_id);
+                    std::string buf;
+                    return pi ? std::string(posting_text(*pi, buf)) : std::string();
+                },
+                [&](size_t i, ExtractedReqs& r) { hit_reqs[i] = std::move(r); });
+        }
 
-            for (const auto& [cat, items] : reqs.by_category) {
-                if (items.empty()) continue;
-
-                const double sw = span_weight_from_category(cat);
-                for (const auto& raw_skill : items) {
-                    std::string canon = canonicalize_skill(raw_skill);
-                    if (canon.empty()) continue;
-
-                    Mention m;
-                    m.posting_id = post_id;
-                    m.category   = cat;
-                    m.raw        = raw_skill;
-                    m.canonical  = canon;
-
-                    m.strength   = "must";
-                    m.polarity   = "positive";
-                    m.confidence = 1.0;
-                    m.contrib    = sw * 1.0 * m.confidence;
-
-                    auto& mp = best_by_posting[m.posting_id];
-                    auto it2 = mp.find(m.canonical);
-                    if (it2 == mp.end() || m.contrib > it2->second.contrib) mp[m.canonical] = m;
-                }
+        // hybrid: only hits the extractor is unsure about go to the LLM
+        std::vector<double> hit_conf;
+        std::vector<char> to_llm(ranked.size(), use_llm && !use_mstore && do_profile && llm_client ? 1 : 0);
+        if (llm_hybrid && !use_mstore) {
+            hit_conf.resize(ranked.size());
+            for (size_t i = 0; i < ranked.size(); ++i) {
+                hit_conf[i] = RequirementExtractor::confidence(hit_reqs[i]);
+                if (hit_conf[i] >= llm_min_confidence) to_llm[i] = 0;
             }
-        } else {
-            // ------- LLM path -------
-            if (!do_profile) continue;
-            if (!llm_client) continue;
-
-            std::string shrunk = shrink_posting_for_llm(text);
-            auto evidences = llm_client->analyze_posting(post_id, shrunk);
-
-            for (const auto& ev0 : evidences) {
-                std::string pol = ev0.polarity;
-                if (pol.empty()) pol = "positive";
-                if (pol == "negated") continue;
-
-                std::string st = ev0.strength;
-                if (st.empty()) st = "unknown";
-
-                std::string stype = ev0.span_type;
-                if (stype.empty()) stype = "other";
-
-                const double sw  = span_weight_from_span_type(stype);
-                const double stw = strength_weight(st);
+        }
 
-                for (const auto& sh : ev0.skills) {
-                    std::string canon = canonicalize_skill(!sh.canonical.empty() ? sh.canonical : sh.raw);
-                    if (canon.empty()) continue;
+        // LLM path: up to --llm_concurrency postings in flight, merged back in rank order
+        std::vector<std::vector<Mention>> hit_llm;
+        std::vector<size_t> llm_rows; // ranked index of each posting sent
+        size_t llm_failed = 0;        // requests that gave no evidence because they failed
+        for (size_t i = 0; i < ranked.size(); ++i) {
+            if (to_llm[i]) llm_rows.push_back(i);
+        }
+        if (!llm_rows.empty()) {
+            hit_llm.resize(ranked.size());
+            std::vector<std::string> hit_ids;
+            for (size_t i : llm_rows) hit_ids.push_back(ranked[i].job_id);
+            const auto t0 = std::chrono::steady_clock::now();
+            const size_t failed0 = llm_recorder.failed_requests();
+            llm::analyze_postings(
+                llm_recorder, hit_ids, llm_concurrency,
+                [&](size_t j) {
+                    auto pi = find_posting(hit_ids[j]);
+                    std::string buf;
+                    return pi ? llm_shrinker.shrink(posting_text(*pi, buf)) : std::string();
+                },
+                [&](size_t j, std::vector<llm::EvidenceSpan>& ev) {
+                    hit_llm[llm_rows[j]] = mentions_from_evidence(hit_ids[j], ev);
+                });
+            llm_stage_sec += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            llm_failed = llm_recorder.failed_requests() - failed0;
+        }
 
-                    Mention m;
-                    m.posting_id = post_id;
-                    m.category   = "";
-                    m.raw        = sh.raw;
-                    m.canonical  = canon;
+        // best mention per (posting, skill), in rank order
+        std::vector<Mention> all_mentions;
+        all_mentions.reserve(ranked.size() * 32);
+        std::vector<size_t> selected;
+
+        for (size_t i = 0; i < ranked.size(); ++i) {
+            const auto& rh = ranked[i];
+            auto pi = find_posting(rh.job_id);
+            if (!pi) continue;
+
+            pr << "\n# hit " << rh.job_id
+               << " combined=" << rh.combined
+               << " emb=" << rh.emb_score
+               << " header=" << rh.lex_score
+               << " TITLE=" << rh.s_title
+               << " LEAD=" << rh.s_lead
+               << " REQ=" << rh.s_req
+               << " ID_MATCH=" << (rh.identity_match ? "yes" : "no");
+
+            if (wants_cpp) pr << " TITLE_CONFLICT=" << (rh.title_conflict ? "yes" : "no");
+            pr << "\n";
+
+            const std::string& post_id = rh.job_id;
+
+            std::vector<Mention> pm;
+            if (use_mstore) {
+                pm = mstore.mentions(hit_rows[i]);
+                selected.push_back(hit_rows[i]);
+            } else if (to_llm[i]) {
+                pm = std::move(hit_llm[i]);
+            } else if (!use_llm || llm_hybrid) {
+                pm = mentions_from_reqs(post_id, hit_reqs[i]);
+            }
 
-                    m.strength   = st;
-                    m.polarity   = pol;
-                    m.confidence = sh.confidence;
-                    m.contrib    = sw * stw * m.confidence;
+            if (!hit_conf.empty()) {
+                pr << "EXTRACT_PATH: " << (to_llm[i] ? "llm" : "extractor") << " confidence=" << hit_conf[i] << "\n";
+            }
+            if (!use_llm || (llm_hybrid && !to_llm[i])) {
+                if (use_mstore) print_reqs(pr, post_id, reqs_from_mentions(pm));
+                else print_reqs(pr, post_id, hit_reqs[i]);
+            }
 
-                    auto& mp = best_by_posting[m.posting_id];
-                    auto it2 = mp.find(m.canonical);
-                    if (it2 == mp.end() || m.contrib > it2->second.contrib) mp[m.canonical] = m;
-                }
+            if (!do_profile) continue;
+            for (auto& m : pm) {
+                if (m.best) all_mentions.push_back(std::move(m));
             }
         }
-    }
 
-    if (do_profile) {
-        for (auto& pkv : best_by_posting) {
-            for (auto& skv : pkv.second) all_mentions.push_back(skv.second);
+        if (!hit_conf.empty()) {
+            pr << "\nHYBRID: extractor=" << (ranked.size() - llm_rows.size()) << " llm=" << llm_rows.size()
+               << " (min_confidence " << llm_min_confidence << ")\n";
         }
 
-        for (const auto& m : all_mentions) {
-            if (m.polarity == "negated") continue;
-            auto& a = agg[m.canonical];
-            a.raw_count += 1;
-            a.sum_contrib += m.contrib;
-            if (a.evidence.size() < 3) a.evidence.push_back(m.raw);
-        }
+        if (!do_profile) return;
+
+        const std::vector<SkillTotal> totals =
+            use_mstore ? mstore.aggregate(selected) : aggregate_mentions(all_mentions);
 
         const int N = (int)ranked.size();
 
         std::vector<std::pair<std::string, double>> weights;
-        weights.reserve(agg.size());
+        weights.reserve(totals.size());
 
         std::vector<std::string> core, secondary, nice;
 
-        for (const auto& kv : agg) {
-            const std::string& skill = kv.first;
-            const SkillAgg& a = kv.second;
+        for (const auto& a : totals) {
+            const std::string& skill = a.skill;
 
-            double freq = (N > 0) ? ((double)a.raw_count / (double)N) : 0.0;
-            double avg_contrib = (a.raw_count > 0) ? (a.sum_contrib / (double)a.raw_count) : 0.0;
+            double freq = (N > 0) ? ((double)a.count / (double)N) : 0.0;
+            double avg_contrib = (a.count > 0) ? (a.sum_contrib / (double)a.count) : 0.0;
 
             double w = 0.7 * freq + 0.3 * avg_contrib;
             weights.push_back({skill, w});
@@ -1044,22 +799,59 @@ int cmd_analyze(int argc, char** argv) {
 
         }
 
-        std::sort(weights.begin(), weights.end(),
-                  [](const auto& a, const auto& b){ return a.second > b.second; });
+        std::stable_sort(weights.begin(), weights.end(),
+                         [](const auto& a, const auto& b){ return a.second > b.second; });
 
         auto sort_alpha = [](std::vector<std::string>& v) { std::sort(v.begin(), v.end()); };
         sort_alpha(core);
         sort_alpha(secondary);
         sort_alpha(nice);
 
-        fs::path mentions_path = outdir / "mentions.jsonl";
-        fs::path profile_path  = outdir / "profile.json";
+        fs::path mentions_path = role_outdir / "mentions.jsonl";
+        fs::path profile_path  = role_outdir / "profile.json";
 
         write_mentions_jsonl(mentions_path, all_mentions);
-        write_profile_json(profile_path, role, (int)ranked.size(), weights, core, secondary, nice, agg);
+        write_profile_json(profile_path, role_name, (int)ranked.size(), weights, core, secondary, nice, totals);
 
         pr << "\nwrote " << mentions_path.string() << "\n";
         pr << "wrote " << profile_path.string() << "\n";
+
+        // a profile missing evidence from failed requests would be served forever
+        if (pcache.enabled() && llm_failed > 0) {
+            pr << "PROFILE_CACHE: not stored (" << llm_failed << " LLM requests failed)\n";
+        } else if (pcache.enabled() && pcache.store(role_keys[ri], role_outdir, role_pkeys[ri])) {
+            pr << "PROFILE_CACHE: stored " << role_keys[ri] << "\n";
+        }
+    };
+
+    if (!multi) {
+        profile_role(0, role, role_tokens[0], *role_ranked[0], outdir);
+    } else {
+        for (size_t r = 0; r < roles.size(); ++r) {
+            pr << "\n== ROLE: " << roles[r] << "\n";
+            if (role_cached[r]) {
+                print_cache_hit(r);
+                continue;
+            }
+            pr << role_logs[r].str();
+            if (!role_ranked[r]) continue;
+
+            if (do_profile && !ensure_dir(role_outdirs[r])) {
+                std::cerr << "error: failed to create " << role_outdirs[r].string() << "\n";
+                return 1;
+            }
+            profile_role(r, roles[r], role_tokens[r], *role_ranked[r], role_outdirs[r]);
+        }
+    }
+
+    if (llm_client == &ollama_llm) {
+        pr << "\nLLM_REQUESTS: " << ollama_llm.requests() << " prompt_tokens~" << ollama_llm.prompt_tokens() << "\n";
+    }
+    if (const llm::LatencyReport lr = llm_recorder.latency_report(); lr.postings > 0) {
+        pr << "LLM_LATENCY: requests=" << lr.requests << " postings=" << lr.postings << " cache_hits=" << lr.cache_hits
+           << " p50=" << lr.p50 << "ms p95=" << lr.p95 << "ms p99=" << lr.p99 << "ms ttfb_p50=" << lr.ttfb_p50 << "ms\n";
+        pr << "LLM_THROUGHPUT: " << (llm_stage_sec > 0.0 ? (double)lr.postings / llm_stage_sec : 0.0)
+           << " postings/s over " << llm_stage_sec << "s\n";
     }
 
     if (write_out) {
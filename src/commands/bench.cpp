@@ -0,0 +1,201 @@
+#include "commands/bench.hpp"
+#include "jobs/CorpusIndex.hpp"
+#include "jobs/JobCorpus.hpp"
+#include "jobs/RequirementExtractor.hpp"
+#include "jobs/Rerank.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+static std::string get_arg(int argc, char** argv, const std::string& key, const std::string& def) {
+    for (int i = 0; i + 1 < argc; ++i) {
+        if (argv[i] == key) return argv[i + 1];
+    }
+    return def;
+}
+
+// base dictionary (if any) + n skills that never occur in postings, to show lexicon
+// size does not change per-posting cost
+static bool write_padded_dictionary(const std::string& base, size_t n, const fs::path& out_path) {
+    std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    if (!base.empty()) {
+        std::ifstream in(base, std::ios::binary);
+        if (!in) return false;
+        out << in.rdbuf() << "\n";
+    }
+    for (size_t i = 0; i < n; ++i) {
+        out << "synthetic\tSynthetic " << i << "\tzzskill" << i << " kit\tzzskill" << i << "\n";
+    }
+    return (bool)out;
+}
+
+static int bench_extract(int argc, char** argv) {
+    std::string jobs_dir    = get_arg(argc, argv, "--jobs", "data/jobs/sample500");
+    std::string skills_path = get_arg(argc, argv, "--skills", "");
+    std::string synth_s     = get_arg(argc, argv, "--synthetic_skills", "0");
+    std::string iters_s     = get_arg(argc, argv, "--iters", "5");
+
+    size_t synth = 0, iters = 0;
+    try {
+        synth = (size_t)std::stoul(synth_s);
+        iters = (size_t)std::stoul(iters_s);
+    } catch (...) {
+        std::cerr << "error: invalid --synthetic_skills / --iters\n";
+        return 1;
+    }
+    if (iters == 0) iters = 1;
+
+    JobCorpus corpus = JobCorpus::load_from_dir(jobs_dir);
+    size_t bytes = 0;
+    for (const auto& p : corpus.postings()) bytes += p.raw_text.size();
+
+    RequirementExtractor ex;
+
+    std::string dict = skills_path;
+    if (synth > 0) {
+        fs::path tmp = fs::temp_directory_path() / "resume_agent_bench_skills.tsv";
+        if (!write_padded_dictionary(skills_path, synth, tmp)) {
+            std::cerr << "error: failed to write padded dictionary" << (skills_path.empty() ? "" : " from " + skills_path) << "\n";
+            return 1;
+        }
+        dict = tmp.string();
+    }
+    if (!dict.empty() && !ex.load_dictionary(dict)) {
+        std::cerr << "error: failed to load skill dictionary: " << dict << "\n";
+        return 1;
+    }
+
+    // warm-up pass doubles as the result checksum
+    size_t skills_found = 0;
+    for (const auto& p : corpus.postings()) {
+        auto r = ex.extract(p.raw_text);
+        for (const auto& [cat, items] : r.by_category) skills_found += items.size();
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t it = 0; it < iters; ++it) {
+        for (const auto& p : corpus.postings()) (void)ex.extract(p.raw_text);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    const double sec = std::chrono::duration<double>(t1 - t0).count() / (double)iters;
+    const double n = (double)corpus.postings().size();
+
+    std::cout << "BENCH: extract\n";
+    std::cout << "JOBS_DIR: " << jobs_dir << "\n";
+    std::cout << "POSTINGS: " << corpus.postings().size() << " (" << bytes << " bytes)\n";
+    std::cout << "DICTIONARY: " << (dict.empty() ? "built-in" : dict) << " (" << ex.dictionary_size() << " phrases)\n";
+    std::cout << "SKILLS_FOUND: " << skills_found << "\n";
+    std::cout << "ITERS: " << iters << "\n";
+    std::cout << "MS_PER_PASS: " << sec * 1000.0 << "\n";
+    std::cout << "POSTINGS_PER_SEC: " << (sec > 0 ? n / sec : 0.0) << "\n";
+    std::cout << "MB_PER_SEC: " << (sec > 0 ? (double)bytes / (1024.0 * 1024.0) / sec : 0.0) << "\n";
+    return 0;
+}
+
+// analyze's rerank stage over every posting, repeated up to --candidates rows
+static int bench_rerank(int argc, char** argv) {
+    std::string jobs_dir = get_arg(argc, argv, "--jobs", "data/jobs/sample500");
+    std::string role     = get_arg(argc, argv, "--role", "C++ Backend Engineer");
+    std::string cands_s  = get_arg(argc, argv, "--candidates", "10000");
+    std::string iters_s  = get_arg(argc, argv, "--iters", "20");
+
+    size_t cands = 0, iters = 0;
+    try {
+        cands = (size_t)std::stoul(cands_s);
+        iters = (size_t)std::stoul(iters_s);
+    } catch (...) {
+        std::cerr << "error: invalid --candidates / --iters\n";
+        return 1;
+    }
+    if (iters == 0) iters = 1;
+
+    JobCorpus corpus = JobCorpus::load_from_dir(jobs_dir);
+    const size_t M = corpus.postings().size();
+    if (M == 0) {
+        std::cerr << "error: no postings in " << jobs_dir << "\n";
+        return 1;
+    }
+
+    textutil::PostingTokenSets body;
+    std::vector<PostingFeatures> feats;
+    feats.reserve(M);
+    for (const auto& p : corpus.postings()) {
+        body.add(body_token_ids(p.raw_text));
+        feats.push_back(compute_posting_features(p.raw_text));
+    }
+
+    std::vector<uint32_t> df(textutil::SymbolTable::global().size(), 0);
+    for (size_t i = 0; i < M; ++i) {
+        for (textutil::TokenId t : body.at(i)) df[t] += 1;
+    }
+
+    const std::vector<textutil::TokenId> q = zone_token_ids(role);
+
+    std::vector<double> idf(textutil::SymbolTable::global().size());
+    for (size_t t = 0; t < idf.size(); ++t) {
+        const uint32_t d = (t < df.size()) ? df[t] : 0;
+        idf[t] = std::log((1.0 + (double)M) / (1.0 + (double)d));
+    }
+
+    // seed tokens the way analyze does: highest tf*idf over the first 10 postings
+    std::unordered_map<textutil::TokenId, int> tf;
+    for (size_t i = 0; i < std::min<size_t>(10, M); ++i) {
+        for (textutil::TokenId t : body.at(i)) tf[t] += 1;
+    }
+    std::vector<std::pair<double, textutil::TokenId>> seed;
+    for (const auto& [t, c] : tf) seed.push_back({(double)c * idf[t], t});
+    std::sort(seed.begin(), seed.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    if (seed.size() > 40) seed.resize(40);
+    std::vector<textutil::TokenId> top;
+    for (const auto& st : seed) top.push_back(st.second);
+
+    RerankColumns cols;
+    for (size_t i = 0; i < cands; ++i) {
+        const size_t pi = i % M;
+        const PostingFeatures& f = feats[pi];
+        cols.push(body.at(pi), f.title_toks, f.lead_toks, f.req_toks, !f.title.empty(), 0.5f);
+    }
+
+    const RerankScorer scorer(q, top, idf, RerankWeights{});
+
+    // warm-up pass doubles as the result checksum
+    scorer.score(cols);
+    double checksum = 0.0;
+    for (double c : cols.combined) checksum += c;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t it = 0; it < iters; ++it) scorer.score(cols);
+    auto t1 = std::chrono::steady_clock::now();
+
+    const double sec = std::chrono::duration<double>(t1 - t0).count() / (double)iters;
+
+    std::cout << "BENCH: rerank\n";
+    std::cout << "JOBS_DIR: " << jobs_dir << "\n";
+    std::cout << "ROLE: " << role << "\n";
+    std::cout << "CANDIDATES: " << cols.size() << " (from " << M << " postings)\n";
+    std::cout << "CHECKSUM: " << checksum << "\n";
+    std::cout << "ITERS: " << iters << "\n";
+    std::cout << "MS_PER_PASS: " << sec * 1000.0 << "\n";
+    std::cout << "CANDIDATES_PER_SEC: " << (sec > 0 ? (double)cols.size() / sec : 0.0) << "\n";
+    return 0;
+}
+
+int cmd_bench(int argc, char** argv) {
+    const std::string what = (argc >= 2) ? argv[1] : "";
+    if (what == "extract") return bench_extract(argc - 1, argv + 1);
+    if (what == "rerank") return bench_rerank(argc - 1, argv + 1);
+
+    std::cerr << "error: unknown benchmark (expected: extract, rerank)\n";
+    return 1;
+}
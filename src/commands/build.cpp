@@ -138,7 +138,7 @@ static resume::RoleProfileLite parse_profile(const nlohmann::json& j) {
     if (j.contains("skill_weights") && j["skill_weights"].is_object()) {
         for (auto it = j["skill_weights"].begin(); it != j["skill_weights"].end(); ++it) {
             const std::string key = normalize_key(it.key());
-            if (it.value().is_number()) p.skill_weights[key] = it.value().get<double>();
+            if (it.value().is_number()) p.skill_weights[textutil::intern(key)] = it.value().get<double>();
         }
     }
 
@@ -186,6 +186,7 @@ int cmd_build(int argc, char** argv) {
 
         // semantic matcher (optional)
         std::unique_ptr<resume::SemanticMatcher> matcher;
+        resume::SemanticIndexStats sem_stats;
         MiniLmEmbedder embedder;
 
         if (semantic) {
@@ -200,8 +201,10 @@ int cmd_build(int argc, char** argv) {
             mcfg.threshold = static_cast<float>(score_cfg.semantic_threshold);
             mcfg.topk = (semantic_topk_i <= 0) ? 1u : static_cast<size_t>(semantic_topk_i);
             mcfg.cache_path = semantic_cache;
+            mcfg.model_path = emb_model;
+            mcfg.vocab_path = emb_vocab;
 
-            matcher = resume::build_profile_semantic_matcher(profile.skill_weights, embedder, mcfg);
+            matcher = resume::build_profile_semantic_matcher(profile.skill_weights, embedder, mcfg, &sem_stats);
         }
 
         // score bullets
@@ -237,6 +240,8 @@ int cmd_build(int argc, char** argv) {
             std::cout << "SEM_THRESHOLD: " << score_cfg.semantic_threshold << "\n";
             std::cout << "SEM_TOPK: " << semantic_topk_i << "\n";
             if (!semantic_cache.empty()) std::cout << "SEM_CACHE: " << semantic_cache << "\n";
+            std::cout << "SEM_INDEX: skills=" << sem_stats.skills << " reused=" << sem_stats.reused
+                      << " embedded=" << sem_stats.embedded << (sem_stats.cache_written ? " (cache updated)" : "") << "\n";
         }
 
         if (scores_only) return 0;
@@ -0,0 +1,347 @@
+#include "commands/check.hpp"
+#include "jobs/PostingShrinker.hpp"
+#include "llm/HttpClient.hpp"
+#include "llm/ProcUtil.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string get_arg(int argc, char** argv, const std::string& key, const std::string& def) {
+    for (int i = 0; i + 1 < argc; ++i) {
+        if (argv[i] == key) return argv[i + 1];
+    }
+    return def;
+}
+
+// counts failed cases; prints "ok <name>" or "FAIL <name>: <why>"
+struct Checker {
+    size_t failed = 0;
+
+    void expect(bool cond, const std::string& name, const std::string& why) {
+        if (cond) {
+            std::cout << "  ok " << name << "\n";
+        } else {
+            ++failed;
+            std::cout << "  FAIL " << name << ": " << why << "\n";
+        }
+    }
+
+    int finish() const {
+        std::cout << "RESULT: " << (failed ? "FAIL (" + std::to_string(failed) + ")" : std::string("ok")) << "\n";
+        return failed ? 1 : 0;
+    }
+};
+
+static bool contains(const std::string& s, const std::string& what) {
+    return s.find(what) != std::string::npos;
+}
+
+// PostingShrinker on a flattened (one-line) and a multi-line posting: the requirements
+// must survive a tight budget, ahead of the company blurb and the benefits
+static int check_shrink(int argc, char** argv) {
+    const std::string posting_path = get_arg(argc, argv, "--posting", "");
+    const std::string budget_s = get_arg(argc, argv, "--budget", "300");
+    const std::string vocab = get_arg(argc, argv, "--vocab", "");
+
+    size_t budget = 0;
+    try {
+        budget = (size_t)std::stoul(budget_s);
+    } catch (...) {
+        std::cerr << "error: invalid --budget\n";
+        return 1;
+    }
+
+    std::cout << "CHECK: shrink\n";
+    Checker c;
+
+    std::string blurb;
+    for (int i = 0; i < 12; ++i) {
+        blurb += "Our venture backed marketplace gives investors the access, tools and knowledge they need. ";
+    }
+    const std::string title = "Senior Backend Engineer (C++) Los Angeles";
+    const std::string reqs = "Requirements: 5+ years of modern C++ on Linux, strong networking and concurrency.";
+    const std::string perks = "Benefits: hot buffet lunches, unlimited vacation and a generous 401k match.";
+
+    const PostingShrinker small(60);
+
+    const std::string one_line = title + " " + blurb + reqs + " " + perks;
+    const std::string a = small.shrink(one_line);
+    c.expect(a.rfind(title, 0) == 0, "one-line keeps title", "got: " + a.substr(0, 80));
+    c.expect(contains(a, reqs), "one-line keeps requirements", "got: " + a);
+    c.expect(!contains(a, "Benefits"), "one-line drops benefits", "got: " + a);
+    c.expect(small.count_tokens(a) <= small.token_budget(), "one-line fits budget",
+             std::to_string(small.count_tokens(a)) + " tokens");
+
+    const std::string multi = title + "\nAbout us\n" + blurb + "\n" + reqs + "\n" + perks + "\n";
+    const std::string b = small.shrink(multi);
+    c.expect(b.rfind(title, 0) == 0, "multi-line keeps title", "got: " + b.substr(0, 80));
+    c.expect(contains(b, reqs), "multi-line keeps requirements", "got: " + b);
+
+    const std::string short_posting = title + "\n" + reqs + "\n";
+    c.expect(small.shrink(short_posting) == short_posting, "fitting posting unchanged", "it was shrunk");
+
+    // flattened the way data/jobs/raw postings are: one line, sections inline
+    const std::string edn = "{:crawled true, :title " + title + ", :description " + title + " " + blurb + reqs + " " +
+                            perks + "}";
+    const std::string d = small.shrink(edn);
+    c.expect(contains(d, ":title " + title), "flattened keeps title", "got: " + d.substr(0, 80));
+    c.expect(contains(d, reqs), "flattened keeps requirements", "got: " + d);
+
+    // a real posting, e.g. --posting data/jobs/raw/file_03.txt, printed for a look
+    if (!posting_path.empty()) {
+        std::ifstream in(posting_path, std::ios::binary);
+        if (!in) {
+            std::cerr << "error: cannot read --posting: " << posting_path << "\n";
+            return 1;
+        }
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        const std::string raw = ss.str();
+
+        const PostingShrinker sh = vocab.empty() ? PostingShrinker(budget) : PostingShrinker::with_vocab(vocab, budget);
+        const std::string out = sh.shrink(raw);
+        std::cout << "POSTING: " << posting_path << " (" << sh.count_tokens(raw) << " -> " << sh.count_tokens(out)
+                  << " tokens)\n"
+                  << out << "\n";
+        // pieces are counted one by one; the separators joining them are not
+        c.expect(sh.count_tokens(out) <= budget + budget / 20, "posting fits budget",
+                 std::to_string(sh.count_tokens(out)) + " tokens");
+    }
+    return c.finish();
+}
+
+// shell snippets for check_proc; each platform's shell runs its own
+struct ProcScripts {
+    std::vector<std::string> shell; // argv prefix that runs one command line
+    std::string out_err_exit3;      // "out" to stdout, "err" to stderr, exit code 3
+    std::string flood;              // ~1 MB to stdout and to stderr
+    std::string slow;               // runs for ~5 s
+    std::string tick;               // a short pause (under a second), then "tick"
+    std::string two_lines;          // "a" and "b", for run_capture_stdout
+};
+
+static ProcScripts proc_scripts() {
+#ifdef _WIN32
+    return {{"cmd.exe", "/S", "/C"},
+            "echo out& echo err 1>&2& exit 3",
+            "for /L %i in (1,1,16000) do @(echo 0123456789012345678901234567890123456789012345678901234567890& "
+            "echo 0123456789012345678901234567890123456789012345678901234567890 1>&2)",
+            "ping -n 6 127.0.0.1 >NUL",
+            "ping -n 2 -w 500 127.0.0.1 >NUL& echo tick",
+            "echo a&& echo b"};
+#else
+    return {{"/bin/sh", "-c"},
+            "echo out; echo err >&2; exit 3",
+            "head -c 1000000 /dev/zero; head -c 1000000 /dev/zero >&2",
+            "sleep 5",
+            "sleep 0.5; echo tick",
+            "echo a && echo b"};
+#endif
+}
+
+static std::string strip_ws(const std::string& s) {
+    std::string out;
+    for (char ch : s) {
+        if (ch != '\r' && ch != '\n' && ch != ' ') out += ch;
+    }
+    return out;
+}
+
+// procutil: exit codes, separate and merged streams, large output on both pipes, output
+// caps, timeouts, a missing program, concurrent run_async, run_capture_stdout
+static int check_proc(int, char**) {
+    using Clock = std::chrono::steady_clock;
+    auto secs_since = [](Clock::time_point t0) { return std::chrono::duration<double>(Clock::now() - t0).count(); };
+
+    const ProcScripts ps = proc_scripts();
+    auto shell = [&](const std::string& script) {
+        std::vector<std::string> argv = ps.shell;
+        argv.push_back(script);
+        return argv;
+    };
+
+    std::cout << "CHECK: proc\n";
+    Checker c;
+
+    procutil::RunResult r = procutil::run(shell(ps.out_err_exit3));
+    c.expect(r.started && r.exit_code == 3, "run exit code", "started=" + std::to_string(r.started) +
+             " exit=" + std::to_string(r.exit_code) + " " + r.error);
+    c.expect(strip_ws(r.out) == "out" && strip_ws(r.err) == "err", "run separate streams",
+             "out=\"" + r.out + "\" err=\"" + r.err + "\"");
+
+    procutil::RunOptions merged;
+    merged.merge_stderr = true;
+    r = procutil::run(shell(ps.out_err_exit3), merged);
+    c.expect(contains(r.out, "out") && contains(r.out, "err") && r.err.empty(), "run merged stderr",
+             "out=\"" + r.out + "\" err=\"" + r.err + "\"");
+
+    // a child filling both pipes must not stall
+    procutil::RunOptions big;
+    big.timeout_ms = 60000;
+    r = procutil::run(shell(ps.flood), big);
+    c.expect(!r.timed_out && r.out.size() >= 1000000 && r.err.size() >= 1000000 && !r.truncated, "run large output",
+             std::to_string(r.out.size()) + "/" + std::to_string(r.err.size()) + " bytes" +
+             (r.timed_out ? ", timed out" : ""));
+
+    procutil::RunOptions capped = big;
+    capped.max_output = 1000;
+    r = procutil::run(shell(ps.flood), capped);
+    c.expect(r.truncated && r.out.size() == 1000 && r.err.size() == 1000 && r.exit_code == 0, "run output cap",
+             std::to_string(r.out.size()) + "/" + std::to_string(r.err.size()) + " bytes");
+
+    procutil::RunOptions quick;
+    quick.timeout_ms = 300;
+    auto t0 = Clock::now();
+    r = procutil::run(shell(ps.slow), quick);
+    const double waited = secs_since(t0);
+    c.expect(r.timed_out && waited < 3.0, "run timeout", std::to_string(waited) + " s");
+
+    r = procutil::run({"resume-agent-no-such-program"});
+    c.expect(!r.started && !r.error.empty(), "run missing program", "started=" + std::to_string(r.started));
+
+    // four at once take about as long as one
+    t0 = Clock::now();
+    std::vector<std::future<procutil::RunResult>> runs;
+    for (int i = 0; i < 4; ++i) runs.push_back(procutil::run_async(shell(ps.tick)));
+    bool all_ticked = true;
+    for (auto& f : runs) all_ticked = strip_ws(f.get().out) == "tick" && all_ticked;
+    const double together = secs_since(t0);
+    c.expect(all_ticked, "run_async results", "a run did not print tick");
+    c.expect(together < 1.8, "run_async concurrent", std::to_string(together) + " s for 4 runs");
+
+    const std::string two = procutil::run_capture_stdout(ps.two_lines, 10000);
+    c.expect(strip_ws(two) == "ab", "run_capture_stdout shell", "got \"" + two + "\"");
+    t0 = Clock::now();
+    const std::string none = procutil::run_capture_stdout(ps.slow, 300);
+    c.expect(none.empty() && secs_since(t0) < 3.0, "run_capture_stdout timeout", "got \"" + none + "\"");
+
+    return c.finish();
+}
+
+// llm::HttpClient against ollama_standin.py: keep-alive reuse, chunked streaming,
+// reconnecting after the server dropped the connection, read timeouts. Endpoint
+// parsing (including bracketed IPv6 hosts) is checked without a server.
+static int check_http(int argc, char** argv) {
+    const std::string endpoint = get_arg(argc, argv, "--host", "127.0.0.1:11435");
+
+    using Clock = std::chrono::steady_clock;
+    auto secs_since = [](Clock::time_point t0) { return std::chrono::duration<double>(Clock::now() - t0).count(); };
+
+    std::cout << "CHECK: http\n";
+    Checker c;
+
+    struct EndpointCase {
+        const char* in;
+        bool ok;
+        const char* host;
+        uint16_t port;
+    };
+    const EndpointCase cases[] = {
+        {"127.0.0.1:11434", true, "127.0.0.1", 11434},
+        {"http://localhost:8080/", true, "localhost", 8080},
+        {"localhost", true, "localhost", 11434},
+        {"[::1]:11434", true, "::1", 11434},
+        {"http://[::1]:8080/api", true, "::1", 8080},
+        {"[::1]", true, "::1", 11434},
+        {"::1", true, "::1", 11434},
+        {"[::1", false, "", 0},
+        {"[::1]x", false, "", 0},
+        {"localhost:", false, "", 0},
+        {"localhost:99999", false, "", 0},
+    };
+    for (const EndpointCase& ec : cases) {
+        std::string h;
+        uint16_t p = 0;
+        const bool ok = llm::parse_http_endpoint(ec.in, 11434, h, p);
+        c.expect(ok == ec.ok && (!ok || (h == ec.host && p == ec.port)), std::string("endpoint ") + ec.in,
+                 ok ? "got host \"" + h + "\" port " + std::to_string(p) : "rejected");
+    }
+
+    std::string host;
+    uint16_t port = 0;
+    if (!llm::parse_http_endpoint(endpoint, 11435, host, port)) {
+        std::cerr << "error: invalid --host: " << endpoint << "\n";
+        return 1;
+    }
+    const std::string host_header = (host.find(':') != std::string::npos ? "[" + host + "]" : host) + ":" +
+                                    std::to_string(port);
+
+    llm::HttpClient http(host, port);
+    llm::HttpResponse r;
+    if (!http.get("/api/version", r)) {
+        c.expect(false, "server reachable", http.last_error() + " (start: python ollama_standin.py)");
+        return c.finish();
+    }
+    c.expect(r.status == 200 && contains(r.body, "\"" + host_header + "\""), "host header",
+             std::to_string(r.status) + " " + r.body);
+
+    bool all_ok = true;
+    for (int i = 0; i < 3; ++i) all_ok = http.get("/api/version", r) && r.status == 200 && all_ok;
+    c.expect(all_ok && http.connects() == 1, "keep-alive reuse",
+             std::to_string(http.connects()) + " connections for 4 requests");
+
+    const std::string req = "{\"model\":\"standin\",\"prompt\":\"skills?\",\"stream\":false}";
+    const bool whole_ok = http.post("/api/generate", "application/json", req, r);
+    const std::string whole = r.body;
+    c.expect(whole_ok && r.status == 200 && contains(whole, "networking"), "whole body",
+             std::to_string(r.status) + " " + whole + " " + http.last_error());
+
+    std::string streamed;
+    size_t pieces = 0;
+    const std::string stream_req = "{\"model\":\"standin\",\"prompt\":\"skills?\",\"stream\":true}";
+    const bool chunked_ok = http.post_stream("/api/generate", "application/json", stream_req,
+                                             [&](const char* p, size_t n) {
+                                                 streamed.append(p, n);
+                                                 ++pieces;
+                                                 return true;
+                                             },
+                                             r);
+    c.expect(chunked_ok && r.status == 200 && !r.stopped && contains(streamed, "\"done\": true") && pieces > 1,
+             "chunked stream", std::to_string(pieces) + " pieces: " + streamed + " " + http.last_error());
+    c.expect(http.get("/api/version", r) && http.connects() == 1, "keep-alive after chunked",
+             std::to_string(http.connects()) + " connections");
+
+    // a sink that stops early closes the connection; the next request opens another
+    size_t seen = 0;
+    const bool stop_ok = http.post_stream("/api/generate", "application/json", stream_req,
+                                          [&](const char*, size_t) { return ++seen < 1; }, r);
+    c.expect(stop_ok && r.stopped, "stream stopped by sink", "stopped=" + std::to_string(r.stopped));
+    c.expect(http.get("/api/version", r) && r.status == 200 && http.connects() == 2, "reconnect after stop",
+             std::to_string(http.connects()) + " connections " + http.last_error());
+
+    // the server closes the connection without Connection: close; the stale socket
+    // fails on the next request, which is retried on a fresh one
+    const bool drop_ok = http.get("/drop", r);
+    c.expect(drop_ok && r.status == 200, "dropped request answered", http.last_error());
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    c.expect(http.get("/api/version", r) && r.status == 200 && http.connects() == 3, "reconnect after drop",
+             std::to_string(http.connects()) + " connections " + http.last_error());
+
+    llm::HttpOptions impatient;
+    impatient.read_timeout_ms = 300;
+    llm::HttpClient quick(host, port, impatient);
+    const auto t0 = Clock::now();
+    const bool slow_ok = quick.get("/slow?ms=3000", r);
+    const double waited = secs_since(t0);
+    c.expect(!slow_ok && waited < 2.0 && !quick.last_error().empty(), "read timeout",
+             std::to_string(waited) + " s, error \"" + quick.last_error() + "\"");
+    c.expect(quick.get("/api/version", r) && r.status == 200, "usable after timeout", quick.last_error());
+
+    return c.finish();
+}
+
+int cmd_check(int argc, char** argv) {
+    const std::string what = (argc >= 2) ? argv[1] : "";
+    if (what == "shrink") return check_shrink(argc - 1, argv + 1);
+    if (what == "proc") return check_proc(argc - 1, argv + 1);
+    if (what == "http") return check_http(argc - 1, argv + 1);
+
+    std::cerr << "error: unknown check (expected: shrink, proc, http)\n";
+    return 1;
+}
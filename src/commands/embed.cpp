@@ -1,10 +1,18 @@
 #include "commands/embed.hpp"
+#include "jobs/CorpusIndex.hpp"
 #include "jobs/JobCorpus.hpp"
 #include "jobs/EmbeddingIndex.hpp"
 #include "emb/MiniLmEmbedder.hpp"
 #include <iostream>
 #include <string>
 
+static bool has_flag(int argc, char** argv, const std::string& key) {
+    for (int i = 0; i < argc; ++i) {
+        if (std::string(argv[i]) == key) return true;
+    }
+    return false;
+}
+
 static std::string get_arg(int argc, char** argv, const std::string& key, const std::string& def) {
     for (int i = 0; i + 1 < argc; ++i) {
         if (argv[i] == key) return argv[i + 1];
@@ -17,9 +25,20 @@ int cmd_embed(int argc, char** argv) {
     std::string model    = get_arg(argc, argv, "--model", "models/emb/model.onnx");
     std::string vocab    = get_arg(argc, argv, "--vocab", "models/emb/vocab.txt");
     std::string outp     = get_arg(argc, argv, "--out", "data/embeddings/jobs.bin");
+    std::string cindex   = get_arg(argc, argv, "--corpus_index", CorpusIndex::default_path(outp));
+    bool index_only      = has_flag(argc, argv, "--index_only");
 
     JobCorpus corpus = JobCorpus::load_from_dir(jobs_dir);
 
+    // tokens/zones/DF sidecar read by analyze
+    if (!CorpusIndex::build_and_save(corpus, jobs_dir, cindex)) {
+        std::cerr << "error: failed to save corpus index to " << cindex << "\n";
+        return 1;
+    }
+    std::cout << "saved: " << cindex << " (postings=" << corpus.postings().size() << ")\n";
+
+    if (index_only) return 0;
+
     MiniLmEmbedder emb;
     if (!emb.init(model, vocab)) {
         std::cerr << "error: failed to init MiniLmEmbedder\n";
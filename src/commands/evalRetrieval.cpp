@@ -0,0 +1,433 @@
+#include "commands/evalRetrieval.hpp"
+#include "emb/MiniLmEmbedder.hpp"
+#include "io/Stats.hpp"
+#include "jobs/CorpusIndex.hpp"
+#include "jobs/EmbeddingIndex.hpp"
+#include "jobs/Retrieval.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static std::string get_arg(int argc, char** argv, const std::string& key, const std::string& def) {
+    for (int i = 0; i + 1 < argc; ++i) {
+        if (argv[i] == key) return argv[i + 1];
+    }
+    return def;
+}
+
+static std::string json_escape(const std::string& s) {
+    std::ostringstream oss;
+    for (char c : s) {
+        switch (c) {
+            case '\\': oss << "\\\\"; break;
+            case '"':  oss << "\\\""; break;
+            case '\n': oss << "\\n"; break;
+            case '\r': oss << "\\r"; break;
+            case '\t': oss << "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20) oss << "?";
+                else oss << c;
+        }
+    }
+    return oss.str();
+}
+
+static std::string trim(const std::string& s) {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos) return "";
+    size_t b = s.find_last_not_of(" \t\r\n");
+    return s.substr(a, b - a + 1);
+}
+
+struct Labelled {
+    std::string role;
+    std::vector<std::string> relevant; // unique, in file order
+};
+
+// role<TAB>id id,id ...; a role may span several lines; blank lines and '#' comments skipped
+static bool read_labels_file(const fs::path& path, std::vector<Labelled>& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        const std::string t = trim(line);
+        if (t.empty() || t[0] == '#') continue;
+
+        const size_t tab = t.find('\t');
+        const std::string role = trim(t.substr(0, tab));
+        if (role.empty()) continue;
+
+        auto it = std::find_if(out.begin(), out.end(), [&](const Labelled& l) { return l.role == role; });
+        if (it == out.end()) {
+            out.push_back({role, {}});
+            it = out.end() - 1;
+        }
+        if (tab == std::string::npos) continue;
+
+        std::string ids = t.substr(tab + 1);
+        std::replace(ids.begin(), ids.end(), ',', ' ');
+        std::istringstream ss(ids);
+        std::string id;
+        while (ss >> id) {
+            if (std::find(it->relevant.begin(), it->relevant.end(), id) == it->relevant.end()) {
+                it->relevant.push_back(id);
+            }
+        }
+    }
+    return true;
+}
+
+// a file, or every regular file in a directory (name order)
+static bool read_labels(const std::string& path, std::vector<Labelled>& out) {
+    std::error_code ec;
+    if (!fs::is_directory(path, ec)) return read_labels_file(path, out);
+
+    std::vector<fs::path> files;
+    for (fs::directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file()) files.push_back(it->path());
+    }
+    std::sort(files.begin(), files.end());
+    for (const auto& f : files) {
+        if (!read_labels_file(f, out)) return false;
+    }
+    return true;
+}
+
+struct NamedConfig {
+    std::string name;
+    RetrievalConfig cfg;
+};
+
+static bool set_config_value(RetrievalConfig& c, const std::string& key, const std::string& val) {
+    try {
+        if      (key == "bigk_floor")  c.bigk_floor  = (size_t)std::stoul(val);
+        else if (key == "min_score")   c.min_score   = std::stod(val);
+        else if (key == "topn_seed")   c.topn_seed   = (size_t)std::stoul(val);
+        else if (key == "topx_tokens") c.topx_tokens = (size_t)std::stoul(val);
+        else if (key == "title")       c.weights.title      = std::stod(val);
+        else if (key == "lead")        c.weights.lead       = std::stod(val);
+        else if (key == "req")         c.weights.req        = std::stod(val);
+        else if (key == "body_query")  c.weights.body_query = std::stod(val);
+        else if (key == "body_lex")    c.weights.body_lex   = std::stod(val);
+        else if (key == "emb")         c.weights.emb        = std::stod(val);
+        else if (key == "penalty_title_conflict")   c.weights.penalty_title_conflict   = std::stod(val);
+        else if (key == "penalty_missing_identity") c.weights.penalty_missing_identity = std::stod(val);
+        else if (key == "bonus_identity_in_title")  c.weights.bonus_identity_in_title  = std::stod(val);
+        else return false;
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+// the rerank weights under their configs-file keys, for the report
+static std::vector<std::pair<const char*, double>> weight_fields(const RerankWeights& w) {
+    return {{"title", w.title},
+            {"lead", w.lead},
+            {"req", w.req},
+            {"body_query", w.body_query},
+            {"body_lex", w.body_lex},
+            {"emb", w.emb},
+            {"penalty_title_conflict", w.penalty_title_conflict},
+            {"penalty_missing_identity", w.penalty_missing_identity},
+            {"bonus_identity_in_title", w.bonus_identity_in_title}};
+}
+
+// one config per line: name key=value ...; unset keys keep analyze's defaults
+static bool read_configs_file(const std::string& path, const RetrievalConfig& base, std::vector<NamedConfig>& out) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "error: failed to read --configs file: " << path << "\n";
+        return false;
+    }
+
+    std::string line;
+    size_t line_no = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        const std::string t = trim(line);
+        if (t.empty() || t[0] == '#') continue;
+
+        std::istringstream ss(t);
+        NamedConfig nc{"", base};
+        ss >> nc.name;
+
+        std::string kv;
+        while (ss >> kv) {
+            const size_t eq = kv.find('=');
+            if (eq == std::string::npos || !set_config_value(nc.cfg, kv.substr(0, eq), kv.substr(eq + 1))) {
+                std::cerr << "error: " << path << ":" << line_no << ": bad setting: " << kv << "\n";
+                return false;
+            }
+        }
+        out.push_back(std::move(nc));
+    }
+    return true;
+}
+
+// retrieval depth and the rescue threshold around analyze's defaults
+static std::vector<NamedConfig> default_configs(const RetrievalConfig& base) {
+    std::vector<NamedConfig> out;
+    out.push_back({"default", base});
+    for (size_t bigk : {40, 160, 320}) {
+        NamedConfig nc{"bigk_floor=" + std::to_string(bigk), base};
+        nc.cfg.bigk_floor = bigk;
+        out.push_back(nc);
+    }
+    for (const char* ms : {"0.20", "0.40"}) {
+        NamedConfig nc{std::string("min_score=") + ms, base};
+        nc.cfg.min_score = std::stod(ms);
+        out.push_back(nc);
+    }
+    return out;
+}
+
+struct Quality {
+    double recall = 0.0;
+    double ndcg = 0.0;
+    double mrr = 0.0;
+};
+
+// binary relevance over the ranked list (already cut to k)
+static Quality score_ranking(const std::vector<RankedHit>& ranked, const std::unordered_set<std::string>& rel, size_t k) {
+    Quality q;
+    if (rel.empty()) return q;
+
+    size_t found = 0;
+    double dcg = 0.0;
+    for (size_t i = 0; i < ranked.size() && i < k; ++i) {
+        if (!rel.count(ranked[i].job_id)) continue;
+        ++found;
+        dcg += 1.0 / std::log2((double)i + 2.0);
+        if (q.mrr == 0.0) q.mrr = 1.0 / (double)(i + 1);
+    }
+
+    double idcg = 0.0;
+    for (size_t i = 0; i < std::min(k, rel.size()); ++i) idcg += 1.0 / std::log2((double)i + 2.0);
+
+    q.recall = (double)found / (double)rel.size();
+    q.ndcg = idcg > 0.0 ? dcg / idcg : 0.0;
+    return q;
+}
+
+struct ConfigReport {
+    Quality mean;
+    double kept_avg = 0.0;
+    std::vector<double> retrieve_ms, rerank_ms, total_ms;
+};
+
+int cmd_eval_retrieval(int argc, char** argv) {
+    std::string labels_path  = get_arg(argc, argv, "--labels", "");
+    std::string configs_path = get_arg(argc, argv, "--configs", "");
+    std::string jobs_dir     = get_arg(argc, argv, "--jobs", "data/jobs/sample500");
+    std::string emb_path     = get_arg(argc, argv, "--emb", "data/embeddings/jobs.bin");
+    std::string cindex_path  = get_arg(argc, argv, "--corpus_index", CorpusIndex::default_path(emb_path));
+    std::string model        = get_arg(argc, argv, "--model", "models/emb/model.onnx");
+    std::string vocab        = get_arg(argc, argv, "--vocab", "models/emb/vocab.txt");
+    std::string k_s          = get_arg(argc, argv, "--k", "10");
+    std::string min_score_s  = get_arg(argc, argv, "--min_score", "0.30");
+    std::string iters_s      = get_arg(argc, argv, "--iters", "5");
+    std::string out_path     = get_arg(argc, argv, "--out", "");
+
+    if (labels_path.empty()) {
+        std::cerr << "error: missing --labels\n";
+        return 1;
+    }
+
+    size_t k = 0, iters = 0;
+    double min_score = 0.0;
+    try {
+        k = (size_t)std::stoul(k_s);
+        iters = (size_t)std::stoul(iters_s);
+        min_score = std::stod(min_score_s);
+    } catch (...) {
+        std::cerr << "error: invalid --k / --iters / --min_score\n";
+        return 1;
+    }
+    if (k == 0) k = 1;
+    if (iters == 0) iters = 1;
+
+    std::vector<Labelled> labels;
+    if (!read_labels(labels_path, labels)) {
+        std::cerr << "error: failed to read --labels: " << labels_path << "\n";
+        return 1;
+    }
+    labels.erase(std::remove_if(labels.begin(), labels.end(), [](const Labelled& l) { return l.relevant.empty(); }),
+                 labels.end());
+    if (labels.empty()) {
+        std::cerr << "error: no labelled roles in " << labels_path << "\n";
+        return 1;
+    }
+
+    RetrievalConfig base;
+    base.topk = k;
+    base.min_score = min_score;
+
+    std::vector<NamedConfig> configs;
+    if (configs_path.empty()) configs = default_configs(base);
+    else if (!read_configs_file(configs_path, base, configs)) return 1;
+    if (configs.empty()) {
+        std::cerr << "error: no configs in " << configs_path << "\n";
+        return 1;
+    }
+
+    RetrievalCorpus corpus;
+    if (!corpus.load(jobs_dir, cindex_path)) {
+        std::cerr << "error: no postings in --jobs dir: " << jobs_dir << "\n";
+        return 1;
+    }
+
+    EmbeddingIndex idx;
+    if (!idx.load(emb_path)) {
+        std::cerr << "error: failed to load embeddings cache: " << emb_path << "\n";
+        std::cerr << "hint: run `resume-agent embed` first\n";
+        return 1;
+    }
+
+    MiniLmEmbedder emb;
+    if (!emb.init(model, vocab)) {
+        std::cerr << "error: failed to init embedder for query\n";
+        return 1;
+    }
+
+    size_t n_relevant = 0, n_unknown = 0;
+    for (const auto& l : labels) {
+        for (const auto& id : l.relevant) {
+            ++n_relevant;
+            if (!corpus.find(id)) ++n_unknown;
+        }
+    }
+
+    // query side, once per role (same path as a single-role analyze)
+    std::vector<std::vector<float>> queries;
+    std::vector<std::vector<textutil::TokenId>> q_tokens;
+    std::vector<std::unordered_set<std::string>> relevant;
+    std::vector<double> embed_ms;
+    for (const auto& l : labels) {
+        auto t0 = std::chrono::steady_clock::now();
+        queries.push_back(emb.embed(l.role, 64));
+        embed_ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+
+        if (queries.back().size() != idx.dim()) {
+            std::cerr << "error: query embedding dim mismatch\n";
+            return 1;
+        }
+        q_tokens.push_back(zone_token_ids(l.role));
+        relevant.emplace_back(l.relevant.begin(), l.relevant.end());
+    }
+
+    // steady state: zones computed and the IDF table built once, as with analyze --roles
+    corpus.warm_zones();
+    const std::vector<double> idf = corpus.idf_table();
+
+    std::vector<ConfigReport> reports(configs.size());
+    for (size_t c = 0; c < configs.size(); ++c) {
+        ConfigReport& rep = reports[c];
+        for (size_t r = 0; r < labels.size(); ++r) {
+            RetrievalResult res;
+            for (size_t it = 0; it < iters; ++it) {
+                res = retrieve(corpus, idx, queries[r], q_tokens[r], configs[c].cfg, &idf);
+                rep.retrieve_ms.push_back(res.retrieve_ms);
+                rep.rerank_ms.push_back(res.rerank_ms);
+                rep.total_ms.push_back(res.retrieve_ms + res.rerank_ms);
+            }
+
+            const Quality q = score_ranking(res.ranked, relevant[r], k);
+            rep.mean.recall += q.recall;
+            rep.mean.ndcg += q.ndcg;
+            rep.mean.mrr += q.mrr;
+            rep.kept_avg += (double)res.kept;
+        }
+
+        const double n = (double)labels.size();
+        rep.mean.recall /= n;
+        rep.mean.ndcg /= n;
+        rep.mean.mrr /= n;
+        rep.kept_avg /= n;
+    }
+
+    std::cout << "EVAL: retrieval\n";
+    std::cout << "JOBS_DIR: " << jobs_dir << "\n";
+    if (corpus.uses_index()) std::cout << "CORPUS_INDEX: " << cindex_path << "\n";
+    std::cout << "POSTINGS: " << corpus.size() << "\n";
+    std::cout << "LABELS: " << labels_path << " (" << labels.size() << " roles, " << n_relevant << " relevant";
+    if (n_unknown) std::cout << ", " << n_unknown << " not in corpus";
+    std::cout << ")\n";
+    std::cout << "K: " << k << "\n";
+    std::cout << "ITERS: " << iters << "\n";
+    std::cout << "EMBED_MS: p50=" << percentile(embed_ms, 50) << " p99=" << percentile(embed_ms, 99) << "\n";
+
+    for (size_t c = 0; c < configs.size(); ++c) {
+        const RetrievalConfig& cfg = configs[c].cfg;
+        const ConfigReport& rep = reports[c];
+        std::cout << "\nCONFIG: " << configs[c].name
+                  << " (bigk_floor=" << cfg.bigk_floor
+                  << " min_score=" << cfg.min_score
+                  << " topn_seed=" << cfg.topn_seed
+                  << " topx_tokens=" << cfg.topx_tokens;
+        for (const auto& [key, val] : weight_fields(cfg.weights)) std::cout << " " << key << "=" << val;
+        std::cout << ")\n";
+        std::cout << "  recall@" << k << "=" << rep.mean.recall
+                  << " ndcg@" << k << "=" << rep.mean.ndcg
+                  << " mrr=" << rep.mean.mrr
+                  << " kept_avg=" << rep.kept_avg << "\n";
+        std::cout << "  retrieve_ms p50=" << percentile(rep.retrieve_ms, 50) << " p99=" << percentile(rep.retrieve_ms, 99)
+                  << "  rerank_ms p50=" << percentile(rep.rerank_ms, 50) << " p99=" << percentile(rep.rerank_ms, 99)
+                  << "  total_ms p50=" << percentile(rep.total_ms, 50) << " p99=" << percentile(rep.total_ms, 99) << "\n";
+    }
+
+    if (!out_path.empty()) {
+        fs::path p(out_path);
+        std::error_code ec;
+        if (p.has_parent_path()) fs::create_directories(p.parent_path(), ec);
+        std::ofstream f(p, std::ios::out | std::ios::trunc);
+        if (!f) {
+            std::cerr << "error: failed to open --out path: " << out_path << "\n";
+            return 1;
+        }
+
+        f << "{\n";
+        f << "  \"labels\": \"" << json_escape(labels_path) << "\",\n";
+        f << "  \"roles\": " << labels.size() << ",\n";
+        f << "  \"k\": " << k << ",\n";
+        f << "  \"iters\": " << iters << ",\n";
+        f << "  \"embed_ms\": {\"p50\": " << percentile(embed_ms, 50) << ", \"p99\": " << percentile(embed_ms, 99) << "},\n";
+        f << "  \"configs\": [\n";
+        for (size_t c = 0; c < configs.size(); ++c) {
+            const RetrievalConfig& cfg = configs[c].cfg;
+            const ConfigReport& rep = reports[c];
+            f << "    {\"name\": \"" << json_escape(configs[c].name) << "\""
+              << ", \"bigk_floor\": " << cfg.bigk_floor
+              << ", \"min_score\": " << cfg.min_score
+              << ", \"topn_seed\": " << cfg.topn_seed
+              << ", \"topx_tokens\": " << cfg.topx_tokens;
+            for (const auto& [key, val] : weight_fields(cfg.weights)) f << ", \"" << key << "\": " << val;
+            f << ", \"recall\": " << rep.mean.recall
+              << ", \"ndcg\": " << rep.mean.ndcg
+              << ", \"mrr\": " << rep.mean.mrr
+              << ", \"kept_avg\": " << rep.kept_avg
+              << ", \"retrieve_ms\": {\"p50\": " << percentile(rep.retrieve_ms, 50) << ", \"p99\": " << percentile(rep.retrieve_ms, 99) << "}"
+              << ", \"rerank_ms\": {\"p50\": " << percentile(rep.rerank_ms, 50) << ", \"p99\": " << percentile(rep.rerank_ms, 99) << "}"
+              << ", \"total_ms\": {\"p50\": " << percentile(rep.total_ms, 50) << ", \"p99\": " << percentile(rep.total_ms, 99) << "}}"
+              << (c + 1 < configs.size() ? ",\n" : "\n");
+        }
+        f << "  ]\n";
+        f << "}\n";
+
+        std::cout << "\nwrote " << out_path << "\n";
+    }
+
+    return 0;
+}
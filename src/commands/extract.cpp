@@ -0,0 +1,260 @@
+#include "commands/extract.hpp"
+#include "jobs/JobCorpus.hpp"
+#include "jobs/MentionStore.hpp"
+#include "jobs/Mentions.hpp"
+#include "jobs/PostingShrinker.hpp"
+#include "jobs/RequirementExtractor.hpp"
+#include "llm/MockLLMClient.hpp"
+#include "llm/OllamaLLMClient.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool has_flag(int argc, char** argv, const std::string& key) {
+    for (int i = 0; i < argc; ++i) {
+        if (argv[i] == key) return true;
+    }
+    return false;
+}
+
+static std::string get_arg(int argc, char** argv, const std::string& key, const std::string& def) {
+    for (int i = 0; i + 1 < argc; ++i) {
+        if (argv[i] == key) return argv[i + 1];
+    }
+    return def;
+}
+
+static std::string json_escape(const std::string& s) {
+    std::ostringstream oss;
+    for (char c : s) {
+        switch (c) {
+            case '\\': oss << "\\\\"; break;
+            case '"':  oss << "\\\""; break;
+            case '\n': oss << "\\n";  break;
+            case '\r': oss << "\\r";  break;
+            case '\t': oss << "\\t";  break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    oss << "\\u";
+                    const char* hex = "0123456789abcdef";
+                    oss << "00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+                } else oss << c;
+        }
+    }
+    return oss.str();
+}
+
+// one line per posting; empty categories are left out
+static void write_posting_line(std::ostream& out, const std::string& id, const ExtractedReqs& r) {
+    out << "{\"posting_id\":\"" << json_escape(id) << "\",\"by_category\":{";
+    bool first_cat = true;
+    for (const auto& [cat, items] : r.by_category) {
+        if (items.empty()) continue;
+        if (!first_cat) out << ",";
+        first_cat = false;
+
+        out << "\"" << json_escape(cat) << "\":[";
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (i) out << ",";
+            out << "\"" << json_escape(items[i]) << "\"";
+        }
+        out << "]";
+    }
+    out << "}}\n";
+}
+
+// LLM lines: the posting's counted skills (canonical), grouped by span type
+static ExtractedReqs reqs_by_span_type(const std::vector<Mention>& mentions) {
+    ExtractedReqs r;
+    for (const auto& m : mentions) {
+        if (!m.best) continue;
+        auto it = std::find_if(r.by_category.begin(), r.by_category.end(),
+                               [&](const auto& kv) { return kv.first == m.span_type; });
+        if (it == r.by_category.end()) it = r.by_category.insert(r.by_category.end(), {m.span_type, {}});
+        it->second.push_back(m.canonical);
+    }
+    return r;
+}
+
+int cmd_extract(int argc, char** argv) {
+    std::string jobs_dir     = get_arg(argc, argv, "--jobs", "data/jobs/raw");
+    std::string out_path     = get_arg(argc, argv, "--out", "out/corpus_mentions.jsonl");
+    std::string store_path   = get_arg(argc, argv, "--store", "data/embeddings/jobs.mentions.bin");
+    std::string skills_path  = get_arg(argc, argv, "--skills", "");
+    std::string threads_s    = get_arg(argc, argv, "--threads", "0");
+
+    // LLM args (same meaning as in analyze)
+    bool use_llm             = has_flag(argc, argv, "--llm");
+    bool llm_stream          = !has_flag(argc, argv, "--llm_no_stream");
+    std::string llm_mock_dir = get_arg(argc, argv, "--llm_mock", "");
+    std::string llm_model    = get_arg(argc, argv, "--llm_model", "llama3.2:3b");
+    std::string llm_cache    = get_arg(argc, argv, "--llm_cache", "out/llm_cache");
+    std::string llm_conc_s   = get_arg(argc, argv, "--llm_concurrency", "4");
+    std::string llm_tmo_s    = get_arg(argc, argv, "--llm_timeout", "300");
+    std::string llm_batch_s  = get_arg(argc, argv, "--llm_batch", "4");
+    std::string llm_btok_s   = get_arg(argc, argv, "--llm_batch_tokens", "6000");
+    std::string llm_ptok_s   = get_arg(argc, argv, "--llm_posting_tokens", "512");
+    std::string llm_mlat_s   = get_arg(argc, argv, "--llm_mock_latency", "0");
+    std::string llm_mjit_s   = get_arg(argc, argv, "--llm_mock_jitter", "0");
+    std::string vocab        = get_arg(argc, argv, "--vocab", "models/emb/vocab.txt");
+
+    size_t threads = 0;
+    try { threads = (size_t)std::stoul(threads_s); }
+    catch (...) {
+        std::cerr << "error: invalid --threads\n";
+        return 1;
+    }
+
+    size_t llm_concurrency = 0, llm_batch = 0, llm_batch_tokens = 0, llm_posting_tokens = 0;
+    double llm_mock_latency = 0.0, llm_mock_jitter = 0.0;
+    llm::HttpOptions llm_http;
+    try {
+        llm_concurrency = (size_t)std::stoul(llm_conc_s);
+        llm_http.read_timeout_ms = (int)(std::stod(llm_tmo_s) * 1000.0);
+        llm_batch = (size_t)std::stoul(llm_batch_s);
+        llm_batch_tokens = (size_t)std::stoul(llm_btok_s);
+        llm_posting_tokens = (size_t)std::stoul(llm_ptok_s);
+        llm_mock_latency = std::stod(llm_mlat_s);
+        llm_mock_jitter = std::stod(llm_mjit_s);
+    } catch (...) {
+        std::cerr << "error: invalid --llm_concurrency / --llm_timeout / --llm_batch / --llm_batch_tokens / --llm_posting_tokens"
+                     " / --llm_mock_latency / --llm_mock_jitter\n";
+        return 1;
+    }
+
+    if (!fs::is_directory(jobs_dir)) {
+        std::cerr << "error: jobs dir not found: " << jobs_dir << "\n";
+        return 1;
+    }
+
+    RequirementExtractor ex;
+    if (!skills_path.empty() && !ex.load_dictionary(skills_path)) {
+        std::cerr << "error: failed to load --skills dictionary: " << skills_path << "\n";
+        return 1;
+    }
+
+    // posting ids in sorted order; texts are read by the workers
+    std::vector<std::string> ids;
+    for (auto& entry : fs::directory_iterator(jobs_dir)) {
+        if (!entry.is_regular_file()) continue;
+        if (entry.path().extension() != ".txt") continue;
+        ids.push_back(entry.path().stem().string());
+    }
+    std::sort(ids.begin(), ids.end());
+
+    fs::path op(out_path);
+    if (op.has_parent_path()) {
+        std::error_code ec;
+        fs::create_directories(op.parent_path(), ec);
+    }
+    std::ofstream out(op, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "error: failed to open --out path: " << out_path << "\n";
+        return 1;
+    }
+
+    std::vector<std::vector<Mention>> rows(ids.size());
+    size_t mentions = 0;
+    size_t llm_failed = 0;
+    auto t0 = std::chrono::steady_clock::now();
+
+    if (!use_llm) {
+        try {
+            ex.extract_batch(
+                ids.size(),
+                [&](size_t i) { return JobCorpus::read_posting(jobs_dir, ids[i]); },
+                [&](size_t i, ExtractedReqs& r) {
+                    rows[i] = mentions_from_reqs(ids[i], r);
+                    mentions += rows[i].size();
+                    write_posting_line(out, ids[i], r);
+                },
+                threads);
+        } catch (const std::exception& e) {
+            std::cerr << "error: " << e.what() << "\n";
+            return 1;
+        }
+    } else {
+        std::unique_ptr<llm::LLMClient> client;
+        llm::OllamaLLMClient* ollama = nullptr;
+        if (!llm_mock_dir.empty()) {
+            auto mc = std::make_unique<llm::MockLLMClient>(llm_mock_dir);
+            if (!mc->load()) {
+                std::cerr << "error: " << mc->last_error() << "\n";
+                return 1;
+            }
+            mc->set_latency(llm_mock_latency, llm_mock_jitter);
+            client = std::move(mc);
+        } else {
+            auto oc = std::make_unique<llm::OllamaLLMClient>(llm_model, llm_cache, llm_http, llm_stream);
+            oc->set_batching(llm_batch, llm_batch_tokens);
+            ollama = oc.get();
+            client = std::move(oc);
+        }
+
+        const PostingShrinker shrinker = PostingShrinker::with_vocab(vocab, llm_posting_tokens);
+        if (!shrinker.has_counter()) {
+            std::cerr << "warning: cannot load " << vocab << "; estimating prompt tokens from length\n";
+        }
+
+        try {
+            llm::analyze_postings(
+                *client, ids, llm_concurrency,
+                [&](size_t i) { return shrinker.shrink(JobCorpus::read_posting(jobs_dir, ids[i])); },
+                [&](size_t i, std::vector<llm::EvidenceSpan>& ev) {
+                    rows[i] = mentions_from_evidence(ids[i], ev);
+                    mentions += rows[i].size();
+                    write_posting_line(out, ids[i], reqs_by_span_type(rows[i]));
+                });
+        } catch (const std::exception& e) {
+            std::cerr << "error: " << e.what() << "\n";
+            return 1;
+        }
+        if (ollama) std::cout << "LLM_REQUESTS: " << ollama->requests() << " prompt_tokens~" << ollama->prompt_tokens() << "\n";
+        llm_failed = client->failed_requests();
+    }
+
+    out.flush();
+    if (!out) {
+        std::cerr << "error: failed writing " << out_path << "\n";
+        return 1;
+    }
+
+    // analyze would reuse the store as complete; postings whose request failed have no mentions
+    if (!store_path.empty() && llm_failed > 0) {
+        std::cerr << "error: " << llm_failed << " LLM requests failed; not writing --store path: " << store_path
+                  << " (" << out_path << " is incomplete)\n";
+        return 1;
+    }
+
+    if (!store_path.empty()) {
+        fs::path sp(store_path);
+        if (sp.has_parent_path()) {
+            std::error_code ec;
+            fs::create_directories(sp.parent_path(), ec);
+        }
+        const std::string source = mention_source({use_llm, llm_mock_dir, llm_model, llm_posting_tokens, llm_batch,
+                                                   llm_batch_tokens, llm_stream, skills_path});
+        if (!MentionStore::save(store_path, source, jobs_dir, ids, rows)) {
+            std::cerr << "error: failed writing --store path: " << store_path << "\n";
+            return 1;
+        }
+    }
+
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "POSTINGS: " << ids.size() << "\n";
+    std::cout << "MENTIONS: " << mentions << "\n";
+    std::cout << "SECONDS: " << sec << "\n";
+    std::cout << "wrote " << out_path << "\n";
+    if (!store_path.empty()) std::cout << "wrote " << store_path << "\n";
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "commands/llmCache.hpp"
+#include "llm/CacheLog.hpp"
+#include "llm/OllamaLLMClient.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static std::string get_arg(int argc, char** argv, const std::string& key, const std::string& def) {
+    for (int i = 0; i + 1 < argc; ++i) {
+        if (argv[i] == key) return argv[i + 1];
+    }
+    return def;
+}
+
+static void print_stats(const char* label, const llm::CacheLog::Stats& s) {
+    std::cout << label << " records=" << s.records << " keys=" << s.keys << " bytes=" << s.bytes
+              << " live_bytes=" << s.live_bytes << "\n";
+}
+
+int cmd_llm_cache(int argc, char** argv) {
+    const std::string what = (argc >= 2) ? argv[1] : "";
+    const std::string dir = get_arg(argc, argv, "--llm_cache", "out/llm_cache");
+    const fs::path path = llm::OllamaLLMClient::cache_file(dir);
+
+    if (what != "stats" && what != "compact") {
+        std::cerr << "error: unknown llm-cache action (expected: stats, compact)\n";
+        return 1;
+    }
+    if (!fs::exists(path)) {
+        std::cerr << "error: no LLM cache at " << path.string() << "\n";
+        return 1;
+    }
+
+    if (what == "stats") {
+        llm::CacheLog log;
+        if (!log.open(path.string())) {
+            std::cerr << "error: cannot open " << path.string() << "\n";
+            return 1;
+        }
+        print_stats("CACHE", log.stats());
+        return 0;
+    }
+
+    llm::CacheLog::Stats before, after;
+    std::string err;
+    if (!llm::CacheLog::compact(path.string(), &before, &after, &err)) {
+        std::cerr << "error: compact failed: " << err << "\n";
+        return 1;
+    }
+    print_stats("BEFORE", before);
+    print_stats("AFTER", after);
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "commands/llmMock.hpp"
+#include "llm/MockLLMClient.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static std::string get_arg(int argc, char** argv, const std::string& key, const std::string& def) {
+    for (int i = 0; i + 1 < argc; ++i) {
+        if (argv[i] == key) return argv[i + 1];
+    }
+    return def;
+}
+
+int cmd_llm_mock(int argc, char** argv) {
+    const std::string what = (argc >= 2) ? argv[1] : "";
+    const std::string dir = get_arg(argc, argv, "--llm_mock", "");
+    const std::string out_path = get_arg(argc, argv, "--out", "");
+
+    if (what != "pack") {
+        std::cerr << "error: unknown llm-mock action (expected: pack)\n";
+        return 1;
+    }
+    if (dir.empty() || !fs::is_directory(dir)) {
+        std::cerr << "error: --llm_mock must name a fixture directory\n";
+        return 1;
+    }
+    if (out_path.empty()) {
+        std::cerr << "error: missing --out\n";
+        return 1;
+    }
+
+    fs::path op(out_path);
+    if (op.has_parent_path()) {
+        std::error_code ec;
+        fs::create_directories(op.parent_path(), ec);
+    }
+
+    size_t postings = 0;
+    std::string err;
+    if (!llm::MockLLMClient::write_pack(dir, out_path, &postings, &err)) {
+        std::cerr << "error: pack failed: " << err << "\n";
+        return 1;
+    }
+
+    std::error_code ec;
+    const auto bytes = fs::file_size(op, ec);
+    std::cout << "PACKED postings=" << postings << " bytes=" << (ec ? 0 : bytes) << " -> " << out_path << "\n";
+    return 0;
+}
@@ -17,7 +17,8 @@ namespace fs = std::filesystem;
 static int run_usage() {
     std::cerr
         << "usage:\n"
-        << "  resume-agent run --role \"<job title>\" --resume <path> [--outdir <dir>]\n";
+        << "  resume-agent run --role \"<job title>\" --resume <path> [--outdir <dir>] [--profile_cache <dir>]\n"
+        << "                   [--semantic_cache <path>]\n";
     return 1;
 }
 
@@ -71,6 +72,8 @@ int cmd_run(int argc, char** argv) {
     std::string role;
     std::string resume_path;
     std::string outdir = "out";
+    std::string profile_cache_dir = "out/profile_cache";
+    std::string semantic_cache_path = "out/semantic_cache/profile_skill_index.bin";
 
     for (int i = 1; i < argc; ++i) {
         const std::string a = argv[i];
@@ -104,6 +107,24 @@ int cmd_run(int argc, char** argv) {
             continue;
         }
 
+        if (a == "--profile_cache") {
+            if (i + 1 >= argc) {
+                std::cerr << "error: --profile_cache requires a value\n";
+                return 2;
+            }
+            profile_cache_dir = argv[++i];
+            continue;
+        }
+
+        if (a == "--semantic_cache") {
+            if (i + 1 >= argc) {
+                std::cerr << "error: --semantic_cache requires a value\n";
+                return 2;
+            }
+            semantic_cache_path = argv[++i];
+            continue;
+        }
+
         std::cerr << "error: unknown arg: " << a << "\n";
         return run_usage();
     }
@@ -129,7 +150,6 @@ int cmd_run(int argc, char** argv) {
     const fs::path profile_p = outdir_p / "profile.json";
     const std::string profile_path = profile_p.string();
     const std::string llm_cache_dir = (outdir_p / "llm_cache").string();
-    const std::string semantic_cache_path = (outdir_p / "profile_skill_index.bin").string();
 
     const fs::path explain_path = outdir_p / "explainability.json";
     const fs::path report_path  = outdir_p / "validation_report.json";
@@ -144,7 +164,7 @@ int cmd_run(int argc, char** argv) {
     // We intentionally do NOT delete resume.md/html etc. because attempts will overwrite.
 
     // -------------------------
-    // 1) ANALYZE (always)
+    // 1) ANALYZE (reuses a cached profile when role/corpus/params are unchanged)
     // -------------------------
     std::vector<std::string> analyze_args;
     analyze_args.push_back("analyze");
@@ -156,10 +176,13 @@ int cmd_run(int argc, char** argv) {
     analyze_args.push_back(outdir);
     analyze_args.push_back("--llm_cache");
     analyze_args.push_back(llm_cache_dir);
+    analyze_args.push_back("--profile_cache");
+    analyze_args.push_back(profile_cache_dir);
 
+    AnalyzeResult analyze_res;
     {
         auto cargv = to_argv(analyze_args);
-        const int rc = cmd_analyze((int)cargv.size(), cargv.data());
+        const int rc = cmd_analyze((int)cargv.size(), cargv.data(), &analyze_res);
         if (rc != 0) return rc;
     }
 
@@ -229,8 +252,10 @@ int cmd_run(int argc, char** argv) {
         build_args.push_back(profile_path);
         build_args.push_back("--outdir");
         build_args.push_back(outdir);
-        build_args.push_back("--semantic_cache");
-        build_args.push_back(semantic_cache_path);
+        if (!semantic_cache_path.empty()) {
+            build_args.push_back("--semantic_cache");
+            build_args.push_back(semantic_cache_path);
+        }
 
         if (tw.semantic_threshold >= 0.0) {
             build_args.push_back("--semantic_threshold");
@@ -315,6 +340,11 @@ int cmd_run(int argc, char** argv) {
         {"semantic_cache_path", semantic_cache_path}
     };
     manifest["analyze_args"] = args_to_json_array(analyze_args);
+    manifest["profile_cache"] = {
+        {"dir", profile_cache_dir},
+        {"key", analyze_res.profile_cache_key},
+        {"hit", analyze_res.profile_cache_hit}
+    };
 
     write_json(manifest_path, manifest);
 
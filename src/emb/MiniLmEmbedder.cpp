@@ -1,4 +1,5 @@
 #include "emb/MiniLmEmbedder.hpp"
+#include <algorithm>
 #include <cmath>
 #include <filesystem>
 #include <iostream>
@@ -96,3 +97,68 @@ std::vector<float> MiniLmEmbedder::embed(const std::string& text, size_t max_len
     l2_normalize(pooled);
     return pooled;
 }
+
+std::vector<std::vector<float>> MiniLmEmbedder::embed_batch(const std::vector<std::string>& texts, size_t max_len) const {
+    if (!m_session || texts.empty()) return {};
+
+    const size_t batch = texts.size();
+    std::vector<std::vector<int64_t>> enc(batch);
+    size_t seq_len = 0;
+    for (size_t b = 0; b < batch; ++b) {
+        enc[b] = m_tok.encode(texts[b], max_len);
+        seq_len = std::max(seq_len, enc[b].size());
+    }
+    if (seq_len == 0) return {};
+
+    // right-padded; padding is masked out of attention and of the pooling below
+    const int64_t pad = std::max<int64_t>(0, m_tok.pad_id());
+    std::vector<int64_t> ids(batch * seq_len, pad);
+    std::vector<int64_t> mask(batch * seq_len, 0);
+    std::vector<int64_t> type_ids(batch * seq_len, 0);
+    for (size_t b = 0; b < batch; ++b) {
+        for (size_t t = 0; t < enc[b].size(); ++t) {
+            ids[b * seq_len + t] = enc[b][t];
+            mask[b * seq_len + t] = 1;
+        }
+    }
+
+    std::vector<int64_t> shape{(int64_t)batch, (int64_t)seq_len};
+
+    Ort::MemoryInfo mem = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+
+    Ort::Value in_ids  = Ort::Value::CreateTensor<int64_t>(mem, ids.data(), ids.size(), shape.data(), shape.size());
+    Ort::Value in_mask = Ort::Value::CreateTensor<int64_t>(mem, mask.data(), mask.size(), shape.data(), shape.size());
+    Ort::Value in_type = Ort::Value::CreateTensor<int64_t>(mem, type_ids.data(), type_ids.size(), shape.data(), shape.size());
+
+    const char* in_names[3] = { m_in_ids.c_str(), m_in_mask.c_str(), m_in_type.c_str() };
+    Ort::Value in_vals[3] = { std::move(in_ids), std::move(in_mask), std::move(in_type) };
+
+    const char* out_names[1] = { m_out_name.c_str() };
+
+    auto outs = m_session->Run(Ort::RunOptions{nullptr}, in_names, in_vals, 3, out_names, 1);
+
+    Ort::Value& out = outs[0];
+    auto shp = out.GetTensorTypeAndShapeInfo().GetShape(); // [batch, seq_len, hidden]
+    if (shp.size() != 3 || shp[0] != (int64_t)batch || shp[1] != (int64_t)seq_len) return {};
+
+    const size_t hidden = (size_t)shp[2];
+    const float* data = out.GetTensorData<float>();
+
+    std::vector<std::vector<float>> pooled(batch, std::vector<float>(hidden, 0.0f));
+    for (size_t b = 0; b < batch; ++b) {
+        double denom = 0.0;
+        for (size_t t = 0; t < seq_len; ++t) {
+            if (mask[b * seq_len + t] == 0) continue;
+            denom += 1.0;
+            const float* row = data + ((b * seq_len + t) * hidden);
+            for (size_t j = 0; j < hidden; ++j) pooled[b][j] += row[j];
+        }
+
+        if (denom > 0.0) {
+            float inv = (float)(1.0 / denom);
+            for (float& x : pooled[b]) x *= inv;
+        }
+        l2_normalize(pooled[b]);
+    }
+    return pooled;
+}
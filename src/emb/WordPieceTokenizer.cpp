@@ -1,5 +1,5 @@
 #include "emb/WordPieceTokenizer.hpp"
-#include <cctype>
+#include "jobs/TextUtil.hpp"
 #include <fstream>
 
 bool WordPieceTokenizer::load_vocab(const std::string& vocab_path) {
@@ -35,7 +35,7 @@ bool WordPieceTokenizer::is_punct(char c) {
 }
 
 std::string WordPieceTokenizer::lower_ascii(std::string s) {
-    for (char& c : s) c = (char)std::tolower((unsigned char)c);
+    textutil::lower_ascii_inplace(s);
     return s;
 }
 
@@ -111,3 +111,9 @@ std::vector<int64_t> WordPieceTokenizer::encode(const std::string& text, size_t
     ids.push_back(sep);
     return ids;
 }
+
+size_t WordPieceTokenizer::count_tokens(const std::string& text) const {
+    size_t n = 0;
+    for (const auto& t : basic_tokenize(text)) n += wordpiece(t).size();
+    return n;
+}
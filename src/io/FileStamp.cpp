@@ -0,0 +1,39 @@
+#include "io/FileStamp.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static std::string stamp_of(const fs::path& p) {
+    std::error_code ec1, ec2;
+    const auto size = fs::file_size(p, ec1);
+    const auto mtime = fs::last_write_time(p, ec2);
+    if (ec1 || ec2) return "-";
+    return std::to_string(size) + "@" + std::to_string((long long)mtime.time_since_epoch().count());
+}
+
+std::string file_stamp(const std::string& path) {
+    return stamp_of(fs::path(path));
+}
+
+std::string dir_stamps(const std::string& dir) {
+    std::vector<std::pair<std::string, std::string>> entries;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file()) continue;
+        entries.push_back({it->path().filename().string(), stamp_of(it->path())});
+    }
+    std::sort(entries.begin(), entries.end());
+
+    std::string out;
+    for (const auto& [name, stamp] : entries) {
+        out += name;
+        out += '\t';
+        out += stamp;
+        out += '\n';
+    }
+    return out;
+}
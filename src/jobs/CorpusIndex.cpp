@@ -0,0 +1,263 @@
+#include "jobs/CorpusIndex.hpp"
+#include "io/BinarySections.hpp"
+#include "io/FileStamp.hpp"
+#include "jobs/TextUtil.hpp"
+#include "jobs/Zones.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+using textutil::TokenId;
+
+// On-disk layout (little endian, every section padded to 8 bytes):
+//   "RCIX" u32 version, u64 n_postings, u64 n_vocab
+//   jobs_dir   : u64 len, bytes
+//   stamps     : u64 len, bytes                   (dir_stamps(jobs_dir) at build time)
+//   vocab      : u64 offs[n_vocab + 1], bytes     (token strings by file id)
+//   ids        : u64 offs[n + 1], bytes
+//   titles     : u64 offs[n + 1], bytes
+//   sorted     : u32[n]                            (posting indexes ordered by id)
+//   df         : u32[n_vocab]
+//   body/title/lead/req : u64 offs[n + 1], u32 ids[offs[n]]
+static const char kMagic[4] = {'R', 'C', 'I', 'X'};
+static const uint32_t kVersion = 2;
+
+std::vector<TokenId> body_token_ids(std::string_view raw) {
+    thread_local textutil::TokenBuffer tb;
+    textutil::scan_tokens(raw, tb);
+
+    auto& symbols = textutil::SymbolTable::global();
+    std::vector<TokenId> s;
+    s.reserve(tb.tokens.size());
+    for (auto t : tb.tokens) {
+        if (!t.empty()) s.push_back(symbols.intern(t));
+    }
+    textutil::sort_unique(s);
+    return s;
+}
+
+std::vector<TokenId> zone_token_ids(std::string_view raw) {
+    static const TokenId cpp = textutil::intern("cpp");
+    static const TokenId cplusplus = textutil::intern("c++");
+
+    std::vector<TokenId> s = body_token_ids(raw);
+    for (TokenId& t : s) if (t == cpp) t = cplusplus;
+    textutil::sort_unique(s);
+    return s;
+}
+
+PostingFeatures compute_posting_features(const std::string& raw) {
+    Zones z = extract_zones(raw);
+
+    PostingFeatures f;
+    f.title_toks = zone_token_ids(z.title);
+    f.lead_toks  = zone_token_ids(z.lead);
+    f.req_toks   = zone_token_ids(z.req);
+    f.title = std::move(z.title);
+    return f;
+}
+
+static std::string canonical_dir(const std::string& dir) {
+    std::error_code ec;
+    fs::path p = fs::weakly_canonical(fs::path(dir), ec);
+    return ec ? fs::path(dir).generic_string() : p.generic_string();
+}
+
+std::string CorpusIndex::default_path(const std::string& emb_path) {
+    return fs::path(emb_path).replace_extension(".corpus.bin").string();
+}
+
+// ---------------- writing ----------------
+
+bool CorpusIndex::build_and_save(const JobCorpus& corpus, const std::string& jobs_dir, const std::string& path) {
+    const auto& posts = corpus.postings();
+    const size_t n = posts.size();
+
+    std::vector<std::vector<TokenId>> body(n), title_toks(n), lead_toks(n), req_toks(n);
+    std::vector<std::string> titles(n);
+
+    // bodies first, then zones: interns in the same order as analyze does without
+    // the sidecar, so a fresh process maps file ids 1:1
+    for (size_t i = 0; i < n; ++i) body[i] = body_token_ids(posts[i].raw_text);
+
+    for (size_t i = 0; i < n; ++i) {
+        PostingFeatures f = compute_posting_features(posts[i].raw_text);
+        titles[i]     = std::move(f.title);
+        title_toks[i] = std::move(f.title_toks);
+        lead_toks[i]  = std::move(f.lead_toks);
+        req_toks[i]   = std::move(f.req_toks);
+    }
+
+    // every id referenced above is below this
+    auto& symbols = textutil::SymbolTable::global();
+    const size_t n_vocab = symbols.size();
+
+    std::vector<uint32_t> df(n_vocab, 0);
+    for (const auto& b : body) {
+        for (TokenId t : b) df[t] += 1;
+    }
+
+    std::vector<uint32_t> sorted(n);
+    for (size_t i = 0; i < n; ++i) sorted[i] = (uint32_t)i;
+    std::sort(sorted.begin(), sorted.end(),
+              [&](uint32_t a, uint32_t b) { return posts[a].id < posts[b].id; });
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    SectionWriter w{out};
+    w.bytes(kMagic, sizeof(kMagic));
+    w.pod(kVersion);
+    w.pod((uint64_t)n);
+    w.pod((uint64_t)n_vocab);
+
+    const std::string dir = canonical_dir(jobs_dir);
+    const std::string stamps = dir_stamps(jobs_dir);
+    for (const std::string* s : {&dir, &stamps}) {
+        w.pod((uint64_t)s->size());
+        w.bytes(s->data(), s->size());
+        w.pad();
+    }
+
+    w.strtab(n_vocab, [&](size_t i) { return symbols.str((TokenId)i); });
+    w.strtab(n, [&](size_t i) { return std::string_view(posts[i].id); });
+    w.strtab(n, [&](size_t i) { return std::string_view(titles[i]); });
+
+    w.array(sorted);
+    w.pad();
+    w.array(df);
+    w.pad();
+
+    w.csr(body);
+    w.csr(title_toks);
+    w.csr(lead_toks);
+    w.csr(req_toks);
+
+    out.flush();
+    return (bool)out;
+}
+
+// ---------------- reading ----------------
+
+bool CorpusIndex::load(const std::string& path) {
+    *this = CorpusIndex();
+    if (!m_file.open(path)) return false;
+
+    SectionReader r{m_file.data(), m_file.size()};
+
+    const char* magic = r.take(sizeof(kMagic));
+    if (!magic || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) return false;
+    if (r.pod<uint32_t>() != kVersion) return false;
+
+    const uint64_t n = r.pod<uint64_t>();
+    const uint64_t n_vocab = r.pod<uint64_t>();
+    if (!r.ok || n > 0xFFFFFFFFull || n_vocab > 0xFFFFFFFFull) return false;
+
+    auto read_str = [&](std::string_view& out) {
+        const uint64_t len = r.pod<uint64_t>();
+        const char* p = r.array<char>((size_t)len);
+        r.pad();
+        if (!r.ok) return false;
+        out = std::string_view(p, (size_t)len);
+        return true;
+    };
+    std::string_view dir, stamps;
+    if (!read_str(dir) || !read_str(stamps)) return false;
+
+    auto read_strtab = [&](size_t count, StrTab& t) {
+        t.offs = r.array<uint64_t>(count + 1);
+        uint64_t total = 0;
+        if (!t.offs || !r.offsets(t.offs, count, total)) return false;
+        t.bytes = r.array<char>((size_t)total);
+        r.pad();
+        return r.ok;
+    };
+
+    auto read_csr = [&](Csr& c) {
+        c.offs = r.array<uint64_t>((size_t)n + 1);
+        uint64_t total = 0;
+        if (!c.offs || !r.offsets(c.offs, (size_t)n, total)) return false;
+        c.ids = r.array<uint32_t>((size_t)total);
+        r.pad();
+        if (!r.ok) return false;
+        for (uint64_t k = 0; k < total; ++k) {
+            if (c.ids[k] >= n_vocab) return false;
+        }
+        return true;
+    };
+
+    StrTab vocab;
+    if (!read_strtab((size_t)n_vocab, vocab)) return false;
+    if (!read_strtab((size_t)n, m_ids)) return false;
+    if (!read_strtab((size_t)n, m_titles)) return false;
+
+    m_sorted = r.array<uint32_t>((size_t)n);
+    r.pad();
+    const uint32_t* df = r.array<uint32_t>((size_t)n_vocab);
+    r.pad();
+    if (!r.ok) return false;
+    for (uint64_t i = 0; i < n; ++i) {
+        if (m_sorted[i] >= n) return false;
+    }
+
+    if (!read_csr(m_body) || !read_csr(m_title_toks) || !read_csr(m_lead_toks) || !read_csr(m_req_toks)) {
+        return false;
+    }
+
+    // map file ids onto the process symbol table
+    auto& symbols = textutil::SymbolTable::global();
+    std::vector<TokenId> remap((size_t)n_vocab);
+    bool identity = true;
+    for (size_t i = 0; i < remap.size(); ++i) {
+        remap[i] = symbols.intern(str_at(vocab, i));
+        identity = identity && remap[i] == (TokenId)i;
+    }
+
+    m_n = (size_t)n;
+    m_jobs_dir = dir;
+    m_stamps = stamps;
+
+    if (identity) {
+        m_df = std::span<const uint32_t>(df, (size_t)n_vocab);
+        return true;
+    }
+
+    // ids shifted (the table already held other strings): rewrite into owned arrays
+    m_df_owned.assign(symbols.size(), 0);
+    for (size_t i = 0; i < remap.size(); ++i) m_df_owned[remap[i]] = df[i];
+    m_df = m_df_owned;
+
+    for (Csr* c : {&m_body, &m_title_toks, &m_lead_toks, &m_req_toks}) {
+        c->owned.resize((size_t)c->offs[m_n]);
+        for (size_t p = 0; p < m_n; ++p) {
+            auto first = c->owned.begin() + (ptrdiff_t)c->offs[p];
+            auto last  = c->owned.begin() + (ptrdiff_t)c->offs[p + 1];
+            for (uint64_t k = c->offs[p]; k < c->offs[p + 1]; ++k) {
+                c->owned[(size_t)k] = remap[c->ids[k]];
+            }
+            std::sort(first, last);
+        }
+        c->ids = c->owned.data();
+    }
+    return true;
+}
+
+bool CorpusIndex::matches(const std::string& jobs_dir) const {
+    if (m_jobs_dir != canonical_dir(jobs_dir)) return false;
+
+    // every posting's name, size and mtime: an edit in place leaves the directory's
+    // own mtime alone
+    return m_stamps == dir_stamps(jobs_dir);
+}
+
+std::optional<size_t> CorpusIndex::find(std::string_view posting_id) const {
+    const uint32_t* first = m_sorted;
+    const uint32_t* last  = m_sorted + m_n;
+    auto it = std::lower_bound(first, last, posting_id,
+                               [&](uint32_t i, std::string_view key) { return id(i) < key; });
+    if (it == last || id(*it) != posting_id) return std::nullopt;
+    return (size_t)*it;
+}
@@ -40,6 +40,50 @@ std::vector<EmbHit> EmbeddingIndex::topk(const std::vector<float>& query_vec, si
     return hits;
 }
 
+std::vector<std::vector<EmbHit>> EmbeddingIndex::topk_batch(const std::vector<float>& queries, size_t k) const {
+    if (m_dim == 0 || queries.empty() || queries.size() % m_dim != 0) return {};
+    const size_t nq = queries.size() / m_dim;
+    const size_t n = m_job_ids.size();
+
+    // same arithmetic as cosine(), with each norm computed once instead of per pair
+    auto sq_norm = [this](const float* a) {
+        double s = 0.0;
+        for (size_t i = 0; i < m_dim; ++i) s += (double)a[i] * (double)a[i];
+        return s;
+    };
+    std::vector<double> qn(nq);
+    for (size_t q = 0; q < nq; ++q) qn[q] = sq_norm(&queries[q * m_dim]);
+
+    // row-major: each index vector is read once and scored against every query
+    std::vector<float> scores(nq * n);
+    for (size_t i = 0; i < n; ++i) {
+        const float* v = &m_vecs[i * m_dim];
+        const double vn = sq_norm(v);
+        for (size_t q = 0; q < nq; ++q) {
+            const float* a = &queries[q * m_dim];
+            double dot = 0.0;
+            for (size_t d = 0; d < m_dim; ++d) dot += (double)a[d] * (double)v[d];
+            scores[q * n + i] = (qn[q] == 0.0 || vn == 0.0) ? 0.0f : (float)(dot / (std::sqrt(qn[q]) * std::sqrt(vn)));
+        }
+    }
+
+    std::vector<std::vector<EmbHit>> out(nq);
+    std::vector<std::pair<float, size_t>> order;
+    for (size_t q = 0; q < nq; ++q) {
+        order.clear();
+        for (size_t i = 0; i < n; ++i) order.push_back({scores[q * n + i], i});
+
+        // same partial_sort as topk(), so ties come out in the same order
+        const size_t kk = std::min(k, order.size());
+        std::partial_sort(order.begin(), order.begin() + kk, order.end(),
+                          [](const auto& a, const auto& b){ return a.first > b.first; });
+
+        out[q].reserve(kk);
+        for (size_t j = 0; j < kk; ++j) out[q].push_back({m_job_ids[order[j].second], order[j].first});
+    }
+    return out;
+}
+
 bool EmbeddingIndex::save(const std::string& path) const {
     std::ofstream out(path, std::ios::binary);
     if (!out) return false;
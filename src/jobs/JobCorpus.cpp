@@ -34,3 +34,7 @@ JobCorpus JobCorpus::load_from_dir(const std::string& dir) {
 
     return c;
 }
+
+std::string JobCorpus::read_posting(const std::string& dir, const std::string& id) {
+    return read_all(fs::path(dir) / (id + ".txt"));
+}
@@ -0,0 +1,96 @@
+#include "jobs/KeywordScanner.hpp"
+#include <deque>
+
+namespace textutil {
+
+static unsigned char fold(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + 32) : c;
+}
+
+KeywordScanner::KeywordScanner(std::initializer_list<std::string_view> patterns) {
+    std::vector<std::string> v;
+    v.reserve(patterns.size());
+    for (auto p : patterns) v.emplace_back(p);
+    build(v);
+}
+
+KeywordScanner::KeywordScanner(const std::vector<std::string>& patterns) {
+    build(patterns);
+}
+
+void KeywordScanner::build(const std::vector<std::string>& patterns) {
+    // byte classes: 0 = not in any pattern; letters share a class with their upper case
+    for (const auto& p : patterns) {
+        for (unsigned char c : p) {
+            c = fold(c);
+            if (m_class[c] == 0) m_class[c] = (uint8_t)m_classes++;
+        }
+    }
+    for (int c = 'a'; c <= 'z'; ++c) m_class[c - 32] = m_class[c];
+
+    // trie (0 = no edge; the root is never a child)
+    std::vector<uint32_t> trie(m_classes, 0);
+    m_depth.assign(1, 0);
+    m_pattern.assign(1, -1);
+    m_len.clear();
+
+    for (size_t pi = 0; pi < patterns.size(); ++pi) {
+        uint32_t s = 0;
+        for (unsigned char c : patterns[pi]) {
+            uint32_t& edge = trie[(size_t)s * m_classes + m_class[c]];
+            if (edge == 0) {
+                edge = (uint32_t)m_depth.size();
+                m_depth.push_back(m_depth[s] + 1);
+                m_pattern.push_back(-1);
+                trie.resize(trie.size() + m_classes, 0);
+            }
+            s = trie[(size_t)s * m_classes + m_class[c]];
+        }
+        m_pattern[s] = (int)pi;
+        m_len.push_back((uint32_t)patterns[pi].size());
+    }
+
+    // BFS: resolve failure links into full DFA transitions and collect outputs
+    const size_t n = m_depth.size();
+    m_next.assign(n * m_classes, 0);
+    std::vector<uint32_t> fail(n, 0);
+    std::vector<std::vector<uint32_t>> outs(n);
+
+    std::deque<uint32_t> q{0};
+    while (!q.empty()) {
+        const uint32_t u = q.front();
+        q.pop_front();
+
+        if (m_pattern[u] >= 0) outs[u].push_back((uint32_t)m_pattern[u]);
+        if (u != 0) outs[u].insert(outs[u].end(), outs[fail[u]].begin(), outs[fail[u]].end());
+
+        for (uint32_t c = 0; c < m_classes; ++c) {
+            const uint32_t v = trie[(size_t)u * m_classes + c];
+            const uint32_t via_fail = (u == 0) ? 0 : m_next[(size_t)fail[u] * m_classes + c];
+            if (v) {
+                fail[v] = via_fail;
+                m_next[(size_t)u * m_classes + c] = v;
+                q.push_back(v);
+            } else {
+                m_next[(size_t)u * m_classes + c] = via_fail;
+            }
+        }
+    }
+
+    m_out_begin.assign(n + 1, 0);
+    for (size_t s = 0; s < n; ++s) m_out_begin[s + 1] = m_out_begin[s] + (uint32_t)outs[s].size();
+    m_out.clear();
+    m_out.reserve(m_out_begin[n]);
+    for (const auto& o : outs) m_out.insert(m_out.end(), o.begin(), o.end());
+}
+
+int KeywordScanner::find_exact(std::string_view text) const {
+    uint32_t s = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        s = m_next[(size_t)s * m_classes + m_class[(unsigned char)text[i]]];
+        if (m_depth[s] != i + 1) return -1; // fell off the trie path
+    }
+    return m_pattern[s];
+}
+
+}
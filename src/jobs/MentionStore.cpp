@@ -0,0 +1,249 @@
+#include "jobs/MentionStore.hpp"
+#include "io/BinarySections.hpp"
+#include "io/FileStamp.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+// On-disk layout (little endian, every section padded to 8 bytes):
+//   "RMST" u32 version, u64 n_postings, u64 n_rows, u64 n_strings
+//   source     : u64 len, bytes
+//   jobs_dir   : u64 len, bytes
+//   stamps     : u64 len, bytes            (dir_stamps(jobs_dir) when saved)
+//   strings    : u64 offs[n_strings + 1], bytes
+//   ids        : u64 offs[n + 1], bytes            (sorted)
+//   row_offs   : u64[n + 1]
+//   skill, raw, category, strength, polarity, span_type : u32[n_rows] each
+//   confidence, contrib : f64[n_rows] each
+//   best       : u8[n_rows]
+static const char kMagic[4] = {'R', 'M', 'S', 'T'};
+static const uint32_t kVersion = 2;
+
+static std::string canonical_dir(const std::string& dir) {
+    std::error_code ec;
+    fs::path p = fs::weakly_canonical(fs::path(dir), ec);
+    return ec ? fs::path(dir).generic_string() : p.generic_string();
+}
+
+std::string MentionStore::default_path(const std::string& emb_path) {
+    return fs::path(emb_path).replace_extension(".mentions.bin").string();
+}
+
+// ---------------- writing ----------------
+
+bool MentionStore::save(const std::string& path,
+                        const std::string& source,
+                        const std::string& jobs_dir,
+                        const std::vector<std::string>& posting_ids,
+                        const std::vector<std::vector<Mention>>& rows) {
+    if (posting_ids.size() != rows.size()) return false;
+    const size_t n = posting_ids.size();
+
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return posting_ids[a] < posting_ids[b]; });
+
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> sid;
+    auto intern = [&](const std::string& s) {
+        auto [it, added] = sid.emplace(s, (uint32_t)strings.size());
+        if (added) strings.push_back(s);
+        return it->second;
+    };
+
+    std::vector<uint64_t> row_offs(n + 1, 0);
+    std::vector<uint32_t> skill, raw, category, strength, polarity, span_type;
+    std::vector<double> confidence, contrib;
+    std::vector<uint8_t> best;
+
+    for (size_t k = 0; k < n; ++k) {
+        for (const Mention& m : rows[order[k]]) {
+            skill.push_back(intern(m.canonical));
+            raw.push_back(intern(m.raw));
+            category.push_back(intern(m.category));
+            strength.push_back(intern(m.strength));
+            polarity.push_back(intern(m.polarity));
+            span_type.push_back(intern(m.span_type));
+            confidence.push_back(m.confidence);
+            contrib.push_back(m.contrib);
+            best.push_back(m.best ? 1 : 0);
+        }
+        row_offs[k + 1] = skill.size();
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    SectionWriter w{out};
+    w.bytes(kMagic, sizeof(kMagic));
+    w.pod(kVersion);
+    w.pod((uint64_t)n);
+    w.pod((uint64_t)skill.size());
+    w.pod((uint64_t)strings.size());
+
+    const std::string dir = canonical_dir(jobs_dir);
+    const std::string stamps = dir_stamps(jobs_dir);
+    for (const std::string* s : {&source, &dir, &stamps}) {
+        w.pod((uint64_t)s->size());
+        w.bytes(s->data(), s->size());
+        w.pad();
+    }
+
+    w.strtab(strings.size(), [&](size_t i) { return std::string_view(strings[i]); });
+    w.strtab(n, [&](size_t k) { return std::string_view(posting_ids[order[k]]); });
+
+    w.array(row_offs);
+    for (const auto* col : {&skill, &raw, &category, &strength, &polarity, &span_type}) {
+        w.array(*col);
+        w.pad();
+    }
+    w.array(confidence);
+    w.array(contrib);
+    w.array(best);
+    w.pad();
+
+    out.flush();
+    return (bool)out;
+}
+
+// ---------------- reading ----------------
+
+bool MentionStore::load(const std::string& path) {
+    *this = MentionStore();
+    if (!m_file.open(path)) return false;
+
+    SectionReader r{m_file.data(), m_file.size()};
+
+    const char* magic = r.take(sizeof(kMagic));
+    if (!magic || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) return false;
+    if (r.pod<uint32_t>() != kVersion) return false;
+
+    const uint64_t n = r.pod<uint64_t>();
+    const uint64_t n_rows = r.pod<uint64_t>();
+    const uint64_t n_strings = r.pod<uint64_t>();
+    if (!r.ok || n > 0xFFFFFFFFull || n_strings > 0xFFFFFFFFull) return false;
+
+    auto read_str = [&](std::string_view& out) {
+        const uint64_t len = r.pod<uint64_t>();
+        const char* p = r.array<char>((size_t)len);
+        r.pad();
+        if (!r.ok) return false;
+        out = std::string_view(p, (size_t)len);
+        return true;
+    };
+
+    auto read_strtab = [&](size_t count, StrTab& t) {
+        t.offs = r.array<uint64_t>(count + 1);
+        uint64_t total = 0;
+        if (!t.offs || !r.offsets(t.offs, count, total)) return false;
+        t.bytes = r.array<char>((size_t)total);
+        r.pad();
+        return r.ok;
+    };
+
+    if (!read_str(m_source) || !read_str(m_jobs_dir) || !read_str(m_stamps)) return false;
+    if (!read_strtab((size_t)n_strings, m_strings)) return false;
+    if (!read_strtab((size_t)n, m_ids)) return false;
+
+    m_row_offs = r.array<uint64_t>((size_t)n + 1);
+    uint64_t total = 0;
+    if (!m_row_offs || !r.offsets(m_row_offs, (size_t)n, total) || total != n_rows) return false;
+
+    auto read_ids = [&](const uint32_t*& col) {
+        col = r.array<uint32_t>((size_t)n_rows);
+        r.pad();
+        if (!r.ok) return false;
+        for (uint64_t k = 0; k < n_rows; ++k) {
+            if (col[k] >= n_strings) return false;
+        }
+        return true;
+    };
+
+    for (const uint32_t** col : {&m_skill, &m_raw, &m_category, &m_strength, &m_polarity, &m_span_type}) {
+        if (!read_ids(*col)) return false;
+    }
+    m_confidence = r.array<double>((size_t)n_rows);
+    m_contrib = r.array<double>((size_t)n_rows);
+    m_best = r.array<uint8_t>((size_t)n_rows);
+    r.pad();
+    if (!r.ok) return false;
+
+    m_n = (size_t)n;
+    m_rows = (size_t)n_rows;
+    m_n_strings = (size_t)n_strings;
+
+    for (size_t s = 0; s < m_n_strings; ++s) {
+        if (str_at(m_strings, s) == "negated") m_negated = (uint32_t)s;
+    }
+    return true;
+}
+
+bool MentionStore::matches(const std::string& jobs_dir, const std::string& source) const {
+    if (m_source != source) return false;
+    if (m_jobs_dir != canonical_dir(jobs_dir)) return false;
+
+    // every posting's name, size and mtime, as in CorpusIndex::matches
+    return m_stamps == dir_stamps(jobs_dir);
+}
+
+std::optional<size_t> MentionStore::find(std::string_view posting_id) const {
+    size_t lo = 0, hi = m_n;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (id(mid) < posting_id) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == m_n || id(lo) != posting_id) return std::nullopt;
+    return lo;
+}
+
+std::vector<Mention> MentionStore::mentions(size_t i) const {
+    std::vector<Mention> out;
+    out.reserve((size_t)(m_row_offs[i + 1] - m_row_offs[i]));
+
+    const std::string posting_id(id(i));
+    for (uint64_t k = m_row_offs[i]; k < m_row_offs[i + 1]; ++k) {
+        Mention m;
+        m.posting_id = posting_id;
+        m.category   = str(m_category[k]);
+        m.raw        = str(m_raw[k]);
+        m.canonical  = str(m_skill[k]);
+        m.strength   = str(m_strength[k]);
+        m.polarity   = str(m_polarity[k]);
+        m.span_type  = str(m_span_type[k]);
+        m.confidence = m_confidence[k];
+        m.contrib    = m_contrib[k];
+        m.best       = m_best[k] != 0;
+        out.push_back(std::move(m));
+    }
+    return out;
+}
+
+std::vector<SkillTotal> MentionStore::aggregate(const std::vector<size_t>& postings) const {
+    std::vector<SkillTotal> out;
+    std::vector<uint32_t> slot(m_n_strings, UINT32_MAX); // skill string id -> index in out
+
+    for (size_t i : postings) {
+        for (uint64_t k = m_row_offs[i]; k < m_row_offs[i + 1]; ++k) {
+            if (!m_best[k] || m_polarity[k] == m_negated) continue;
+
+            uint32_t& s = slot[m_skill[k]];
+            if (s == UINT32_MAX) {
+                s = (uint32_t)out.size();
+                out.emplace_back().skill = str(m_skill[k]);
+            }
+
+            SkillTotal& t = out[s];
+            t.count += 1;
+            t.sum_contrib += m_contrib[k];
+            if (t.evidence.size() < 3) t.evidence.push_back(str(m_raw[k]));
+        }
+    }
+    return out;
+}
@@ -0,0 +1,193 @@
+#include "jobs/Mentions.hpp"
+#include "io/FileStamp.hpp"
+#include "io/Hash.hpp"
+#include "jobs/TextUtil.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+static std::string trim_ascii(const std::string& s) {
+    size_t i = 0;
+    while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) ++i;
+    size_t j = s.size();
+    while (j > i && (s[j - 1] == ' ' || s[j - 1] == '\t' || s[j - 1] == '\n' || s[j - 1] == '\r')) --j;
+    return s.substr(i, j - i);
+}
+
+std::string canonicalize_skill(const std::string& raw) {
+    std::string s = trim_ascii(raw);
+    textutil::lower_ascii_inplace(s);
+
+    if (s == "c++17" || s == "c++20" || s == "c++14" || s == "c++11") return "c++";
+    if (s == "cpp") return "c++";
+    if (s == "js") return "javascript";
+    if (s == "ts") return "typescript";
+    if (s == "py") return "python";
+
+    return s;
+}
+
+double span_weight_from_category(const std::string& cat) {
+    (void)cat;
+    return 1.0;
+}
+
+double span_weight_from_span_type(const std::string& t) {
+    if (t == "requirement") return 1.0;
+    if (t == "preferred") return 0.6;
+    if (t == "responsibility") return 0.4;
+    return 0.2;
+}
+
+double strength_weight(const std::string& s) {
+    if (s == "must") return 1.0;
+    if (s == "should") return 0.7;
+    if (s == "nice") return 0.4;
+    return 0.6;
+}
+
+// first mention with the strictly highest contrib wins, per canonical skill
+static void mark_best(std::vector<Mention>& ms) {
+    std::unordered_map<std::string, size_t> best;
+    for (size_t i = 0; i < ms.size(); ++i) {
+        if (ms[i].canonical.empty()) continue;
+        auto [it, added] = best.emplace(ms[i].canonical, i);
+        if (!added && ms[i].contrib > ms[it->second].contrib) it->second = i;
+    }
+    for (const auto& kv : best) ms[kv.second].best = true;
+}
+
+std::vector<Mention> mentions_from_reqs(const std::string& posting_id, const ExtractedReqs& r) {
+    std::vector<Mention> out;
+
+    for (const auto& [cat, items] : r.by_category) {
+        const double sw = span_weight_from_category(cat);
+        for (const auto& raw_skill : items) {
+            Mention m;
+            m.posting_id = posting_id;
+            m.category   = cat;
+            m.raw        = raw_skill;
+            m.canonical  = canonicalize_skill(raw_skill);
+
+            m.strength   = "must";
+            m.polarity   = "positive";
+            m.confidence = 1.0;
+            m.contrib    = sw * 1.0 * m.confidence;
+            out.push_back(std::move(m));
+        }
+    }
+
+    mark_best(out);
+    return out;
+}
+
+std::vector<Mention> mentions_from_evidence(const std::string& posting_id,
+                                            const std::vector<llm::EvidenceSpan>& evidence) {
+    std::vector<Mention> out;
+
+    for (const auto& ev0 : evidence) {
+        std::string pol = ev0.polarity;
+        if (pol.empty()) pol = "positive";
+        if (pol == "negated") continue;
+
+        std::string st = ev0.strength;
+        if (st.empty()) st = "unknown";
+
+        std::string stype = ev0.span_type;
+        if (stype.empty()) stype = "other";
+
+        const double sw  = span_weight_from_span_type(stype);
+        const double stw = strength_weight(st);
+
+        for (const auto& sh : ev0.skills) {
+            std::string canon = canonicalize_skill(!sh.canonical.empty() ? sh.canonical : sh.raw);
+            if (canon.empty()) continue;
+
+            Mention m;
+            m.posting_id = posting_id;
+            m.category   = "";
+            m.raw        = sh.raw;
+            m.canonical  = canon;
+
+            m.strength   = st;
+            m.polarity   = pol;
+            m.span_type  = stype;
+            m.confidence = sh.confidence;
+            m.contrib    = sw * stw * m.confidence;
+            out.push_back(std::move(m));
+        }
+    }
+
+    mark_best(out);
+    return out;
+}
+
+ExtractedReqs reqs_from_mentions(const std::vector<Mention>& mentions) {
+    ExtractedReqs r;
+    for (const auto& m : mentions) {
+        if (r.by_category.empty() || r.by_category.back().first != m.category) {
+            r.by_category.push_back({m.category, {}});
+        }
+        r.by_category.back().second.push_back(m.raw);
+    }
+    return r;
+}
+
+std::vector<SkillTotal> aggregate_mentions(const std::vector<Mention>& mentions) {
+    std::vector<SkillTotal> out;
+    std::unordered_map<std::string, size_t> slot;
+
+    for (const auto& m : mentions) {
+        if (!m.best || m.polarity == "negated") continue;
+
+        auto [it, added] = slot.emplace(m.canonical, out.size());
+        if (added) out.emplace_back().skill = m.canonical;
+
+        SkillTotal& t = out[it->second];
+        t.count += 1;
+        t.sum_contrib += m.contrib;
+        if (t.evidence.size() < 3) t.evidence.push_back(m.raw);
+    }
+    return out;
+}
+
+static std::string canonical_path(const std::string& p) {
+    std::error_code ec;
+    fs::path c = fs::weakly_canonical(fs::path(p), ec);
+    return ec ? fs::path(p).generic_string() : c.generic_string();
+}
+
+static std::string hash_hex(const std::string& bytes) {
+    uint64_t h = kFnvOffset;
+    fnv1a64(h, bytes.data(), bytes.size());
+    return hex_u64(h);
+}
+
+// content hash, so editing the dictionary invalidates stored mentions
+static std::string file_fingerprint(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return hash_hex(ss.str());
+}
+
+std::string mention_source(const MentionSetup& s) {
+    if (s.use_llm) {
+        if (!s.llm_mock_dir.empty()) {
+            // a fixture dir or a packed fixture file; editing any fixture changes its stamp
+            const std::string stamps = fs::is_regular_file(s.llm_mock_dir) ? file_stamp(s.llm_mock_dir)
+                                                                           : dir_stamps(s.llm_mock_dir);
+            return "llm_mock:" + canonical_path(s.llm_mock_dir) + "#" + hash_hex(stamps);
+        }
+        return "llm:" + s.llm_model + "#tokens=" + std::to_string(s.llm_posting_tokens) +
+               ",batch=" + std::to_string(s.llm_batch) + "/" + std::to_string(s.llm_batch_tokens) +
+               (s.llm_stream ? "" : ",no_stream");
+    }
+    if (!s.skills_path.empty()) return "regex:" + canonical_path(s.skills_path) + "#" + file_fingerprint(s.skills_path);
+    return "regex";
+}
@@ -0,0 +1,205 @@
+#include "jobs/PostingShrinker.hpp"
+#include "emb/WordPieceTokenizer.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+
+// section ranks; a posting's title (its first line, or a title-length head of it when
+// the posting is flattened onto one line) always ranks highest
+static const int kRankTitle = 5;
+static const int kRankRequirements = 4;
+static const int kRankDuties = 3;
+static const int kRankPlain = 1;
+static const int kRankBoilerplate = 0;
+
+// lines longer than this are split into sentences (a sentence longer than this at the
+// last space before it), so a section that starts mid-line gets pieces of its own
+static const size_t kMaxPiece = 600;
+
+// a line this short that names a section is a heading: it ranks the lines below it.
+// Flattened postings put headings inline, so a piece opening with one does the same.
+static const size_t kMaxHeadingLine = 80;
+static const size_t kHeadingLead = 40;
+
+struct Heading {
+    std::string_view text;
+    int rank;
+};
+
+static const Heading kHeadings[] = {
+    {"requirements", kRankRequirements}, {"requirement", kRankRequirements},
+    {"qualifications", kRankRequirements}, {"qualification", kRankRequirements},
+    {"required", kRankRequirements}, {"must have", kRankRequirements}, {"you have", kRankRequirements},
+    {"what you bring", kRankRequirements}, {"what you'll bring", kRankRequirements},
+    {"skills", kRankRequirements}, {"experience with", kRankRequirements},
+
+    {"responsibilities", kRankDuties}, {"responsibility", kRankDuties}, {"duties", kRankDuties},
+    {"what you will do", kRankDuties}, {"what you'll do", kRankDuties},
+    {"preferred", kRankDuties}, {"nice to have", kRankDuties}, {"nice-to-have", kRankDuties},
+
+    {"benefits", kRankBoilerplate}, {"perks", kRankBoilerplate}, {"about us", kRankBoilerplate},
+    {"about the company", kRankBoilerplate}, {"who we are", kRankBoilerplate},
+    {"equal opportunity", kRankBoilerplate}, {"eeo", kRankBoilerplate}, {"privacy", kRankBoilerplate},
+    {"compensation", kRankBoilerplate}, {"legal", kRankBoilerplate},
+};
+
+static std::vector<std::string> heading_patterns() {
+    std::vector<std::string> out;
+    for (const auto& h : kHeadings) out.emplace_back(h.text);
+    return out;
+}
+
+static bool is_word_char(char c) {
+    return std::isalnum((unsigned char)c) != 0;
+}
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+PostingShrinker::PostingShrinker(size_t token_budget, TokenCounter count)
+    : m_budget(token_budget), m_count(std::move(count)), m_headings(heading_patterns()) {
+    for (const auto& h : kHeadings) m_rank.push_back((int8_t)h.rank);
+}
+
+PostingShrinker PostingShrinker::with_vocab(const std::string& vocab_path, size_t token_budget) {
+    auto tok = std::make_shared<WordPieceTokenizer>();
+    if (!tok->load_vocab(vocab_path)) return PostingShrinker(token_budget);
+    return PostingShrinker(token_budget, [tok](std::string_view s) { return tok->count_tokens(std::string(s)); });
+}
+
+size_t PostingShrinker::count_tokens(std::string_view s) const {
+    if (m_count) return m_count(s);
+    return (s.size() + 3) / 4;
+}
+
+// sentence end at k: punctuation then a space, or a period run into the next sentence
+// ("approval.As required") as flattened postings often have
+static bool sentence_end(const std::string& s, size_t k) {
+    const char c = s[k];
+    if (c != '.' && c != '!' && c != '?' && c != ';') return false;
+    if (k + 1 >= s.size()) return true;
+    const unsigned char next = (unsigned char)s[k + 1];
+    if (is_space((char)next)) return true;
+    return c != ';' && std::isupper(next) && k > 0 && std::islower((unsigned char)s[k - 1]);
+}
+
+// best rank among whole-word section keywords in s; boilerplate only wins when nothing
+// else matched. first = where the earliest keyword starts (npos: none).
+int PostingShrinker::heading_rank(std::string_view s, size_t& first) const {
+    int best = -1;
+    bool boiler = false;
+    first = std::string_view::npos;
+    m_headings.scan(s, [&](size_t pos, uint32_t p) {
+        const size_t end = pos + m_headings.pattern_len(p);
+        if (pos > 0 && is_word_char(s[pos - 1])) return;
+        if (end < s.size() && is_word_char(s[end])) return;
+        first = std::min(first, pos);
+        if (m_rank[p] == kRankBoilerplate) boiler = true;
+        else best = std::max(best, (int)m_rank[p]);
+    });
+    if (best >= 0) return best;
+    return boiler ? kRankBoilerplate : kRankPlain;
+}
+
+std::vector<PostingShrinker::Piece> PostingShrinker::split(const std::string& raw) const {
+    std::vector<Piece> pieces;
+    int section = kRankPlain;
+    size_t line_no = 0;
+
+    size_t i = 0;
+    while (i < raw.size()) {
+        size_t eol = raw.find('\n', i);
+        if (eol == std::string::npos) eol = raw.size();
+
+        size_t b = i, e = eol;
+        while (b < e && is_space(raw[b])) ++b;
+        while (e > b && is_space(raw[e - 1])) --e;
+        i = eol + 1;
+        if (b == e) continue;
+
+        const std::string_view line(raw.data() + b, e - b);
+        size_t first = 0;
+        const int rank = heading_rank(line, first);
+        if (first != std::string_view::npos && line.size() <= kMaxHeadingLine) section = rank;
+
+        // sentence-sized pieces, each ranked by its own keywords or the section it is in
+        size_t s = b;
+        while (s < e) {
+            // the title: all of a short first line; of a long one (a flattened posting,
+            // everything on one line) only a heading-length head, so the rest is ranked
+            // by its own sections instead of riding on the title's rank
+            const bool title = line_no == 0 && s == b;
+            size_t t = e;
+            if (title && e - s > kMaxHeadingLine) {
+                t = raw.rfind(' ', s + kMaxHeadingLine);
+                if (t == std::string::npos || t <= s) t = s + kMaxHeadingLine;
+            } else if (e - b > kMaxPiece) {
+                // a long line: one sentence at a time
+                t = s;
+                for (size_t k = s; k + 1 < e && k - s < kMaxPiece; ++k) {
+                    if (sentence_end(raw, k)) {
+                        t = k + 1;
+                        break;
+                    }
+                }
+                if (t == s && e - s <= kMaxPiece) {
+                    t = e; // the line's last sentence
+                } else if (t == s) { // no sentence end: cut at the last space
+                    t = raw.rfind(' ', s + kMaxPiece);
+                    if (t == std::string::npos || t <= s) t = s + kMaxPiece;
+                }
+            }
+
+            Piece pc;
+            pc.begin = s;
+            pc.end = t;
+            pc.line = line_no;
+            size_t at = 0;
+            const int r = heading_rank(std::string_view(raw.data() + s, t - s), at);
+            if (at != std::string_view::npos && at < kHeadingLead) section = r;
+            pc.rank = at != std::string_view::npos ? r : section;
+            if (title) pc.rank = kRankTitle;
+            pc.tokens = count_tokens(std::string_view(raw.data() + s, t - s));
+            pieces.push_back(pc);
+
+            s = t;
+            while (s < e && is_space(raw[s])) ++s;
+        }
+        ++line_no;
+    }
+    return pieces;
+}
+
+std::string PostingShrinker::shrink(const std::string& raw) const {
+    std::vector<Piece> pieces = split(raw);
+
+    size_t total = 0;
+    for (const auto& p : pieces) total += p.tokens;
+    if (total <= m_budget) return raw;
+
+    // best rank first, earlier first within a rank; skip what no longer fits
+    std::vector<size_t> order(pieces.size());
+    for (size_t k = 0; k < order.size(); ++k) order[k] = k;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return pieces[a].rank > pieces[b].rank; });
+
+    std::vector<uint8_t> keep(pieces.size(), 0);
+    size_t used = 0;
+    for (size_t k : order) {
+        if (used + pieces[k].tokens > m_budget) continue;
+        used += pieces[k].tokens;
+        keep[k] = 1;
+    }
+
+    std::string out;
+    out.reserve(raw.size());
+    size_t prev = (size_t)-1;
+    for (size_t k = 0; k < pieces.size(); ++k) {
+        if (!keep[k]) continue;
+        if (!out.empty()) out += (prev + 1 == k && pieces[prev].line == pieces[k].line) ? ' ' : '\n';
+        out.append(raw, pieces[k].begin, pieces[k].end - pieces[k].begin);
+        prev = k;
+    }
+    return out;
+}
@@ -0,0 +1,151 @@
+#include "jobs/ProfileCache.hpp"
+#include "io/FileStamp.hpp"
+#include "io/Hash.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// bump when analyze's profile output changes shape
+static const char* kKeyVersion = "profile_v1";
+
+static const char* kFiles[] = {"profile.json", "mentions.jsonl"};
+
+static std::string canonical_path(const std::string& p) {
+    std::error_code ec;
+    fs::path c = fs::weakly_canonical(fs::path(p), ec);
+    return ec ? fs::path(p).generic_string() : c.generic_string();
+}
+
+static std::string file_contents(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// the directory and every regular file's name and stamp (io/FileStamp)
+static void hash_dir(uint64_t& h, const std::string& dir) {
+    hash_str(h, canonical_path(dir));
+    hash_str(h, dir_stamps(dir));
+}
+
+std::string ProfileCache::fingerprint(const ProfileKey& k) {
+    uint64_t h = kFnvOffset;
+
+    hash_str(h, kKeyVersion);
+    hash_str(h, k.role);
+    hash_dir(h, k.jobs_dir);
+    hash_str(h, canonical_path(k.emb_path));
+    hash_str(h, file_stamp(k.emb_path));
+    hash_str(h, std::to_string(k.topk));
+
+    std::ostringstream ms;
+    ms.precision(17);
+    ms << k.min_score;
+    hash_str(h, ms.str());
+
+    if (k.use_llm) {
+        hash_str(h, "llm");
+        if (!k.llm_replay.empty()) {
+            hash_str(h, "replay");
+            hash_str(h, canonical_path(k.llm_replay));
+            hash_str(h, file_stamp(k.llm_replay));
+        } else if (k.llm_mock_dir.empty()) {
+            hash_str(h, k.llm_model);
+            hash_str(h, std::to_string(k.llm_posting_tokens));
+            hash_str(h, std::to_string(k.llm_batch));
+            hash_str(h, std::to_string(k.llm_batch_tokens));
+            hash_str(h, k.llm_stream ? "stream" : "no_stream");
+        } else if (fs::is_regular_file(k.llm_mock_dir)) {
+            // packed fixtures (llm-mock pack)
+            hash_str(h, canonical_path(k.llm_mock_dir));
+            hash_str(h, file_stamp(k.llm_mock_dir));
+        } else {
+            hash_dir(h, k.llm_mock_dir);
+        }
+        if (k.llm_hybrid) {
+            std::ostringstream cs;
+            cs.precision(17);
+            cs << k.llm_min_confidence;
+            hash_str(h, "hybrid");
+            hash_str(h, cs.str());
+            hash_str(h, k.skills_path.empty() ? std::string() : file_contents(k.skills_path));
+        }
+    } else {
+        hash_str(h, "regex");
+        hash_str(h, k.skills_path.empty() ? std::string() : file_contents(k.skills_path));
+    }
+
+    return hex_u64(h);
+}
+
+bool ProfileCache::restore(const std::string& fp, const fs::path& outdir) const {
+    if (!enabled()) return false;
+
+    const fs::path entry = fs::path(m_dir) / fp;
+    for (const char* f : kFiles) {
+        std::error_code ec;
+        if (!fs::is_regular_file(entry / f, ec)) return false;
+    }
+
+    std::error_code ec;
+    fs::create_directories(outdir, ec);
+    for (const char* f : kFiles) {
+        fs::copy_file(entry / f, outdir / f, fs::copy_options::overwrite_existing, ec);
+        if (ec) return false;
+    }
+    return true;
+}
+
+bool ProfileCache::store(const std::string& fp, const fs::path& outdir, const ProfileKey& key) const {
+    if (!enabled()) return false;
+
+    const fs::path entry = fs::path(m_dir) / fp;
+
+    // build the entry under a private name, then rename it into place, so concurrent
+    // runs never see (or produce) a half-written entry
+    std::random_device rd;
+    const fs::path tmp = fs::path(m_dir) / (fp + ".tmp-" + hex_u64(((uint64_t)rd() << 32) ^ rd()));
+
+    std::error_code ec;
+    fs::create_directories(tmp, ec);
+    if (ec) return false;
+
+    bool ok = true;
+    for (const char* f : kFiles) {
+        fs::copy_file(outdir / f, tmp / f, fs::copy_options::overwrite_existing, ec);
+        if (ec) { ok = false; break; }
+    }
+
+    if (ok) {
+        std::ofstream kf(tmp / "key.txt", std::ios::out | std::ios::trunc);
+        kf << "role: " << key.role << "\n"
+           << "jobs: " << canonical_path(key.jobs_dir) << "\n"
+           << "emb: " << canonical_path(key.emb_path) << "\n"
+           << "topk: " << key.topk << "\n"
+           << "min_score: " << key.min_score << "\n"
+           << "llm: " << (key.use_llm ? (key.llm_mock_dir.empty() ? key.llm_model : "mock:" + key.llm_mock_dir) : "off") << "\n";
+        if (key.use_llm && key.llm_mock_dir.empty() && key.llm_replay.empty()) {
+            kf << "llm_request: " << key.llm_posting_tokens << " tokens/posting, batch " << key.llm_batch << " ("
+               << key.llm_batch_tokens << " tokens)" << (key.llm_stream ? "" : ", no stream") << "\n";
+        }
+        if (key.llm_hybrid) kf << "hybrid: below " << key.llm_min_confidence << "\n";
+        if (!key.llm_replay.empty()) kf << "replay: " << key.llm_replay << "\n";
+        kf
+           << "skills: " << (key.skills_path.empty() ? "built-in" : key.skills_path) << "\n";
+        kf.close();
+        ok = !kf.fail();
+    }
+
+    if (ok) {
+        fs::rename(tmp, entry, ec);
+        // same fingerprint, same content: losing the race to another run is fine
+        ok = !ec || fs::is_regular_file(entry / kFiles[0]);
+    }
+    fs::remove_all(tmp, ec);
+    return ok;
+}
@@ -1,21 +1,21 @@
 #include "jobs/RequirementExtractor.hpp"
+#include "jobs/KeywordScanner.hpp"
 #include "jobs/TextUtil.hpp"
 #include <algorithm>
 #include <cctype>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 static void add_unique(std::vector<std::string>& out, std::unordered_set<std::string>& seen, const std::string& item) {
     if (seen.insert(item).second) out.push_back(item);
 }
 
-std::string RequirementExtractor::to_lower_ascii(const std::string& s) {
-    std::string out = s;
-    for (unsigned char& c : reinterpret_cast<std::basic_string<unsigned char>&>(out)) {
-        c = static_cast<unsigned char>(std::tolower(c));
-    }
-    return out;
-}
-
 std::string RequirementExtractor::trim(const std::string& s) {
     size_t i = 0, j = s.size();
     while (i < j && std::isspace((unsigned char)s[i])) ++i;
@@ -50,34 +50,16 @@ RequirementExtractor::SectionSlices RequirementExtractor::slice_requirement_sect
 
     auto lines = split_lines(raw_text);
 
-    auto is_heading = [](const std::string& line_lc) -> bool {
-        // normalize common heading patterns
-        // (keep this simple: it’s Day 2, not a full parser)
-        if (line_lc == "requirements" || line_lc == "requirements:" ||
-            line_lc == "qualifications" || line_lc == "qualifications:" ||
-            line_lc == "skills" || line_lc == "skills:" ||
-            line_lc == "what you bring" || line_lc == "what you bring:" ||
-            line_lc == "what you will bring" || line_lc == "what you will bring:" ||
-            line_lc == "what we're looking for" || line_lc == "what we're looking for:" ||
-            line_lc == "what we are looking for" || line_lc == "what we are looking for:" ||
-            line_lc == "must have" || line_lc == "must have:" ||
-            line_lc == "minimum qualifications" || line_lc == "minimum qualifications:" ||
-            line_lc == "required qualifications" || line_lc == "required qualifications:") {
-            return true;
-        }
-        return false;
-    };
-
-    auto is_preferred_heading = [](const std::string& line_lc) -> bool {
-        if (line_lc == "preferred" || line_lc == "preferred:" ||
-            line_lc == "preferred qualifications" || line_lc == "preferred qualifications:" ||
-            line_lc == "nice to have" || line_lc == "nice to have:" ||
-            line_lc == "bonus" || line_lc == "bonus:" ||
-            line_lc == "bonus points" || line_lc == "bonus points:" ||
-            line_lc == "assets" || line_lc == "assets:" ) {
-            return true;
-        }
-        return false;
+    // Section headings, matched against the whole trimmed line (case-insensitive,
+    // optional trailing ':'). The first kMustHeadings patterns open the must section.
+    // (keep this simple: it’s Day 2, not a full parser)
+    static constexpr int kMustHeadings = 10;
+    static const textutil::KeywordScanner headings{
+        "requirements", "qualifications", "skills", "what you bring", "what you will bring",
+        "what we're looking for", "what we are looking for", "must have",
+        "minimum qualifications", "required qualifications",
+        // preferred
+        "preferred", "preferred qualifications", "nice to have", "bonus", "bonus points", "assets"
     };
 
     enum class Mode { None, Must, Preferred };
@@ -96,7 +78,6 @@ RequirementExtractor::SectionSlices RequirementExtractor::slice_requirement_sect
 
     for (size_t i = 0; i < lines.size(); ++i) {
         std::string t = trim(lines[i]);
-        std::string lc = to_lower_ascii(t);
 
         if (t.empty()) {
             blank_run++;
@@ -107,20 +88,17 @@ RequirementExtractor::SectionSlices RequirementExtractor::slice_requirement_sect
         blank_run = 0;
 
         // some headings show as "REQUIREMENTS" etc.
-        std::string lc_compact = lc;
-        // collapse trailing ":" already handled via equality checks, keep simple
+        std::string_view head(t);
+        if (head.back() == ':') head.remove_suffix(1);
 
-        if (is_heading(lc_compact)) {
-            mode = Mode::Must;
-            continue;
-        }
-        if (is_preferred_heading(lc_compact)) {
-            mode = Mode::Preferred;
+        const int h = headings.find_exact(head);
+        if (h >= 0) {
+            mode = (h < kMustHeadings) ? Mode::Must : Mode::Preferred;
             continue;
         }
 
         // If line looks like a heading (short, ends with ":"), stop current section.
-        if (lc.size() <= 40 && !lc.empty() && lc.back() == ':') {
+        if (t.size() <= 40 && t.back() == ':') {
             mode = Mode::None;
             continue;
         }
@@ -132,28 +110,8 @@ RequirementExtractor::SectionSlices RequirementExtractor::slice_requirement_sect
     return out;
 }
 
-bool RequirementExtractor::contains_phrase(const std::string& normalized_haystack, const std::string& normalized_phrase) {
-    // normalized_* are expected to be space-separated lowercase already (via textutil::normalize)
-    // enforce word-ish boundaries by padding spaces
-    std::string h = " " + normalized_haystack + " ";
-    std::string p = " " + normalized_phrase + " ";
-    return h.find(p) != std::string::npos;
-}
-
-ExtractedReqs RequirementExtractor::extract(const std::string& raw_text) const {
-    // Build two candidate texts:
-    // - section text (must/preferred) if present
-    // - full text fallback
-    auto slices = slice_requirement_sections(raw_text);
-
-    std::string norm_all = textutil::normalize(raw_text);
-    std::string norm_must = textutil::normalize(slices.must);
-    std::string norm_pref = textutil::normalize(slices.preferred);
-
-    // Day 2: hardcoded lexicon + simple phrase matching.
-    // Later (Day 5+) you can swap this for:
-    // - config json
-    // - OR a GPT adapter that proposes candidates + you verify deterministically.
+RequirementExtractor::RequirementExtractor() {
+    // Day 2: hardcoded lexicon; a dictionary file adds to it (see load_dictionary).
     struct Item { const char* canon; const char* phrase; };
 
     struct Cat {
@@ -228,39 +186,305 @@ ExtractedReqs RequirementExtractor::extract(const std::string& raw_text) const {
         }},
     };
 
-    ExtractedReqs out;
-    out.by_category.reserve(cats.size() + 1);
+    std::vector<std::string> names;
+    std::vector<Entry> entries;
+    for (const auto& cat : cats) {
+        const uint32_t ci = (uint32_t)names.size();
+        names.push_back(cat.name);
+        for (const auto& it : cat.items) entries.push_back({ci, it.canon, textutil::normalize(it.phrase)});
+    }
+    compile(std::move(names), std::move(entries));
+}
+
+static std::vector<std::string> split_tabs(const std::string& line) {
+    std::vector<std::string> f;
+    size_t i = 0;
+    while (true) {
+        size_t j = line.find('\t', i);
+        f.push_back(line.substr(i, j == std::string::npos ? std::string::npos : j - i));
+        if (j == std::string::npos) break;
+        i = j + 1;
+    }
+    return f;
+}
+
+bool RequirementExtractor::load_dictionary(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    // start from the current lexicon; compile() only runs once the whole file parsed
+    std::vector<std::string> cats = m_cats;
+    std::unordered_map<std::string, uint32_t> cat_index;
+    for (size_t c = 0; c < cats.size(); ++c) cat_index.emplace(cats[c], (uint32_t)c);
+    std::vector<Entry> entries = m_entries;
+
+    std::unordered_set<std::string> known; // cat \t canon \t phrase
+    auto key = [](uint32_t cat, const std::string& canon, const std::string& phrase) {
+        return std::to_string(cat) + '\t' + canon + '\t' + phrase;
+    };
+    for (const Entry& e : entries) known.insert(key(e.cat, e.canon, e.phrase));
+
+    size_t listed = 0;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string t = trim(line);
+        if (t.empty() || t[0] == '#') continue;
+
+        auto f = split_tabs(t);
+        if (f.size() < 3) return false;
+
+        std::string cat = trim(f[0]);
+        std::string canon = trim(f[1]);
+        if (cat.empty() || canon.empty()) return false;
+
+        auto [it, added] = cat_index.emplace(cat, (uint32_t)cats.size());
+        if (added) cats.push_back(cat);
+
+        for (size_t k = 2; k < f.size(); ++k) {
+            std::string phrase = textutil::normalize(f[k]);
+            if (phrase.empty()) continue;
+            ++listed;
+            if (known.insert(key(it->second, canon, phrase)).second) entries.push_back({it->second, canon, std::move(phrase)});
+        }
+    }
+
+    if (listed == 0) return false;
+    compile(std::move(cats), std::move(entries));
+    return true;
+}
+
+void RequirementExtractor::compile(std::vector<std::string> cats, std::vector<Entry> entries) {
+    // categories print in order, so keep each category's entries together
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Entry& a, const Entry& b) { return a.cat < b.cat; });
+
+    // one pattern per distinct phrase, padded with spaces so it only matches whole
+    // tokens of normalized (space-separated) text
+    std::vector<std::string> patterns;
+    std::unordered_map<std::string, uint32_t> pattern_index;
+    m_phrase_entries.clear();
+
+    for (size_t e = 0; e < entries.size(); ++e) {
+        std::string pat = " " + entries[e].phrase + " ";
+        auto [it, added] = pattern_index.emplace(pat, (uint32_t)patterns.size());
+        if (added) {
+            patterns.push_back(std::move(pat));
+            m_phrase_entries.emplace_back();
+        }
+        m_phrase_entries[it->second].push_back((uint32_t)e);
+    }
+
+    m_matcher = std::make_shared<const textutil::KeywordScanner>(patterns);
+    m_cats = std::move(cats);
+    m_entries = std::move(entries);
+}
+
+ExtractedReqs RequirementExtractor::extract(const std::string& raw_text) const {
+    // Build two candidate texts:
+    // - section text (must/preferred) if present
+    // - full text fallback
+    auto slices = slice_requirement_sections(raw_text);
+
+    // Sections are normalized line by line (the same text as normalizing them whole:
+    // lines join with one space), remembering where each line starts, so a match can
+    // be charged to its line for confidence().
+    struct Section {
+        std::string norm;
+        std::vector<size_t> line_start;
+        std::vector<char> line_hit;
+    };
+    auto normalize_section = [](const std::string& text) {
+        Section sec;
+        size_t b = 0;
+        while (b < text.size()) {
+            size_t e = text.find('\n', b);
+            if (e == std::string::npos) e = text.size();
+            const std::string line = textutil::normalize(text.substr(b, e - b));
+            if (!line.empty()) {
+                if (!sec.norm.empty()) sec.norm += ' ';
+                sec.line_start.push_back(sec.norm.size());
+                sec.norm += line;
+            }
+            b = e + 1;
+        }
+        sec.line_hit.assign(sec.line_start.size(), 0);
+        return sec;
+    };
+
+    Section sec_must = normalize_section(slices.must);
+    Section sec_pref = normalize_section(slices.preferred);
+
+    // lexicon entries with a phrase in `norm`, ascending (= lexicon order)
+    auto matched_entries = [&](const std::string& norm, Section* sec) {
+        std::vector<uint32_t> hit;
+        const std::string padded = " " + norm + " ";
+        m_matcher->scan(padded, [&](size_t pos, uint32_t p) {
+            hit.insert(hit.end(), m_phrase_entries[p].begin(), m_phrase_entries[p].end());
+            if (sec) {
+                // the pattern's leading space sits at `pos` in `padded`, so its phrase starts at `pos` in norm
+                auto it = std::upper_bound(sec->line_start.begin(), sec->line_start.end(), pos);
+                if (it != sec->line_start.begin()) sec->line_hit[(size_t)(it - sec->line_start.begin()) - 1] = 1;
+            }
+        });
+        std::sort(hit.begin(), hit.end());
+        hit.erase(std::unique(hit.begin(), hit.end()), hit.end());
+        return hit;
+    };
+
+    // prefer section hits if sections exist, otherwise full-text is all we have
+    const std::vector<uint32_t> must = sec_must.norm.empty() ? matched_entries(textutil::normalize(raw_text), nullptr)
+                                                             : matched_entries(sec_must.norm, &sec_must);
+    const std::vector<uint32_t> pref = sec_pref.norm.empty() ? std::vector<uint32_t>{}
+                                                             : matched_entries(sec_pref.norm, &sec_pref);
+
+    std::vector<std::vector<std::string>> hits(m_cats.size());
 
     // We keep “preferred/nice-to-have” separate, because postings often list extras there.
     std::vector<std::string> nice_to_have;
     std::unordered_set<std::string> nice_seen;
 
-    for (const auto& cat : cats) {
-        std::vector<std::string> hits;
-        std::unordered_set<std::string> seen;
-
-        for (const auto& it : cat.items) {
-            // prefer section hits if sections exist, otherwise full-text is all we have
-            bool in_must = !norm_must.empty() && contains_phrase(norm_must, it.phrase);
-            bool in_pref = !norm_pref.empty() && contains_phrase(norm_pref, it.phrase);
-            bool in_any  = contains_phrase(norm_all, it.phrase);
-
-            if (in_must || (norm_must.empty() && in_any)) {
-                add_unique(hits, seen, it.canon);
-            } else if (in_pref) {
-                add_unique(nice_to_have, nice_seen, it.canon);
-            } else if (norm_must.empty() && in_any) {
-                // (already handled above, but keep for clarity)
-                add_unique(hits, seen, it.canon);
-            }
+    // walk both lists in lexicon order
+    size_t i = 0, j = 0;
+    while (i < must.size() || j < pref.size()) {
+        const uint32_t e = (j == pref.size() || (i < must.size() && must[i] <= pref[j])) ? must[i] : pref[j];
+        const bool in_must = i < must.size() && must[i] == e;
+        if (in_must) ++i;
+        if (j < pref.size() && pref[j] == e) ++j;
+
+        const Entry& it = m_entries[e];
+        if (in_must) {
+            auto& h = hits[it.cat];
+            if (std::find(h.begin(), h.end(), it.canon) == h.end()) h.push_back(it.canon);
+        } else {
+            add_unique(nice_to_have, nice_seen, it.canon);
         }
+    }
 
-        out.by_category.push_back({cat.name, std::move(hits)});
+    ExtractedReqs out;
+    out.by_category.reserve(m_cats.size() + 1);
+    for (size_t c = 0; c < m_cats.size(); ++c) {
+        out.by_category.push_back({m_cats[c], std::move(hits[c])});
     }
 
     if (!nice_to_have.empty()) {
         out.by_category.push_back({"nice_to_have", std::move(nice_to_have)});
     }
 
+    for (const Section* sec : {&sec_must, &sec_pref}) {
+        out.section_lines += sec->line_hit.size();
+        out.covered_lines += (size_t)std::count(sec->line_hit.begin(), sec->line_hit.end(), 1);
+    }
+    for (const auto& [cat, items] : out.by_category) out.skills += items.size();
+
+    return out;
+}
+
+double RequirementExtractor::confidence(const ExtractedReqs& r) {
+    // eight known skills make a well-described posting; a few requirement lines the
+    // lexicon can't place (soft skills, domain knowledge) are fine, most of them aren't
+    static constexpr double kSkillsForFull = 8.0;
+
+    const double skills = std::min(1.0, (double)r.skills / kSkillsForFull);
+    if (r.section_lines == 0) return 0.6 * skills;
+
+    const double coverage = (double)r.covered_lines / (double)r.section_lines;
+    return std::min(1.0, 0.25 + 0.5 * coverage + 0.25 * skills);
+}
+
+void RequirementExtractor::extract_batch(size_t n,
+                                         const std::function<std::string(size_t)>& load,
+                                         const std::function<void(size_t, ExtractedReqs&)>& on_result,
+                                         size_t threads) const {
+    if (n == 0) return;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, n);
+
+    // results wait in a ring until every earlier index has been handed to on_result;
+    // workers do not claim an index more than `window` ahead of the emitter
+    const size_t window = threads * 16;
+    std::vector<std::optional<ExtractedReqs>> ring(window);
+
+    std::mutex mu;
+    std::condition_variable ready_cv; // a result landed (or the batch failed)
+    std::condition_variable space_cv; // the emitter advanced (or the batch failed)
+    size_t next_claim = 0;
+    size_t emitted = 0;
+    bool failed = false;
+    std::exception_ptr error;
+
+    auto fail = [&](std::exception_ptr e) {
+        std::lock_guard<std::mutex> lk(mu);
+        if (!error) error = e;
+        failed = true;
+        ready_cv.notify_all();
+        space_cv.notify_all();
+    };
+
+    auto worker = [&]() {
+        while (true) {
+            size_t i = 0;
+            {
+                std::unique_lock<std::mutex> lk(mu);
+                space_cv.wait(lk, [&] { return failed || next_claim >= n || next_claim < emitted + window; });
+                if (failed || next_claim >= n) return;
+                i = next_claim++;
+            }
+
+            ExtractedReqs r;
+            try {
+                r = extract(load(i));
+            } catch (...) {
+                fail(std::current_exception());
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lk(mu);
+                ring[i % window] = std::move(r);
+            }
+            ready_cv.notify_one();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (size_t t = 0; t < threads; ++t) pool.emplace_back(worker);
+
+    while (emitted < n) {
+        ExtractedReqs r;
+        {
+            std::unique_lock<std::mutex> lk(mu);
+            ready_cv.wait(lk, [&] { return failed || ring[emitted % window].has_value(); });
+            if (failed) break;
+            r = std::move(*ring[emitted % window]);
+            ring[emitted % window].reset();
+        }
+
+        try {
+            on_result(emitted, r);
+        } catch (...) {
+            fail(std::current_exception());
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            ++emitted;
+        }
+        space_cv.notify_all();
+    }
+
+    for (auto& t : pool) t.join();
+    if (error) std::rethrow_exception(error);
+}
+
+std::vector<ExtractedReqs> RequirementExtractor::extract_batch(const std::vector<std::string>& texts, size_t threads) const {
+    std::vector<ExtractedReqs> out(texts.size());
+    extract_batch(
+        texts.size(),
+        [&](size_t i) { return texts[i]; },
+        [&](size_t i, ExtractedReqs& r) { out[i] = std::move(r); },
+        threads);
     return out;
 }
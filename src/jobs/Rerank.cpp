@@ -0,0 +1,136 @@
+#include "jobs/Rerank.hpp"
+
+#include <algorithm>
+
+using textutil::TokenId;
+using textutil::TokenSpan;
+
+void RerankColumns::clear() {
+    for (auto* v : {&body, &title, &lead, &req}) v->clear();
+    has_title.clear();
+    emb_score.clear();
+}
+
+void RerankColumns::push(TokenSpan body_toks, TokenSpan title_toks, TokenSpan lead_toks,
+                         TokenSpan req_toks, bool has_title_zone, float emb) {
+    body.push_back(body_toks);
+    title.push_back(title_toks);
+    lead.push_back(lead_toks);
+    req.push_back(req_toks);
+    has_title.push_back(has_title_zone ? 1 : 0);
+    emb_score.push_back(emb);
+}
+
+RerankScorer::RerankScorer(TokenSpan q_tokens, const std::vector<TokenId>& top_tokens,
+                           const std::vector<double>& idf, const RerankWeights& w)
+    : m_idf(idf), m_w(w) {
+    // lookups only: an id that was never interned cannot occur in any candidate
+    std::vector<TokenId> cpp, langs;
+    for (const char* t : {"c++", "cpp"}) cpp.push_back(textutil::find_token(t));
+    for (const char* l : {"java","python","ruby","c#","csharp","javascript","typescript","php","scala","kotlin","golang","go"}) {
+        langs.push_back(textutil::find_token(l));
+    }
+
+    size_t n = idf.size();
+    auto cover = [&](TokenId t) { if (t != textutil::kNoToken) n = std::max(n, (size_t)t + 1); };
+    for (TokenId t : q_tokens) cover(t);
+    for (TokenId t : top_tokens) cover(t);
+    for (TokenId t : cpp) cover(t);
+    for (TokenId t : langs) cover(t);
+
+    m_flags.assign(n, 0);
+    auto mark = [&](TokenId t, uint8_t f) { if (t != textutil::kNoToken) m_flags[t] |= f; };
+    for (TokenId t : q_tokens) mark(t, kQuery | kTop);
+    for (TokenId t : top_tokens) mark(t, kTop);
+    for (TokenId t : cpp) mark(t, kCpp);
+    for (TokenId t : langs) mark(t, kLang);
+
+    for (TokenId t : q_tokens) m_wants_cpp = m_wants_cpp || (m_flags[t] & kCpp);
+}
+
+namespace {
+
+struct ZonePass {
+    double query = 0.0; // IDF of query tokens in the zone
+    double top   = 0.0; // IDF of seeded top tokens in the zone
+    uint8_t any  = 0;   // union of the zone's token flags
+};
+
+// unmatched tokens add 0.0, so the sums equal a sum over matched tokens in id order
+template <bool WithTop>
+inline ZonePass zone_pass(TokenSpan toks, const uint8_t* flags, const double* idf, uint8_t kq, uint8_t kt) {
+    ZonePass z;
+    for (TokenId id : toks) {
+        const uint8_t f = flags[id];
+        const double w = idf[id];
+        z.query += (f & kq) ? w : 0.0;
+        if constexpr (WithTop) z.top += (f & kt) ? w : 0.0;
+        z.any |= f;
+    }
+    return z;
+}
+
+}
+
+void RerankScorer::score(RerankColumns& c) const {
+    const size_t n = c.size();
+    const uint8_t* flags = m_flags.data();
+    const double* idf = m_idf.data();
+
+    for (auto* v : {&c.s_title, &c.s_lead, &c.s_req, &c.s_bodyq, &c.base_lex, &c.header, &c.combined}) v->resize(n);
+    for (auto* v : {&c.identity_match, &c.title_conflict, &c.has_cpp}) v->resize(n);
+
+    std::vector<uint8_t> title_any(n), lead_any(n);
+
+    // one column at a time
+    for (size_t i = 0; i < n; ++i) {
+        const ZonePass z = zone_pass<false>(c.title[i], flags, idf, kQuery, kTop);
+        c.s_title[i] = z.query;
+        title_any[i] = z.any;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const ZonePass z = zone_pass<false>(c.lead[i], flags, idf, kQuery, kTop);
+        c.s_lead[i] = z.query;
+        lead_any[i] = z.any;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        c.s_req[i] = zone_pass<false>(c.req[i], flags, idf, kQuery, kTop).query;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const ZonePass z = zone_pass<true>(c.body[i], flags, idf, kQuery, kTop);
+        c.s_bodyq[i] = z.query;
+        c.base_lex[i] = z.top;
+        c.has_cpp[i] = (z.any & kCpp) ? 1 : 0;
+    }
+
+    // flags, identity adjustment and the final scores
+    const RerankWeights& w = m_w;
+    for (size_t i = 0; i < n; ++i) {
+        const bool title_match = c.has_title[i] && (title_any[i] & kQuery);
+        const bool lead_match  = (lead_any[i] & kQuery) != 0;
+        c.identity_match[i] = c.has_title[i] ? (title_match || lead_match) : lead_match;
+
+        const bool title_has_cpp = (title_any[i] & kCpp) != 0;
+        const bool lead_has_cpp  = (lead_any[i] & kCpp) != 0;
+        const bool conflict = m_wants_cpp && !title_has_cpp && (title_any[i] & kLang);
+        c.title_conflict[i] = conflict;
+
+        double identity_adj = 0.0;
+        if (m_wants_cpp) {
+            if (conflict) identity_adj -= w.penalty_title_conflict;
+
+            if (!(title_has_cpp || lead_has_cpp)) identity_adj -= w.penalty_missing_identity;
+            else if (title_has_cpp) identity_adj += w.bonus_identity_in_title;
+        }
+
+        c.header[i] =
+            w.title      * c.s_title[i] +
+            w.lead       * c.s_lead[i]  +
+            w.req        * c.s_req[i]   +
+            w.body_query * c.s_bodyq[i] +
+            w.body_lex   * c.base_lex[i] +
+            identity_adj;
+
+        c.combined[i] = c.header[i] + w.emb * (double)c.emb_score[i];
+    }
+}
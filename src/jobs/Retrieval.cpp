@@ -0,0 +1,212 @@
+#include "jobs/Retrieval.hpp"
+#include "jobs/SymbolTable.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+
+using textutil::TokenId;
+
+static double ms_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static bool tokens_has_any(textutil::TokenSpan toks, const textutil::TokenBitset& need) {
+    return textutil::intersects(toks, need);
+}
+
+bool RetrievalCorpus::load(const std::string& jobs_dir, const std::string& cindex_path) {
+    m_jobs_dir = jobs_dir;
+    std::error_code ec;
+    if (!std::filesystem::is_directory(jobs_dir, ec)) return false;
+
+    m_use_cindex = !cindex_path.empty() && m_cindex.load(cindex_path) && m_cindex.matches(jobs_dir);
+
+    if (m_use_cindex) {
+        m_n = m_cindex.size();
+        m_df = m_cindex.df();
+        return true;
+    }
+
+    m_corpus = JobCorpus::load_from_dir(jobs_dir);
+    m_n = m_corpus.postings().size();
+
+    m_post_index.reserve(m_n);
+    m_post_tokens.reserve(m_n, m_n * 256);
+    for (const auto& p : m_corpus.postings()) {
+        const size_t pi = m_post_tokens.add(body_token_ids(p.raw_text));
+        m_df_local.resize(textutil::SymbolTable::global().size(), 0);
+        for (TokenId tok : m_post_tokens.at(pi)) m_df_local[tok] += 1;
+        m_post_index.emplace(p.id, pi);
+    }
+    m_df = m_df_local;
+    m_zone_memo.assign(m_n, std::nullopt);
+    return m_n > 0;
+}
+
+std::optional<size_t> RetrievalCorpus::find(const std::string& job_id) const {
+    if (m_use_cindex) return m_cindex.find(job_id);
+    auto it = m_post_index.find(job_id);
+    if (it == m_post_index.end()) return std::nullopt;
+    return it->second;
+}
+
+textutil::TokenSpan RetrievalCorpus::body(size_t pi) const {
+    return m_use_cindex ? m_cindex.body(pi) : m_post_tokens.at(pi);
+}
+
+RetrievalCorpus::ZoneToks RetrievalCorpus::zones(size_t pi) const {
+    if (m_use_cindex) return {m_cindex.title(pi), m_cindex.title_toks(pi), m_cindex.lead_toks(pi), m_cindex.req_toks(pi)};
+    auto& f = m_zone_memo[pi];
+    if (!f) f = compute_posting_features(m_corpus.postings()[pi].raw_text);
+    return {f->title, f->title_toks, f->lead_toks, f->req_toks};
+}
+
+const std::string& RetrievalCorpus::text(size_t pi, std::string& buf) const {
+    if (!m_use_cindex) return m_corpus.postings()[pi].raw_text;
+    buf = JobCorpus::read_posting(m_jobs_dir, std::string(m_cindex.id(pi)));
+    return buf;
+}
+
+double RetrievalCorpus::idf(TokenId tok) const {
+    uint32_t d = (tok < m_df.size()) ? m_df[tok] : 0;
+    return std::log((1.0 + (double)m_n) / (1.0 + (double)d));
+}
+
+std::vector<double> RetrievalCorpus::idf_table() const {
+    std::vector<double> tab(textutil::SymbolTable::global().size());
+    for (size_t t = 0; t < tab.size(); ++t) tab[t] = idf((TokenId)t);
+    return tab;
+}
+
+void RetrievalCorpus::warm_zones() const {
+    if (m_use_cindex) return;
+    for (size_t pi = 0; pi < m_n; ++pi) (void)zones(pi);
+}
+
+RetrievalResult retrieve(const RetrievalCorpus& corpus, const EmbeddingIndex& idx,
+                         const std::vector<float>& query, textutil::TokenSpan q_tokens,
+                         const RetrievalConfig& cfg, const std::vector<double>* idf) {
+    RetrievalResult res;
+    auto t0 = std::chrono::steady_clock::now();
+
+    size_t bigk = std::max(cfg.topk, cfg.bigk_floor);
+    auto hits = idx.topk(query, bigk);
+    res.raw_hits = hits.size();
+
+    if (hits.empty()) {
+        res.retrieve_ms = ms_since(t0);
+        return res;
+    }
+
+    textutil::TokenBitset q_bits;
+    for (TokenId qt : q_tokens) q_bits.set(qt);
+
+    // IMPORTANT CHANGE:
+    // Do NOT throw away postings just because embedding is below min_score
+    // if the TITLE / TOP PART matches the query tokens.
+    std::vector<EmbHit> kept;
+    kept.reserve(hits.size());
+    for (const auto& h : hits) {
+        bool keep_by_emb = (h.score >= cfg.min_score);
+
+        bool keep_by_title_or_lead = false;
+        if (auto pi = corpus.find(h.job_id)) {
+            const RetrievalCorpus::ZoneToks z = corpus.zones(*pi);
+
+            // "title/top is first priority": if any query token appears in title OR lead, keep it.
+            // This is what makes your one-line "C++ Backend Engineer" reliably survive filtering.
+            keep_by_title_or_lead = tokens_has_any(z.title_toks, q_bits) || tokens_has_any(z.lead_toks, q_bits);
+        }
+
+        if (keep_by_emb || keep_by_title_or_lead) kept.push_back(h);
+    }
+    res.kept = kept.size();
+    res.retrieve_ms = ms_since(t0);
+
+    if (kept.empty()) return res;
+
+    t0 = std::chrono::steady_clock::now();
+
+    const std::vector<double> idf_own = idf ? std::vector<double>() : corpus.idf_table();
+    const std::vector<double>& idf_tab = idf ? *idf : idf_own;
+
+    // seed top tokens from seed hits (keeps your existing "top_tokens" flavor)
+    const size_t seedN = std::min(cfg.topn_seed, kept.size());
+    std::unordered_map<TokenId, int> tf_top;
+    tf_top.reserve(1024);
+
+    for (size_t i = 0; i < seedN; ++i) {
+        auto pi = corpus.find(kept[i].job_id);
+        if (!pi) continue;
+        for (TokenId tok : corpus.body(*pi)) tf_top[tok] += 1;
+    }
+
+    struct TokScore { TokenId tok; double score; };
+    std::vector<TokScore> scored;
+    scored.reserve(tf_top.size());
+    for (const auto& kv : tf_top) {
+        double s2 = (double)kv.second * corpus.idf(kv.first);
+        if (s2 > 0.0) scored.push_back({kv.first, s2});
+    }
+
+    std::sort(scored.begin(), scored.end(),
+              [](const TokScore& a, const TokScore& b){ return a.score > b.score; });
+
+    if (scored.size() > cfg.topx_tokens) scored.resize(cfg.topx_tokens);
+
+    // query tokens are always part of the lex scoring set (added by the scorer)
+    std::vector<TokenId> top_tokens;
+    for (const auto& ts : scored) top_tokens.push_back(ts.tok);
+
+    // candidates as columns, then one scoring pass per zone
+    RerankColumns cols;
+    std::vector<const std::string*> col_ids;
+    for (const auto& h : kept) {
+        auto pi = corpus.find(h.job_id);
+        if (!pi) continue;
+
+        // zone titles are already trimmed
+        const RetrievalCorpus::ZoneToks z = corpus.zones(*pi);
+        cols.push(corpus.body(*pi), z.title_toks, z.lead_toks, z.req_toks, !z.title.empty(), h.score);
+        col_ids.push_back(&h.job_id);
+    }
+
+    const RerankScorer scorer(q_tokens, top_tokens, idf_tab, cfg.weights);
+    scorer.score(cols);
+
+    std::vector<RankedHit>& ranked = res.ranked;
+    ranked.reserve(cols.size());
+    for (size_t i = 0; i < cols.size(); ++i) {
+        RankedHit rh;
+        rh.job_id = *col_ids[i];
+        rh.emb_score = (double)cols.emb_score[i];
+        rh.lex_score = cols.header[i]; // keep printing as "lex" for continuity
+        rh.combined  = cols.combined[i];
+
+        rh.has_cpp = cols.has_cpp[i] != 0;
+        rh.has_title = cols.has_title[i] != 0;
+        rh.title_conflict = cols.title_conflict[i] != 0;
+        rh.identity_match = cols.identity_match[i] != 0;
+
+        rh.s_title = cols.s_title[i];
+        rh.s_lead  = cols.s_lead[i];
+        rh.s_req   = cols.s_req[i];
+
+        ranked.push_back(std::move(rh));
+    }
+
+    // HARD RULE: title/lead identity matches are always first.
+    // Then sort by the header-first score.
+    std::stable_partition(ranked.begin(), ranked.end(),
+                          [](const RankedHit& r){ return r.identity_match; });
+
+    std::sort(ranked.begin(), ranked.end(),
+              [](const RankedHit& a, const RankedHit& b){ return a.combined > b.combined; });
+
+    if (ranked.size() > cfg.topk) ranked.resize(cfg.topk);
+
+    res.rerank_ms = ms_since(t0);
+    return res;
+}
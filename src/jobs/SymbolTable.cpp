@@ -0,0 +1,45 @@
+#include "jobs/SymbolTable.hpp"
+#include <mutex>
+
+namespace textutil {
+
+SymbolTable& SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+TokenId SymbolTable::intern(std::string_view s) {
+    {
+        std::shared_lock<std::shared_mutex> lk(m_mu);
+        auto it = m_ids.find(s);
+        if (it != m_ids.end()) return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lk(m_mu);
+    auto it = m_ids.find(s);
+    if (it != m_ids.end()) return it->second; // raced with another writer
+
+    const TokenId id = (TokenId)m_by_id.size();
+    const std::string& stored = m_storage.emplace_back(s);
+    m_by_id.push_back(stored);
+    m_ids.emplace(std::string_view(stored), id);
+    return id;
+}
+
+TokenId SymbolTable::find(std::string_view s) const {
+    std::shared_lock<std::shared_mutex> lk(m_mu);
+    auto it = m_ids.find(s);
+    return it == m_ids.end() ? kNoToken : it->second;
+}
+
+std::string_view SymbolTable::str(TokenId id) const {
+    std::shared_lock<std::shared_mutex> lk(m_mu);
+    return id < m_by_id.size() ? m_by_id[id] : std::string_view();
+}
+
+size_t SymbolTable::size() const {
+    std::shared_lock<std::shared_mutex> lk(m_mu);
+    return m_by_id.size();
+}
+
+}
@@ -1,32 +1,133 @@
 #include "jobs/TextUtil.hpp"
-#include <cctype>
+#include <bit>
+#include <cstdint>
+#include <cstring>
 #include <unordered_map>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXTUTIL_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace textutil {
 
+// ---------- ASCII kernel ----------
+// Locale-independent: only 'A'..'Z' are folded, bytes >= 0x80 pass through
+// (same result as std::tolower under the default "C" locale).
+
+static inline unsigned char lower_byte(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+}
+
+static inline bool keep_byte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '+' || c == '#';
+}
+
+#ifdef TEXTUTIL_SSE2
+// lowercase 16 bytes; signed compares leave bytes >= 0x80 untouched
+static inline __m128i lower16(__m128i v) {
+    const __m128i is_upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                           _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+    return _mm_add_epi8(v, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
+}
+
+// bit i set if lowercased byte i is alnum, '+' or '#'
+static inline uint32_t keep_mask16(__m128i lv) {
+    const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lv, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), lv));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(lv, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), lv));
+    const __m128i sym = _mm_or_si128(_mm_cmpeq_epi8(lv, _mm_set1_epi8('+')),
+                                     _mm_cmpeq_epi8(lv, _mm_set1_epi8('#')));
+    return (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(alpha, digit), sym));
+}
+#endif
+
+// Walks `s` as alternating runs of kept bytes (lowercased) and separator bytes.
+// on_keep(const char* p, size_t n) gets each kept run (a run may arrive in several
+// pieces across block boundaries); on_sep() is called at least once per separator run.
+template <typename OnKeep, typename OnSep>
+static void scan_runs(std::string_view s, OnKeep&& on_keep, OnSep&& on_sep) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+    const size_t n = s.size();
+    size_t i = 0;
+
+#ifdef TEXTUTIL_SSE2
+    alignas(16) char lowered[16];
+    for (; i + 16 <= n; i += 16) {
+        const __m128i lv = lower16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+        const uint32_t keep = keep_mask16(lv);
+
+        if (keep == 0) { on_sep(); continue; }
+        _mm_store_si128(reinterpret_cast<__m128i*>(lowered), lv);
+        if (keep == 0xFFFFu) { on_keep(lowered, 16); continue; }
+
+        // mixed block: hop between runs with bit scans instead of testing every byte
+        uint32_t j = 0;
+        while (j < 16) {
+            const uint32_t rest = keep >> j;
+            if (rest & 1u) {
+                const uint32_t run = (uint32_t)std::countr_one(rest);
+                on_keep(lowered + j, run);
+                j += run;
+            } else {
+                on_sep();
+                j += rest ? (uint32_t)std::countr_zero(rest) : 16 - j;
+            }
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        const unsigned char c = lower_byte(p[i]);
+        if (keep_byte(c)) {
+            const char ch = static_cast<char>(c);
+            on_keep(&ch, 1);
+        } else {
+            on_sep();
+        }
+    }
+}
+
+void lower_ascii_inplace(std::string& s) {
+    unsigned char* p = reinterpret_cast<unsigned char*>(s.data());
+    const size_t n = s.size();
+    size_t i = 0;
+#ifdef TEXTUTIL_SSE2
+    for (; i + 16 <= n; i += 16) {
+        __m128i* q = reinterpret_cast<__m128i*>(p + i);
+        _mm_storeu_si128(q, lower16(_mm_loadu_si128(q)));
+    }
+#endif
+    for (; i < n; ++i) p[i] = lower_byte(p[i]);
+}
+
+std::string lower_ascii(std::string_view s) {
+    std::string out(s);
+    lower_ascii_inplace(out);
+    return out;
+}
+
 std::string normalize(const std::string& s) {
     std::string out;
-    out.reserve(s.size());
+    out.resize(s.size());
+    char* w = out.data();
     bool prev_space = true;
 
-    for (unsigned char ch : s) {
-        unsigned char c = static_cast<unsigned char>(std::tolower(ch));
-
-        bool keep =
-            (c >= 'a' && c <= 'z') ||
-            (c >= '0' && c <= '9') ||
-            (c == '+') || (c == '#'); // keeps "c++" and "c#"
-
-        if (keep) {
-            out.push_back(static_cast<char>(c));
+    scan_runs(s,
+        [&](const char* run, size_t len) {
+            std::memcpy(w, run, len);
+            w += len;
             prev_space = false;
-        } else {
+        },
+        [&]() {
             if (!prev_space) {
-                out.push_back(' ');
+                *w++ = ' ';
                 prev_space = true;
             }
-        }
-    }
+        });
+
+    out.resize((size_t)(w - out.data()));
 
     // trim trailing space
     if (!out.empty() && out.back() == ' ') out.pop_back();
@@ -97,4 +198,61 @@ std::vector<std::string> normalize_tokens(const std::vector<std::string>& tokens
     return out;
 }
 
+// mirrors the fold map in normalize_tokens ("server-side" never survives scanning)
+static std::string_view fold_token(std::string_view t) {
+    if (t == "dev" || t == "developer" || t == "programmer" || t == "engineering" || t == "eng") {
+        return "engineer";
+    }
+    if (t == "serverside") return "backend";
+    return t;
+}
+
+void scan_tokens(std::string_view raw, TokenBuffer& out, bool fold) {
+    out.arena.clear();
+    out.tokens.clear();
+    // kept bytes never exceed the input, so the arena never reallocates and views stay valid
+    out.arena.reserve(raw.size());
+
+    std::string_view pending;
+    bool has_pending = false;
+
+    // one-token lookahead for the 2-gram merges in normalize_tokens
+    auto emit = [&](std::string_view t) {
+        if (!fold) {
+            out.tokens.push_back(t);
+            return;
+        }
+        if (has_pending) {
+            if ((pending == "back" && t == "end") || (pending == "server" && t == "side")) {
+                out.tokens.push_back("backend");
+                has_pending = false;
+                return;
+            }
+            out.tokens.push_back(fold_token(pending));
+        }
+        pending = t;
+        has_pending = true;
+    };
+
+    size_t start = 0;
+    auto close_token = [&]() {
+        const size_t len = out.arena.size() - start;
+        if (len == 0) return;
+        // drop tiny tokens (same rule as tokenize); reclaim their bytes
+        if (len >= 2) {
+            emit(std::string_view(out.arena.data() + start, len));
+            start = out.arena.size();
+        } else {
+            out.arena.resize(start);
+        }
+    };
+
+    scan_runs(raw,
+        [&](const char* run, size_t len) { out.arena.append(run, len); },
+        close_token);
+    close_token();
+
+    if (fold && has_pending) out.tokens.push_back(fold_token(pending));
+}
+
 }
@@ -1,31 +1,14 @@
 #include "jobs/TfidfSearch.hpp"
+#include "jobs/SymbolTable.hpp"
 #include "jobs/TextUtil.hpp"
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
-#include <unordered_map>
 
 static double safe_log(double x) {
     return std::log(x);
 }
 
-static void sort_and_merge(std::vector<std::pair<uint32_t, float>>& v) {
-    std::sort(v.begin(), v.end(), [](auto& x, auto& y){ return x.first < y.first; });
-    size_t w = 0;
-    for (size_t i = 0; i < v.size(); ) {
-        uint32_t id = v[i].first;
-        float sum = 0.0f;
-        size_t j = i;
-        while (j < v.size() && v[j].first == id) {
-            sum += v[j].second;
-            ++j;
-        }
-        v[w++] = {id, sum};
-        i = j;
-    }
-    v.resize(w);
-}
-
 double TfidfSearch::dot_sparse(
     const std::vector<std::pair<uint32_t, float>>& a,
     const std::vector<std::pair<uint32_t, float>>& b
@@ -45,44 +28,54 @@ double TfidfSearch::dot_sparse(
     return s;
 }
 
+// (term_id, freq) runs from a token sequence, sorted by term_id
+static std::vector<std::pair<uint32_t, uint32_t>> term_freqs(std::vector<uint32_t>& ids) {
+    std::sort(ids.begin(), ids.end());
+    std::vector<std::pair<uint32_t, uint32_t>> tf;
+    for (size_t i = 0; i < ids.size(); ) {
+        size_t j = i;
+        while (j < ids.size() && ids[j] == ids[i]) ++j;
+        tf.push_back({ids[i], (uint32_t)(j - i)});
+        i = j;
+    }
+    return tf;
+}
+
 TfidfSearch::TfidfSearch(const JobCorpus& corpus) {
     const auto& posts = corpus.postings();
     const uint32_t N = (uint32_t)posts.size();
+    auto& symbols = textutil::SymbolTable::global();
 
-    // Pass 1: build DF + vocab from normalized tokens
-    std::unordered_map<std::string, uint32_t> df_map;
+    // Pass 1: intern tokens, per-posting TF runs, DF over global ids
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> posting_tf;
+    std::vector<size_t> posting_len;
+    posting_tf.reserve(posts.size());
+    posting_len.reserve(posts.size());
 
-    std::vector<std::vector<std::string>> posting_tokens;
-    posting_tokens.reserve(posts.size());
+    textutil::TokenBuffer tb;
+    std::vector<uint32_t> ids;
 
     for (const auto& p : posts) {
-        auto norm = textutil::normalize(p.raw_text);
-        auto toks = textutil::tokenize(norm);
-        posting_tokens.push_back(toks);
+        textutil::scan_tokens(p.raw_text, tb, false);
 
-        // unique terms in this doc for DF
-        std::unordered_map<std::string, bool> seen;
-        seen.reserve(toks.size());
-        for (const auto& t : toks) seen.emplace(t, true);
+        ids.clear();
+        ids.reserve(tb.tokens.size());
+        for (auto t : tb.tokens) ids.push_back(symbols.intern(t));
 
-        for (const auto& kv : seen) {
-            df_map[kv.first] += 1;
-        }
-    }
-
-    // Freeze vocab: assign term_ids
-    m_terms.reserve(df_map.size());
-    m_df.reserve(df_map.size());
+        posting_len.push_back(ids.size());
+        auto tf = term_freqs(ids);
 
-    for (const auto& kv : df_map) {
-        m_term_to_id.emplace(kv.first, (uint32_t)m_terms.size());
-        m_terms.push_back(kv.first);
-        m_df.push_back(kv.second);
+        for (const auto& kv : tf) {
+            if (kv.first >= m_df.size()) m_df.resize((size_t)kv.first + 1, 0);
+            m_df[kv.first] += 1;
+        }
+        posting_tf.push_back(std::move(tf));
     }
 
     // Compute IDF
-    m_idf.resize(m_terms.size());
-    for (size_t term_id = 0; term_id < m_terms.size(); ++term_id) {
+    m_idf.assign(m_df.size(), 0.0);
+    for (size_t term_id = 0; term_id < m_df.size(); ++term_id) {
+        if (m_df[term_id] == 0) continue;
         // smooth: idf = log((N + 1)/(df + 1)) + 1
         double df = (double)m_df[term_id];
         m_idf[term_id] = safe_log(((double)N + 1.0) / (df + 1.0)) + 1.0;
@@ -92,69 +85,48 @@ TfidfSearch::TfidfSearch(const JobCorpus& corpus) {
     m_postings.reserve(posts.size());
 
     for (size_t idx = 0; idx < posts.size(); ++idx) {
-        const auto& p = posts[idx];
-        const auto& toks = posting_tokens[idx];
-
-        std::unordered_map<uint32_t, uint32_t> tf;
-        tf.reserve(toks.size());
-
-        for (const auto& t : toks) {
-            auto it = m_term_to_id.find(t);
-            if (it == m_term_to_id.end()) continue;
-            tf[it->second] += 1;
-        }
+        const auto& tf = posting_tf[idx];
 
         PostingVec pv;
-        pv.job_id = p.id;
-        pv.token_count = toks.size();
+        pv.job_id = posts[idx].id;
+        pv.token_count = posting_len[idx];
 
         pv.weights.reserve(tf.size());
         double norm2 = 0.0;
 
         for (const auto& kv : tf) {
-            uint32_t term_id = kv.first;
-            uint32_t freq = kv.second;
-
             // log TF
-            double w = (1.0 + safe_log((double)freq)) * m_idf[term_id];
-            pv.weights.push_back({term_id, (float)w});
+            double w = (1.0 + safe_log((double)kv.second)) * m_idf[kv.first];
+            pv.weights.push_back({kv.first, (float)w});
             norm2 += w * w;
         }
 
-        sort_and_merge(pv.weights);
         pv.norm = std::sqrt(norm2);
-
         m_postings.push_back(std::move(pv));
     }
 }
 
 std::vector<SearchHit> TfidfSearch::topk(const std::string& query, size_t k) const {
-    auto qnorm = textutil::normalize(query);
-    auto qtoks = textutil::tokenize(qnorm);
-
-    // TF for query
-    std::unordered_map<uint32_t, uint32_t> qtf;
-    qtf.reserve(qtoks.size());
-
-    for (const auto& t : qtoks) {
-        auto it = m_term_to_id.find(t);
-        if (it == m_term_to_id.end()) continue;
-        qtf[it->second] += 1;
+    textutil::TokenBuffer tb;
+    textutil::scan_tokens(query, tb, false);
+
+    // query terms unknown to this corpus are dropped (find() never grows the table)
+    std::vector<uint32_t> ids;
+    ids.reserve(tb.tokens.size());
+    for (auto t : tb.tokens) {
+        textutil::TokenId id = textutil::find_token(t);
+        if (id == textutil::kNoToken || id >= m_df.size() || m_df[id] == 0) continue;
+        ids.push_back(id);
     }
 
     std::vector<std::pair<uint32_t, float>> qvec;
-    qvec.reserve(qtf.size());
-
     double qnorm2 = 0.0;
-    for (const auto& kv : qtf) {
-        uint32_t term_id = kv.first;
-        uint32_t freq = kv.second;
-        double w = (1.0 + safe_log((double)freq)) * m_idf[term_id];
-        qvec.push_back({term_id, (float)w});
+    for (const auto& kv : term_freqs(ids)) {
+        double w = (1.0 + safe_log((double)kv.second)) * m_idf[kv.first];
+        qvec.push_back({kv.first, (float)w});
         qnorm2 += w * w;
     }
 
-    sort_and_merge(qvec);
     double qn = std::sqrt(qnorm2);
     if (qn == 0.0) return {}; // no known terms
 
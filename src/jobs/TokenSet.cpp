@@ -0,0 +1,48 @@
+#include "jobs/TokenSet.hpp"
+#include <algorithm>
+
+namespace textutil {
+
+void sort_unique(std::vector<TokenId>& ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+bool contains(TokenSpan sorted, TokenId id) {
+    return std::binary_search(sorted.begin(), sorted.end(), id);
+}
+
+void TokenBitset::set(TokenId id) {
+    const size_t w = id >> 6;
+    if (w >= m_words.size()) m_words.resize(w + 1, 0);
+    m_words[w] |= (uint64_t)1 << (id & 63);
+}
+
+bool intersects(TokenSpan toks, const TokenBitset& probe) {
+    for (TokenId id : toks) {
+        if (probe.test(id)) return true;
+    }
+    return false;
+}
+
+double weighted_overlap(TokenSpan toks, const TokenBitset& probe, const std::vector<double>& weights) {
+    double s = 0.0;
+    for (TokenId id : toks) {
+        if (probe.test(id)) s += weights[id];
+    }
+    return s;
+}
+
+void PostingTokenSets::reserve(size_t postings, size_t total_ids) {
+    m_offsets.reserve(postings + 1);
+    m_ids.reserve(total_ids);
+}
+
+size_t PostingTokenSets::add(std::vector<TokenId> ids) {
+    sort_unique(ids);
+    m_ids.insert(m_ids.end(), ids.begin(), ids.end());
+    m_offsets.push_back(m_ids.size());
+    return m_offsets.size() - 2;
+}
+
+}
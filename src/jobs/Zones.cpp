@@ -0,0 +1,136 @@
+#include "jobs/Zones.hpp"
+#include "jobs/TextUtil.hpp"
+
+#include <algorithm>
+
+static std::string to_lower_ascii(std::string s) {
+    textutil::lower_ascii_inplace(s);
+    return s;
+}
+
+static std::string trim_ascii(const std::string& s) {
+    size_t i = 0;
+    while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) ++i;
+    size_t j = s.size();
+    while (j > i && (s[j - 1] == ' ' || s[j - 1] == '\t' || s[j - 1] == '\n' || s[j - 1] == '\r')) --j;
+    return s.substr(i, j - i);
+}
+
+static std::string extract_title_from_kv_blob(const std::string& raw) {
+    std::string lower = to_lower_ascii(raw);
+    size_t tpos = lower.find(":title");
+    if (tpos == std::string::npos) return "";
+
+    size_t start = raw.find_first_not_of(" \t\r\n", tpos + 6);
+    if (start == std::string::npos) return "";
+
+    while (start < raw.size() && (raw[start] == ' ' || raw[start] == '\t' || raw[start] == ':')) start++;
+    while (start < raw.size() && (raw[start] == ' ' || raw[start] == '\t')) start++;
+
+    size_t end = raw.find(", :description", start);
+    if (end == std::string::npos) end = raw.find(", :location", start);
+    if (end == std::string::npos) end = raw.find(", :employer", start);
+    if (end == std::string::npos) end = raw.find(", :skills", start);
+    if (end == std::string::npos) end = raw.find('\n', start);
+    if (end == std::string::npos) end = std::min(raw.size(), start + (size_t)160);
+
+    if (end <= start) return "";
+    std::string t = trim_ascii(raw.substr(start, end - start));
+    if (t.size() > 200) t.resize(200);
+    return t;
+}
+
+static std::string extract_title_fallback_line(const std::string& raw) {
+    size_t i = 0;
+    while (i < raw.size() && i < 2000) {
+        size_t j = raw.find('\n', i);
+        if (j == std::string::npos) j = raw.size();
+        std::string line = trim_ascii(raw.substr(i, j - i));
+        if (!line.empty()) {
+            if (line.size() <= 90) return line;
+            break;
+        }
+        i = (j == raw.size()) ? j : j + 1;
+    }
+    return "";
+}
+
+std::string extract_requirements_block(const std::string& raw) {
+    static const HeadingBlocks headings(
+        {"requirements", "requirement", "qualifications", "qualification",
+         "what you bring", "what you'll bring", "skills", "you have", "must have"},
+        {"responsibilities", "responsibility",
+         "benefits", "perks", "about us", "about the company",
+         "equal opportunity", "eeo", "privacy", "legal"});
+
+    std::string out = headings.blocks(raw, 2, 3500);
+    if (out.size() > 6000) out.resize(6000);
+    return out;
+}
+
+Zones extract_zones(const std::string& raw) {
+    Zones z;
+
+    z.title = extract_title_from_kv_blob(raw);
+    if (z.title.empty()) z.title = extract_title_fallback_line(raw);
+
+    // lead: very top of posting, domain-agnostic
+    const size_t LEAD_CAP = 1400;
+    if (!raw.empty()) {
+        size_t cap = std::min(raw.size(), LEAD_CAP);
+        z.lead = raw.substr(0, cap);
+    }
+
+    z.req = extract_requirements_block(raw);
+    return z;
+}
+
+static std::vector<std::string> merge_headings(std::initializer_list<std::string_view> starts,
+                                               std::initializer_list<std::string_view> stops,
+                                               std::vector<uint8_t>& kind) {
+    std::vector<std::string> pats;
+    auto add = [&](std::string_view k, uint8_t bit) {
+        for (size_t i = 0; i < pats.size(); ++i) {
+            if (pats[i] == k) { kind[i] |= bit; return; }
+        }
+        pats.emplace_back(k);
+        kind.push_back(bit);
+    };
+    for (auto k : starts) add(k, 1);
+    for (auto k : stops) add(k, 2);
+    return pats;
+}
+
+HeadingBlocks::HeadingBlocks(std::initializer_list<std::string_view> starts,
+                             std::initializer_list<std::string_view> stops)
+    : m_scanner(merge_headings(starts, stops, m_kind)) {}
+
+std::string HeadingBlocks::blocks(const std::string& raw, int max_blocks, size_t block_cap) const {
+    // every occurrence, overlaps included (same as a lower().find() per keyword)
+    std::vector<size_t> starts, stops;
+    m_scanner.scan(raw, [&](size_t pos, uint32_t p) {
+        if (m_kind[p] & 1) starts.push_back(pos);
+        if (m_kind[p] & 2) stops.push_back(pos);
+    });
+    // reported by end position; blocks are cut at start positions
+    std::sort(starts.begin(), starts.end());
+    std::sort(stops.begin(), stops.end());
+
+    std::string out;
+    size_t from = 0;
+    for (int b = 0; b < max_blocks; ++b) {
+        auto si = std::lower_bound(starts.begin(), starts.end(), from);
+        if (si == starts.end()) break;
+        const size_t s = *si;
+
+        auto ei = std::lower_bound(stops.begin(), stops.end(), s + 1);
+        size_t e = std::min(raw.size(), s + block_cap);
+        if (ei != stops.end()) e = std::min(*ei, s + block_cap);
+
+        if (!out.empty()) out += "\n\n";
+        out.append(raw, s, e - s);
+
+        from = e;
+    }
+    return out;
+}
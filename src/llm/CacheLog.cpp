@@ -0,0 +1,585 @@
+#include "llm/CacheLog.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace llm {
+
+// ---------- hashing ----------
+
+static inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+static inline uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+}
+
+CacheKey cache_hash(std::string_view data) {
+    const uint8_t* p = (const uint8_t*)data.data();
+    const size_t len = data.size();
+    const size_t nblocks = len / 16;
+
+    uint64_t h1 = 0, h2 = 0;
+    const uint64_t c1 = 0x87c37b91114253d5ull;
+    const uint64_t c2 = 0x4cf5ad432745937full;
+
+    for (size_t i = 0; i < nblocks; ++i) {
+        uint64_t k1, k2;
+        std::memcpy(&k1, p + i * 16, 8);
+        std::memcpy(&k2, p + i * 16 + 8, 8);
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const uint8_t* tail = p + nblocks * 16;
+    uint64_t k1 = 0, k2 = 0;
+    switch (len & 15) {
+        case 15: k2 ^= (uint64_t)tail[14] << 48; [[fallthrough]];
+        case 14: k2 ^= (uint64_t)tail[13] << 40; [[fallthrough]];
+        case 13: k2 ^= (uint64_t)tail[12] << 32; [[fallthrough]];
+        case 12: k2 ^= (uint64_t)tail[11] << 24; [[fallthrough]];
+        case 11: k2 ^= (uint64_t)tail[10] << 16; [[fallthrough]];
+        case 10: k2 ^= (uint64_t)tail[9] << 8;   [[fallthrough]];
+        case 9:  k2 ^= (uint64_t)tail[8];
+                 k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+                 [[fallthrough]];
+        case 8:  k1 ^= (uint64_t)tail[7] << 56; [[fallthrough]];
+        case 7:  k1 ^= (uint64_t)tail[6] << 48; [[fallthrough]];
+        case 6:  k1 ^= (uint64_t)tail[5] << 40; [[fallthrough]];
+        case 5:  k1 ^= (uint64_t)tail[4] << 32; [[fallthrough]];
+        case 4:  k1 ^= (uint64_t)tail[3] << 24; [[fallthrough]];
+        case 3:  k1 ^= (uint64_t)tail[2] << 16; [[fallthrough]];
+        case 2:  k1 ^= (uint64_t)tail[1] << 8;  [[fallthrough]];
+        case 1:  k1 ^= (uint64_t)tail[0];
+                 k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+                 break;
+        default: break;
+    }
+
+    h1 ^= (uint64_t)len;
+    h2 ^= (uint64_t)len;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+
+    return {h1, h2};
+}
+
+std::string to_hex(const CacheKey& k) {
+    const char* hex = "0123456789abcdef";
+    std::string out(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        out[15 - i] = hex[(k.hi >> (4 * i)) & 0xF];
+        out[31 - i] = hex[(k.lo >> (4 * i)) & 0xF];
+    }
+    return out;
+}
+
+// ---------- file format ----------
+
+static const char kFileMagic[8] = {'R', 'L', 'L', 'M', 'K', 'V', '0', '1'};
+
+// 0xFF never occurs in UTF-8 text, so a resync scan cannot lock onto JSON bytes
+static const uint32_t kRecMagic = 0x01564BFFu; // bytes FF 'K' 'V' 01
+
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t length;
+    uint64_t key_hi;
+    uint64_t key_lo;
+    uint64_t value_check; // of key + value
+    uint64_t header_check; // of the fields above
+};
+static_assert(sizeof(RecordHeader) == 40, "record header layout");
+
+static uint64_t header_check(const RecordHeader& h) {
+    return cache_hash(std::string_view((const char*)&h, offsetof(RecordHeader, header_check))).lo;
+}
+
+static uint64_t value_check(const CacheKey& k, std::string_view value) {
+    std::string buf;
+    buf.reserve(16 + value.size());
+    buf.append((const char*)&k.hi, 8);
+    buf.append((const char*)&k.lo, 8);
+    buf.append(value);
+    return cache_hash(buf).lo;
+}
+
+static std::string make_record(const CacheKey& k, std::string_view value) {
+    RecordHeader h{};
+    h.magic = kRecMagic;
+    h.length = (uint32_t)value.size();
+    h.key_hi = k.hi;
+    h.key_lo = k.lo;
+    h.value_check = value_check(k, value);
+    h.header_check = header_check(h);
+
+    std::string rec;
+    rec.reserve(sizeof(h) + value.size());
+    rec.append((const char*)&h, sizeof(h));
+    rec.append(value);
+    return rec;
+}
+
+// ---------- platform ----------
+
+#ifdef _WIN32
+
+static std::intptr_t file_open(const std::string& path) {
+    HANDLE h = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    return h == INVALID_HANDLE_VALUE ? -1 : (std::intptr_t)h;
+}
+
+static void file_close(std::intptr_t fd) { CloseHandle((HANDLE)fd); }
+
+// lock one byte far past any data: an advisory lock between writers that never
+// blocks plain reads of the records
+static OVERLAPPED lock_region() {
+    OVERLAPPED ov{};
+    ov.Offset = 0;
+    ov.OffsetHigh = 0x40000000;
+    return ov;
+}
+
+static bool file_lock(std::intptr_t fd) {
+    OVERLAPPED ov = lock_region();
+    return LockFileEx((HANDLE)fd, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &ov) != 0;
+}
+
+static void file_unlock(std::intptr_t fd) {
+    OVERLAPPED ov = lock_region();
+    UnlockFileEx((HANDLE)fd, 0, 1, 0, &ov);
+}
+
+static uint64_t file_size(std::intptr_t fd) {
+    LARGE_INTEGER sz{};
+    return GetFileSizeEx((HANDLE)fd, &sz) ? (uint64_t)sz.QuadPart : 0;
+}
+
+static bool read_at(std::intptr_t fd, uint64_t off, char* buf, size_t n) {
+    while (n > 0) {
+        OVERLAPPED ov{};
+        ov.Offset = (DWORD)(off & 0xFFFFFFFFu);
+        ov.OffsetHigh = (DWORD)(off >> 32);
+        DWORD got = 0;
+        const DWORD want = (DWORD)std::min<size_t>(n, 1u << 30);
+        if (!ReadFile((HANDLE)fd, buf, want, &got, &ov) || got == 0) return false;
+        buf += got;
+        off += got;
+        n -= got;
+    }
+    return true;
+}
+
+static bool write_at(std::intptr_t fd, uint64_t off, const char* buf, size_t n) {
+    while (n > 0) {
+        OVERLAPPED ov{};
+        ov.Offset = (DWORD)(off & 0xFFFFFFFFu);
+        ov.OffsetHigh = (DWORD)(off >> 32);
+        DWORD put = 0;
+        const DWORD want = (DWORD)std::min<size_t>(n, 1u << 30);
+        if (!WriteFile((HANDLE)fd, buf, want, &put, &ov) || put == 0) return false;
+        buf += put;
+        off += put;
+        n -= put;
+    }
+    return true;
+}
+
+static bool file_sync(std::intptr_t fd) { return FlushFileBuffers((HANDLE)fd) != 0; }
+
+static bool file_identity(std::intptr_t fd, uint64_t& a, uint64_t& b) {
+    BY_HANDLE_FILE_INFORMATION info{};
+    if (!GetFileInformationByHandle((HANDLE)fd, &info)) return false;
+    a = info.dwVolumeSerialNumber;
+    b = ((uint64_t)info.nFileIndexHigh << 32) | info.nFileIndexLow;
+    return true;
+}
+
+static bool path_identity(const std::string& path, uint64_t& a, uint64_t& b) {
+    HANDLE h = CreateFileA(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) return false;
+    const bool ok = file_identity((std::intptr_t)h, a, b);
+    CloseHandle(h);
+    return ok;
+}
+
+static bool replace_file(const std::string& from, const std::string& to) {
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+#else
+
+static std::intptr_t file_open(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    return fd < 0 ? -1 : (std::intptr_t)fd;
+}
+
+static void file_close(std::intptr_t fd) { ::close((int)fd); }
+
+static bool file_lock(std::intptr_t fd) { return flock((int)fd, LOCK_EX) == 0; }
+static void file_unlock(std::intptr_t fd) { flock((int)fd, LOCK_UN); }
+
+static uint64_t file_size(std::intptr_t fd) {
+    struct stat st{};
+    return fstat((int)fd, &st) == 0 ? (uint64_t)st.st_size : 0;
+}
+
+static bool read_at(std::intptr_t fd, uint64_t off, char* buf, size_t n) {
+    while (n > 0) {
+        const ssize_t got = pread((int)fd, buf, n, (off_t)off);
+        if (got <= 0) return false;
+        buf += got;
+        off += (uint64_t)got;
+        n -= (size_t)got;
+    }
+    return true;
+}
+
+static bool write_at(std::intptr_t fd, uint64_t off, const char* buf, size_t n) {
+    while (n > 0) {
+        const ssize_t put = pwrite((int)fd, buf, n, (off_t)off);
+        if (put <= 0) return false;
+        buf += put;
+        off += (uint64_t)put;
+        n -= (size_t)put;
+    }
+    return true;
+}
+
+static bool file_sync(std::intptr_t fd) { return fsync((int)fd) == 0; }
+
+static bool file_identity(std::intptr_t fd, uint64_t& a, uint64_t& b) {
+    struct stat st{};
+    if (fstat((int)fd, &st) != 0) return false;
+    a = (uint64_t)st.st_dev;
+    b = (uint64_t)st.st_ino;
+    return true;
+}
+
+static bool path_identity(const std::string& path, uint64_t& a, uint64_t& b) {
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0) return false;
+    a = (uint64_t)st.st_dev;
+    b = (uint64_t)st.st_ino;
+    return true;
+}
+
+static bool replace_file(const std::string& from, const std::string& to) {
+    return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+#endif
+
+// sequential reads through a 1 MB window (most headers land in an already-read block)
+class WindowReader {
+public:
+    WindowReader(std::intptr_t fd, uint64_t size) : fd_(fd), size_(size) {}
+
+    const char* at(uint64_t off, size_t n) {
+        if (off + n > size_) return nullptr;
+        if (off < base_ || off + n > base_ + buf_.size()) {
+            const size_t want = (size_t)std::min<uint64_t>(std::max<size_t>(n, 1 << 20), size_ - off);
+            buf_.resize(want);
+            if (!read_at(fd_, off, buf_.data(), want)) {
+                buf_.clear();
+                return nullptr;
+            }
+            base_ = off;
+        }
+        return buf_.data() + (off - base_);
+    }
+
+private:
+    std::intptr_t fd_;
+    uint64_t size_;
+    uint64_t base_ = 0;
+    std::vector<char> buf_;
+};
+
+static bool valid_header(const char* p, RecordHeader& h) {
+    std::memcpy(&h, p, sizeof(h));
+    return h.magic == kRecMagic && h.header_check == header_check(h);
+}
+
+// ---------- CacheLog ----------
+
+CacheLog::~CacheLog() { close(); }
+
+bool CacheLog::is_open() const { return fd_ != -1; }
+
+void CacheLog::close() {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (fd_ != -1) file_close(fd_);
+    fd_ = -1;
+    index_.clear();
+    scanned_ = 0;
+    records_ = 0;
+}
+
+bool CacheLog::open(const std::string& path) {
+    close();
+    std::lock_guard<std::mutex> lk(mu_);
+    path_ = path;
+    return reopen_locked();
+}
+
+bool CacheLog::reopen_locked() {
+    if (fd_ != -1) file_close(fd_);
+    index_.clear();
+    scanned_ = 0;
+    records_ = 0;
+
+    fd_ = file_open(path_);
+    if (fd_ == -1) return false;
+
+    // new file: write the magic once, under the lock
+    if (file_size(fd_) < sizeof(kFileMagic)) {
+        file_lock(fd_);
+        if (file_size(fd_) == 0) write_at(fd_, 0, kFileMagic, sizeof(kFileMagic));
+        file_unlock(fd_);
+    }
+
+    char magic[sizeof(kFileMagic)];
+    if (!read_at(fd_, 0, magic, sizeof(magic)) || std::memcmp(magic, kFileMagic, sizeof(magic)) != 0) {
+        file_close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    scanned_ = sizeof(kFileMagic);
+    scan_locked();
+    return true;
+}
+
+bool CacheLog::replaced_locked() const {
+    uint64_t a1 = 0, b1 = 0, a2 = 0, b2 = 0;
+    if (!file_identity(fd_, a1, b1)) return false;
+    if (!path_identity(path_, a2, b2)) return false;
+    return a1 != a2 || b1 != b2;
+}
+
+void CacheLog::scan_locked() {
+    const uint64_t size = file_size(fd_);
+    WindowReader rd(fd_, size);
+
+    uint64_t pos = scanned_;
+    uint64_t resync_from = 0; // value start of the last record, for when its length lied
+    while (pos + sizeof(RecordHeader) <= size) {
+        RecordHeader h{};
+        const char* p = rd.at(pos, sizeof(h));
+        if (!p) break;
+
+        if (valid_header(p, h)) {
+            const uint64_t value_off = pos + sizeof(h);
+            if (value_off + h.length > size) break; // still being written (or torn at the tail)
+
+            index_[CacheKey{h.key_hi, h.key_lo}] = Entry{value_off, h.length};
+            ++records_;
+            resync_from = value_off;
+            pos = value_off + h.length;
+            continue;
+        }
+
+        // garbage (a torn record from a crashed writer): find the next record magic,
+        // searching from inside the previous record in case its length was the lie
+        uint64_t q = resync_from ? resync_from : pos + 1;
+        resync_from = 0;
+
+        bool found = false;
+        for (; q + sizeof(RecordHeader) <= size; ++q) {
+            const char* c = rd.at(q, sizeof(RecordHeader));
+            if (!c) break;
+            if ((unsigned char)c[0] != 0xFF) continue;
+            RecordHeader h2{};
+            if (valid_header(c, h2)) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            // nothing valid after the garbage yet; later appends land past `size`
+            pos = size;
+            break;
+        }
+        pos = q;
+    }
+    scanned_ = pos;
+}
+
+bool CacheLog::get(const CacheKey& key, std::string& value) {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (fd_ == -1) return false;
+
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        // another process may have appended it (or compacted the file) since
+        if (replaced_locked()) {
+            if (!reopen_locked()) return false;
+        } else {
+            scan_locked();
+        }
+        it = index_.find(key);
+        if (it == index_.end()) return false;
+    }
+
+    value.resize(it->second.length);
+    if (!read_at(fd_, it->second.offset, value.data(), value.size())) return false;
+
+    RecordHeader h{};
+    if (!read_at(fd_, it->second.offset - sizeof(h), (char*)&h, sizeof(h)) ||
+        h.value_check != value_check(key, value)) {
+        index_.erase(it);
+        value.clear();
+        return false;
+    }
+    return true;
+}
+
+bool CacheLog::put(const CacheKey& key, std::string_view value) {
+    if (value.size() > 0xFFFFFFFFull) return false;
+    const std::string rec = make_record(key, value);
+
+    std::lock_guard<std::mutex> lk(mu_);
+    if (fd_ == -1) return false;
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (!file_lock(fd_)) return false;
+
+        // compacted since we opened it: append to the new file instead
+        if (replaced_locked()) {
+            file_unlock(fd_);
+            if (!reopen_locked()) return false;
+            continue;
+        }
+
+        const uint64_t end = file_size(fd_);
+        const bool ok = write_at(fd_, end, rec.data(), rec.size());
+        file_unlock(fd_);
+        if (!ok) return false;
+
+        scan_locked();
+        return true;
+    }
+    return false;
+}
+
+CacheLog::Stats CacheLog::stats() {
+    std::lock_guard<std::mutex> lk(mu_);
+    Stats s;
+    if (fd_ == -1) return s;
+    scan_locked();
+    s.records = records_;
+    s.keys = index_.size();
+    s.bytes = file_size(fd_);
+    for (const auto& kv : index_) s.live_bytes += sizeof(RecordHeader) + kv.second.length;
+    return s;
+}
+
+bool CacheLog::compact(const std::string& path, Stats* before, Stats* after, std::string* error) {
+    auto fail = [&](const std::string& msg) {
+        if (error) *error = msg;
+        return false;
+    };
+
+    CacheLog log;
+    if (!log.open(path)) return fail("cannot open cache log: " + path);
+
+    std::lock_guard<std::mutex> lk(log.mu_);
+    if (!file_lock(log.fd_)) return fail("cannot lock " + path);
+
+    // everything appended before we took the lock is in the index after this
+    log.scan_locked();
+
+    Stats b;
+    b.records = log.records_;
+    b.keys = log.index_.size();
+    b.bytes = file_size(log.fd_);
+
+    // newest record per key, kept in file order
+    std::vector<std::pair<CacheKey, Entry>> live(log.index_.begin(), log.index_.end());
+    std::sort(live.begin(), live.end(), [](const auto& x, const auto& y) { return x.second.offset < y.second.offset; });
+
+    const std::string tmp = path + ".compact.tmp";
+    std::remove(tmp.c_str());
+    const std::intptr_t out = file_open(tmp);
+    if (out == -1) {
+        file_unlock(log.fd_);
+        return fail("cannot create " + tmp);
+    }
+
+    bool ok = write_at(out, 0, kFileMagic, sizeof(kFileMagic));
+    uint64_t off = sizeof(kFileMagic);
+    size_t kept = 0;
+    std::string value;
+    for (size_t i = 0; ok && i < live.size(); ++i) {
+        const auto& [key, e] = live[i];
+        value.resize(e.length);
+        if (!read_at(log.fd_, e.offset, value.data(), value.size())) continue;
+
+        RecordHeader h{};
+        if (!read_at(log.fd_, e.offset - sizeof(h), (char*)&h, sizeof(h)) || h.value_check != value_check(key, value)) {
+            continue; // damaged record: drop it
+        }
+
+        const std::string rec = make_record(key, value);
+        ok = write_at(out, off, rec.data(), rec.size());
+        off += rec.size();
+        b.live_bytes += rec.size();
+        ++kept;
+    }
+    ok = ok && file_sync(out);
+    file_close(out);
+
+    if (!ok) {
+        std::remove(tmp.c_str());
+        file_unlock(log.fd_);
+        return fail("failed writing " + tmp);
+    }
+
+    if (!replace_file(tmp, path)) {
+        std::remove(tmp.c_str());
+        file_unlock(log.fd_);
+        return fail("cannot replace " + path + " (is another process holding it without share access?)");
+    }
+    file_unlock(log.fd_);
+
+    if (before) *before = b;
+    if (after) {
+        after->records = kept;
+        after->keys = kept;
+        after->bytes = off;
+        after->live_bytes = off - sizeof(kFileMagic);
+    }
+    return true;
+}
+
+} // namespace llm
@@ -0,0 +1,313 @@
+#include "llm/CallRecorder.hpp"
+#include "io/Stats.hpp"
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+using json = nlohmann::json;
+
+namespace llm {
+
+static const char kMagic[8] = {'R', 'L', 'L', 'M', 'R', 'E', 'C', '1'};
+
+static double ms_between(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+static std::string evidence_to_json(const std::vector<EvidenceSpan>& evs) {
+    json arr = json::array();
+    for (const auto& ev : evs) {
+        json skills = json::array();
+        for (const auto& sh : ev.skills) {
+            skills.push_back({{"raw", sh.raw}, {"canonical", sh.canonical}, {"confidence", sh.confidence}});
+        }
+        arr.push_back({{"span_type", ev.span_type},
+                       {"span_text", ev.span_text},
+                       {"polarity", ev.polarity},
+                       {"strength", ev.strength},
+                       {"skills", std::move(skills)}});
+    }
+    json j = json::object();
+    j["evidence"] = std::move(arr);
+    return j.dump();
+}
+
+static std::vector<EvidenceSpan> evidence_from_json(const std::string& s) {
+    std::vector<EvidenceSpan> out;
+    const json j = json::parse(s, nullptr, false);
+    if (!j.is_object() || !j.contains("evidence") || !j["evidence"].is_array()) return out;
+
+    for (const auto& e : j["evidence"]) {
+        if (!e.is_object()) continue;
+        EvidenceSpan ev;
+        ev.span_type = e.value("span_type", "");
+        ev.span_text = e.value("span_text", "");
+        ev.polarity = e.value("polarity", "");
+        ev.strength = e.value("strength", "");
+        if (e.contains("skills") && e["skills"].is_array()) {
+            for (const auto& s : e["skills"]) {
+                if (!s.is_object()) continue;
+                SkillHit sh;
+                sh.raw = s.value("raw", "");
+                sh.canonical = s.value("canonical", "");
+                sh.confidence = s.value("confidence", 0.0);
+                ev.skills.push_back(std::move(sh));
+            }
+        }
+        out.push_back(std::move(ev));
+    }
+    return out;
+}
+
+// ---------------- recording ----------------
+
+RecordingLLMClient::RecordingLLMClient(LLMClient& inner)
+    : inner_(inner), epoch_(std::chrono::steady_clock::now()) {}
+
+bool RecordingLLMClient::open_log(const std::string& path) {
+    std::lock_guard<std::mutex> lk(mu_);
+    log_.open(path, std::ios::binary | std::ios::trunc);
+    if (!log_) return false;
+    log_.write(kMagic, sizeof(kMagic));
+    log_.flush();
+    return (bool)log_;
+}
+
+std::vector<EvidenceSpan> RecordingLLMClient::analyze_posting(const std::string& posting_id,
+                                                             const std::string& posting_text) {
+    CallTrace trace;
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::vector<EvidenceSpan>> out(1);
+    {
+        ScopedTrace scope(&trace);
+        out[0] = inner_.analyze_posting(posting_id, posting_text);
+    }
+    record({posting_id}, {posting_text}, out, trace, t0, std::chrono::steady_clock::now());
+    return std::move(out[0]);
+}
+
+std::vector<std::vector<EvidenceSpan>> RecordingLLMClient::analyze_batch(const std::vector<std::string>& posting_ids,
+                                                                         const std::vector<std::string>& posting_texts) {
+    CallTrace trace;
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::vector<EvidenceSpan>> out;
+    {
+        ScopedTrace scope(&trace);
+        out = inner_.analyze_batch(posting_ids, posting_texts);
+    }
+    record(posting_ids, posting_texts, out, trace, t0, std::chrono::steady_clock::now());
+    return out;
+}
+
+void RecordingLLMClient::record(const std::vector<std::string>& ids, const std::vector<std::string>& texts,
+                                const std::vector<std::vector<EvidenceSpan>>& results, const CallTrace& trace,
+                                std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1) {
+    std::vector<CallRecord> recs(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        CallRecord& r = recs[i];
+        r.batch = (uint32_t)ids.size();
+        r.start_ms = ms_between(epoch_, t0);
+        r.wall_ms = ms_between(t0, t1);
+        r.ttfb_ms = trace.got_first_byte ? ms_between(t0, trace.first_byte) : -1.0;
+        r.prompt_tokens = (uint32_t)trace.prompt_tokens;
+        r.posting_id = ids[i];
+
+        auto it = trace.postings.find(ids[i]);
+        if (it != trace.postings.end()) {
+            r.key = it->second.key;
+            r.cache_hit = it->second.cache_hit;
+        } else {
+            r.key = cache_hash(ids[i] + "\n" + (i < texts.size() ? texts[i] : std::string()));
+        }
+        if (log_.is_open()) r.evidence_json = evidence_to_json(i < results.size() ? results[i] : std::vector<EvidenceSpan>{});
+    }
+
+    std::lock_guard<std::mutex> lk(mu_);
+    const uint32_t request = next_request_++;
+    for (CallRecord& r : recs) {
+        r.request = request;
+        if (log_.is_open()) {
+            std::string buf;
+            auto put = [&buf](const void* p, size_t n) { buf.append((const char*)p, n); };
+            const uint8_t hit = r.cache_hit ? 1 : 0;
+            const uint32_t id_len = (uint32_t)r.posting_id.size();
+            const uint32_t ev_len = (uint32_t)r.evidence_json.size();
+            put(&r.request, 4);
+            put(&r.batch, 4);
+            put(&r.start_ms, 8);
+            put(&r.wall_ms, 8);
+            put(&r.ttfb_ms, 8);
+            put(&r.key.hi, 8);
+            put(&r.key.lo, 8);
+            put(&r.prompt_tokens, 4);
+            put(&hit, 1);
+            put(&id_len, 4);
+            put(r.posting_id.data(), id_len);
+            put(&ev_len, 4);
+            put(r.evidence_json.data(), ev_len);
+
+            const uint32_t len = (uint32_t)buf.size();
+            log_.write((const char*)&len, sizeof(len));
+            log_.write(buf.data(), (std::streamsize)buf.size());
+            log_.flush();
+            r.evidence_json.clear(); // only the log needs it
+        }
+        records_.push_back(std::move(r));
+    }
+}
+
+LatencyReport RecordingLLMClient::latency_report() const {
+    std::lock_guard<std::mutex> lk(mu_);
+
+    LatencyReport rep;
+    std::vector<double> wall, ttfb;
+
+    // one sample per request that reached the model; a request's records are adjacent
+    for (size_t i = 0; i < records_.size();) {
+        size_t j = i;
+        bool model = false;
+        for (; j < records_.size() && records_[j].request == records_[i].request; ++j) {
+            ++rep.postings;
+            if (records_[j].cache_hit) ++rep.cache_hits;
+            else model = true;
+        }
+        if (model) {
+            wall.push_back(records_[i].wall_ms);
+            if (records_[i].ttfb_ms >= 0.0) ttfb.push_back(records_[i].ttfb_ms);
+        }
+        i = j;
+    }
+
+    rep.requests = wall.size();
+    rep.p50 = percentile(wall, 50);
+    rep.p95 = percentile(wall, 95);
+    rep.p99 = percentile(wall, 99);
+    rep.ttfb_p50 = percentile(ttfb, 50);
+    return rep;
+}
+
+// ---------------- replay ----------------
+
+bool ReplayLLMClient::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error_ = "cannot open " + path;
+        return false;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    const std::string data = ss.str();
+
+    if (data.size() < sizeof(kMagic) || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+        error_ = "not an LLM call log: " + path;
+        return false;
+    }
+
+    size_t at = sizeof(kMagic);
+    auto take = [&](void* p, size_t n, size_t end) {
+        if (n > end - at) return false;
+        std::memcpy(p, data.data() + at, n);
+        at += n;
+        return true;
+    };
+    auto take_str = [&](std::string& s, size_t end) {
+        uint32_t n = 0;
+        if (!take(&n, 4, end) || n > end - at) return false;
+        s.assign(data.data() + at, n);
+        at += n;
+        return true;
+    };
+
+    while (at < data.size()) {
+        uint32_t len = 0;
+        if (!take(&len, 4, data.size()) || len > data.size() - at) break; // torn tail: keep what came before
+        const size_t end = at + len;
+
+        CallRecord r;
+        uint8_t hit = 0;
+        bool ok = take(&r.request, 4, end) && take(&r.batch, 4, end) && take(&r.start_ms, 8, end) &&
+                  take(&r.wall_ms, 8, end) && take(&r.ttfb_ms, 8, end) && take(&r.key.hi, 8, end) &&
+                  take(&r.key.lo, 8, end) && take(&r.prompt_tokens, 4, end) && take(&hit, 1, end) &&
+                  take_str(r.posting_id, end) && take_str(r.evidence_json, end);
+        if (!ok) {
+            error_ = "damaged record in " + path;
+            return false;
+        }
+        at = end;
+
+        Entry& e = by_id_[r.posting_id];
+        e.wall_ms = r.wall_ms;
+        e.ttfb_ms = r.ttfb_ms;
+        e.key = r.key;
+        e.prompt_tokens = r.prompt_tokens;
+        e.cache_hit = hit != 0;
+        e.evidence = evidence_from_json(r.evidence_json);
+        max_batch_ = std::max<size_t>(max_batch_, r.batch);
+    }
+    return true;
+}
+
+void ReplayLLMClient::replay(const std::vector<const Entry*>& entries, const std::vector<std::string>& ids) const {
+    double wall = 0.0, ttfb = -1.0;
+    size_t prompt_tokens = 0;
+    for (const Entry* e : entries) {
+        if (!e) continue;
+        wall = std::max(wall, e->wall_ms);
+        if (e->ttfb_ms >= 0.0 && (ttfb < 0.0 || e->ttfb_ms < ttfb)) ttfb = e->ttfb_ms;
+        prompt_tokens = std::max<size_t>(prompt_tokens, e->prompt_tokens);
+    }
+
+    CallTrace* trace = active_trace();
+    if (trace) {
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i]) trace->postings[ids[i]] = {entries[i]->key, entries[i]->cache_hit};
+        }
+        trace->prompt_tokens += prompt_tokens;
+    }
+    if (speed_ <= 0.0) {
+        if (trace && ttfb >= 0.0) {
+            trace->got_first_byte = true;
+            trace->first_byte = std::chrono::steady_clock::now();
+        }
+        return;
+    }
+
+    auto sleep_ms = [](double ms) {
+        if (ms > 0.0) std::this_thread::sleep_for(std::chrono::microseconds((long long)(ms * 1000.0)));
+    };
+    if (ttfb >= 0.0) {
+        sleep_ms(ttfb / speed_);
+        if (trace) {
+            trace->got_first_byte = true;
+            trace->first_byte = std::chrono::steady_clock::now();
+        }
+        sleep_ms((wall - ttfb) / speed_);
+    } else {
+        sleep_ms(wall / speed_);
+    }
+}
+
+std::vector<EvidenceSpan> ReplayLLMClient::analyze_posting(const std::string& posting_id, const std::string&) {
+    auto it = by_id_.find(posting_id);
+    if (it == by_id_.end()) return {};
+    replay({&it->second}, {posting_id});
+    return it->second.evidence;
+}
+
+std::vector<std::vector<EvidenceSpan>> ReplayLLMClient::analyze_batch(const std::vector<std::string>& posting_ids,
+                                                                      const std::vector<std::string>&) {
+    std::vector<const Entry*> entries;
+    std::vector<std::vector<EvidenceSpan>> out(posting_ids.size());
+    for (size_t i = 0; i < posting_ids.size(); ++i) {
+        auto it = by_id_.find(posting_ids[i]);
+        entries.push_back(it == by_id_.end() ? nullptr : &it->second);
+        if (entries.back()) out[i] = entries.back()->evidence;
+    }
+    replay(entries, posting_ids);
+    return out;
+}
+
+} // namespace llm
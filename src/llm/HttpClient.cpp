@@ -0,0 +1,447 @@
+#include "llm/HttpClient.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace llm {
+
+#ifdef _WIN32
+
+using socket_t = SOCKET;
+static const socket_t kBadSocket = INVALID_SOCKET;
+
+static bool net_init() {
+    static const bool ok = [] {
+        WSADATA wsa{};
+        return WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+    }();
+    return ok;
+}
+
+static void close_socket(socket_t s) { closesocket(s); }
+static int poll_fd(pollfd* p, int timeout_ms) { return WSAPoll(p, 1, timeout_ms); }
+static bool set_nonblocking(socket_t s) { u_long on = 1; return ioctlsocket(s, FIONBIO, &on) == 0; }
+static bool would_block() { int e = WSAGetLastError(); return e == WSAEWOULDBLOCK || e == WSAEINPROGRESS; }
+static const int kSendFlags = 0;
+
+#else
+
+using socket_t = int;
+static const socket_t kBadSocket = -1;
+
+static bool net_init() { return true; }
+static void close_socket(socket_t s) { ::close(s); }
+static int poll_fd(pollfd* p, int timeout_ms) {
+    int rc;
+    do { rc = ::poll(p, 1, timeout_ms); } while (rc < 0 && errno == EINTR);
+    return rc;
+}
+static bool set_nonblocking(socket_t s) {
+    const int fl = fcntl(s, F_GETFL, 0);
+    return fl >= 0 && fcntl(s, F_SETFL, fl | O_NONBLOCK) == 0;
+}
+static bool would_block() { return errno == EINPROGRESS || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+#ifdef MSG_NOSIGNAL
+static const int kSendFlags = MSG_NOSIGNAL; // a closed peer is an error, not SIGPIPE
+#else
+static const int kSendFlags = 0;
+#endif
+
+#endif
+
+static std::string lower(std::string s) {
+    for (char& c : s) c = (char)std::tolower((unsigned char)c);
+    return s;
+}
+
+static std::string trim(const std::string& s) {
+    size_t a = s.find_first_not_of(" \t");
+    if (a == std::string::npos) return "";
+    size_t b = s.find_last_not_of(" \t");
+    return s.substr(a, b - a + 1);
+}
+
+bool parse_http_endpoint(const std::string& s, uint16_t default_port, std::string& host, uint16_t& port) {
+    std::string rest = trim(s);
+    if (rest.rfind("http://", 0) == 0) rest = rest.substr(7);
+    const size_t slash = rest.find('/');
+    if (slash != std::string::npos) rest = rest.substr(0, slash);
+    if (rest.empty()) return false;
+
+    std::string h, p;
+    bool has_port = false;
+    if (rest[0] == '[') {
+        // "[::1]:11434" / "[::1]"
+        const size_t close = rest.find(']');
+        if (close == std::string::npos) return false;
+        h = rest.substr(1, close - 1);
+        const std::string after = rest.substr(close + 1);
+        if (!after.empty()) {
+            if (after[0] != ':') return false;
+            p = after.substr(1);
+            has_port = true;
+        }
+    } else {
+        // a bare IPv6 address has several colons and no port
+        const size_t colon = rest.find(':');
+        if (colon == std::string::npos || rest.find(':', colon + 1) != std::string::npos) {
+            h = rest;
+        } else {
+            h = rest.substr(0, colon);
+            p = rest.substr(colon + 1);
+            has_port = true;
+        }
+    }
+    if (h.empty()) return false;
+
+    uint16_t v16 = default_port;
+    if (has_port) {
+        if (p.empty() || p.size() > 5 ||
+            !std::all_of(p.begin(), p.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            return false;
+        }
+        const unsigned long v = std::stoul(p);
+        if (v == 0 || v > 65535) return false;
+        v16 = (uint16_t)v;
+    }
+    host = h;
+    port = v16;
+    return true;
+}
+
+HttpClient::HttpClient(std::string host, uint16_t port, HttpOptions opts)
+    : host_(std::move(host)), port_(port), opts_(opts) {}
+
+HttpClient::~HttpClient() { close(); }
+
+void HttpClient::close() {
+    if (sock_ != -1) close_socket((socket_t)sock_);
+    sock_ = -1;
+    buf_.clear();
+}
+
+bool HttpClient::open_connection() {
+    close();
+    if (!net_init()) {
+        last_error_ = "socket library init failed";
+        return false;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    const std::string port_s = std::to_string(port_);
+    if (getaddrinfo(host_.c_str(), port_s.c_str(), &hints, &res) != 0 || !res) {
+        last_error_ = "cannot resolve " + host_;
+        return false;
+    }
+
+    last_error_ = "cannot connect to " + host_ + ":" + port_s;
+    for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+        socket_t s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (s == kBadSocket) continue;
+
+        if (!set_nonblocking(s)) {
+            close_socket(s);
+            continue;
+        }
+
+        bool ok = connect(s, ai->ai_addr, (int)ai->ai_addrlen) == 0;
+        if (!ok && would_block()) {
+            pollfd p{};
+            p.fd = s;
+            p.events = POLLOUT;
+            const int rc = poll_fd(&p, opts_.connect_timeout_ms);
+            if (rc == 0) last_error_ = "connect timed out (" + host_ + ":" + port_s + ")";
+
+            int err = 0;
+            socklen_t len = sizeof(err);
+            ok = rc > 0 && getsockopt(s, SOL_SOCKET, SO_ERROR, (char*)&err, &len) == 0 && err == 0;
+        }
+        if (!ok) {
+            close_socket(s);
+            continue;
+        }
+
+        // requests are written in one go; don't hold back the tail
+        int one = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+
+        sock_ = (std::intptr_t)s;
+        ++connects_;
+        last_error_.clear();
+        break;
+    }
+    freeaddrinfo(res);
+    return sock_ != -1;
+}
+
+bool HttpClient::send_all(const char* p, size_t n) {
+    const socket_t s = (socket_t)sock_;
+    while (n > 0) {
+        const int chunk = (int)std::min<size_t>(n, 1 << 20);
+        const auto sent = send(s, p, chunk, kSendFlags);
+        if (sent > 0) {
+            p += sent;
+            n -= (size_t)sent;
+            continue;
+        }
+        if (sent < 0 && would_block()) {
+            pollfd pf{};
+            pf.fd = s;
+            pf.events = POLLOUT;
+            if (poll_fd(&pf, opts_.read_timeout_ms) > 0) continue;
+            last_error_ = "send timed out";
+            return false;
+        }
+        last_error_ = "send failed";
+        return false;
+    }
+    return true;
+}
+
+int HttpClient::recv_some() {
+    const socket_t s = (socket_t)sock_;
+    char tmp[16384];
+    for (;;) {
+        const auto got = recv(s, tmp, (int)sizeof(tmp), 0);
+        if (got > 0) {
+            buf_.append(tmp, (size_t)got);
+            return (int)got;
+        }
+        if (got == 0) {
+            last_error_ = "connection closed by server";
+            return 0;
+        }
+        if (!would_block()) {
+            last_error_ = "recv failed";
+            return -1;
+        }
+
+        pollfd pf{};
+        pf.fd = s;
+        pf.events = POLLIN;
+        const int rc = poll_fd(&pf, opts_.read_timeout_ms);
+        if (rc == 0) {
+            last_error_ = "read timed out after " + std::to_string(opts_.read_timeout_ms) + " ms";
+            return -1;
+        }
+        if (rc < 0) {
+            last_error_ = "poll failed";
+            return -1;
+        }
+    }
+}
+
+bool HttpClient::fill_until(const char* delim) {
+    while (buf_.find(delim) == std::string::npos) {
+        if (recv_some() <= 0) return false;
+    }
+    return true;
+}
+
+bool HttpClient::fill_to(size_t n) {
+    while (buf_.size() < n) {
+        if (recv_some() <= 0) return false;
+    }
+    return true;
+}
+
+// one request/response on the open connection. `stale` = the server had already
+// dropped the (reused) connection before answering, so a retry is safe.
+bool HttpClient::exchange(const std::string& head, const std::string& body, const HttpBodySink* sink,
+                          HttpResponse& out, bool& reusable, bool& stale) {
+    stale = false;
+    reusable = false;
+    buf_.clear();
+    out.stopped = false;
+
+    if (!send_all(head.data(), head.size()) || !send_all(body.data(), body.size())) {
+        stale = true;
+        return false;
+    }
+
+    // status line + headers (1xx interim responses are skipped)
+    std::string headers;
+    bool got_any = false;
+    for (;;) {
+        if (!fill_until("\r\n\r\n")) {
+            stale = !got_any && buf_.empty();
+            return false;
+        }
+        got_any = true;
+        const size_t end = buf_.find("\r\n\r\n");
+        headers = buf_.substr(0, end + 2);
+        buf_.erase(0, end + 4);
+
+        if (headers.rfind("HTTP/", 0) != 0) {
+            last_error_ = "malformed response";
+            return false;
+        }
+        const size_t sp = headers.find(' ');
+        out.status = (sp == std::string::npos) ? 0 : std::atoi(headers.c_str() + sp + 1);
+        if (out.status < 100 || out.status >= 200) break;
+    }
+
+    const bool http10 = headers.rfind("HTTP/1.0", 0) == 0;
+    bool chunked = false;
+    bool have_len = false;
+    size_t content_len = 0;
+    std::string connection;
+
+    size_t pos = headers.find("\r\n") + 2;
+    while (pos < headers.size()) {
+        const size_t eol = headers.find("\r\n", pos);
+        const std::string line = headers.substr(pos, eol - pos);
+        pos = eol + 2;
+
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        const std::string name = lower(trim(line.substr(0, colon)));
+        const std::string value = trim(line.substr(colon + 1));
+
+        if (name == "content-length") {
+            have_len = true;
+            content_len = (size_t)std::strtoull(value.c_str(), nullptr, 10);
+        } else if (name == "transfer-encoding") {
+            chunked = lower(value).find("chunked") != std::string::npos;
+        } else if (name == "connection") {
+            connection = lower(value);
+        }
+    }
+
+    out.body.clear();
+    const bool no_body = out.status == 204 || out.status == 304;
+
+    // hand the first n bytes of buf_ to the sink (or out.body); false once the sink says stop
+    auto deliver = [&](size_t n) {
+        bool more = true;
+        if (sink) more = (*sink)(buf_.data(), n);
+        else out.body.append(buf_, 0, n);
+        buf_.erase(0, n);
+        if (!more) out.stopped = true;
+        return more;
+    };
+
+    if (no_body) {
+        // nothing to read
+    } else if (chunked) {
+        for (;;) {
+            if (!fill_until("\r\n")) return false;
+            const size_t eol = buf_.find("\r\n");
+            size_t n = (size_t)std::strtoull(buf_.substr(0, eol).c_str(), nullptr, 16);
+            buf_.erase(0, eol + 2);
+
+            if (n == 0) {
+                // optional trailers, then the blank line
+                for (;;) {
+                    if (!fill_until("\r\n")) return false;
+                    const size_t e = buf_.find("\r\n");
+                    buf_.erase(0, e + 2);
+                    if (e == 0) break;
+                }
+                break;
+            }
+
+            // pass chunk data on as it arrives rather than once the chunk is complete
+            while (n > 0) {
+                if (buf_.empty() && recv_some() <= 0) return false;
+                const size_t take = std::min(n, buf_.size());
+                n -= take;
+                if (!deliver(take)) return true;
+            }
+            if (!fill_to(2)) return false;
+            buf_.erase(0, 2);
+        }
+    } else if (have_len) {
+        size_t left = content_len;
+        while (left > 0) {
+            if (buf_.empty() && recv_some() <= 0) return false;
+            const size_t take = std::min(left, buf_.size());
+            left -= take;
+            if (!deliver(take)) return true;
+        }
+    } else {
+        // body runs to connection close
+        for (;;) {
+            if (!buf_.empty() && !deliver(buf_.size())) return true;
+            const int rc = recv_some();
+            if (rc < 0) return false;
+            if (rc == 0) break;
+        }
+        last_error_.clear();
+        return true;
+    }
+
+    reusable = opts_.keep_alive && connection.find("close") == std::string::npos &&
+               (!http10 || connection.find("keep-alive") != std::string::npos);
+    return true;
+}
+
+bool HttpClient::request(const std::string& method, const std::string& path, const std::string& content_type,
+                         const std::string& body, const HttpBodySink* sink, HttpResponse& out) {
+    std::string head;
+    head.reserve(256);
+    head += method + " " + (path.empty() ? "/" : path) + " HTTP/1.1\r\n";
+    // an IPv6 literal goes back in brackets
+    const bool v6 = host_.find(':') != std::string::npos;
+    head += "Host: " + (v6 ? "[" + host_ + "]" : host_) + ":" + std::to_string(port_) + "\r\n";
+    if (!content_type.empty()) head += "Content-Type: " + content_type + "\r\n";
+    if (method != "GET" || !body.empty()) head += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    head += opts_.keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    head += "\r\n";
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        const bool reused = sock_ != -1;
+        if (!reused && !open_connection()) return false;
+
+        bool reusable = false, stale = false;
+        const bool ok = exchange(head, body, sink, out, reusable, stale);
+        if (ok) {
+            if (!reusable || out.stopped) close();
+            last_error_.clear();
+            return true;
+        }
+
+        const std::string err = last_error_;
+        close();
+        last_error_ = err;
+        if (!(reused && stale)) return false;
+    }
+    return false;
+}
+
+bool HttpClient::post(const std::string& path, const std::string& content_type, const std::string& body,
+                      HttpResponse& out) {
+    return request("POST", path, content_type, body, nullptr, out);
+}
+
+bool HttpClient::post_stream(const std::string& path, const std::string& content_type, const std::string& body,
+                             const HttpBodySink& sink, HttpResponse& out) {
+    return request("POST", path, content_type, body, &sink, out);
+}
+
+bool HttpClient::get(const std::string& path, HttpResponse& out) {
+    return request("GET", path, "", "", nullptr, out);
+}
+
+} // namespace llm
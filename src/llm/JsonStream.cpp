@@ -0,0 +1,45 @@
+#include "llm/JsonStream.hpp"
+
+namespace llm {
+
+bool JsonStream::feed(std::string_view piece) {
+    for (size_t i = 0; i < piece.size() && !done_; ++i) {
+        const char c = piece[i];
+
+        if (!started_) {
+            if (c != '{') continue;
+            started_ = true;
+        }
+        text_ += c;
+
+        if (in_string_) {
+            if (escaped_) escaped_ = false;
+            else if (c == '\\') escaped_ = true;
+            else if (c == '"') in_string_ = false;
+            continue;
+        }
+
+        switch (c) {
+            case '"': in_string_ = true; break;
+            case '{': open_ += '}'; break;
+            case '[': open_ += ']'; break;
+            case '}':
+            case ']':
+                if (open_.empty() || open_.back() != c) break; // malformed; let the parser reject it
+                open_.pop_back();
+                if (open_.empty()) {
+                    done_ = true;
+                } else if (max_items_ && open_.size() == 2 && open_[1] == ']' && ++items_ >= max_items_) {
+                    text_.append(open_.rbegin(), open_.rend());
+                    open_.clear();
+                    truncated_ = true;
+                    done_ = true;
+                }
+                break;
+            default: break;
+        }
+    }
+    return done_;
+}
+
+} // namespace llm
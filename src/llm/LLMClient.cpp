@@ -0,0 +1,95 @@
+#include "llm/LLMClient.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+
+namespace llm {
+
+static thread_local CallTrace* t_trace = nullptr;
+
+CallTrace* active_trace() { return t_trace; }
+
+ScopedTrace::ScopedTrace(CallTrace* t) : prev_(t_trace) { t_trace = t; }
+
+ScopedTrace::~ScopedTrace() { t_trace = prev_; }
+
+void analyze_postings(LLMClient& client, const std::vector<std::string>& ids, size_t window,
+                      const std::function<std::string(size_t)>& load,
+                      const std::function<void(size_t, std::vector<EvidenceSpan>&)>& on_result) {
+    using Batch = std::vector<std::vector<EvidenceSpan>>;
+    if (window == 0) window = 1;
+
+    const LLMClient::BatchLimits limits = client.batch_limits();
+    const size_t max_batch = std::max<size_t>(1, limits.max_postings);
+
+    // in flight, oldest first: (first index, count); the head always holds the next
+    // index to hand to on_result
+    struct Request {
+        size_t first = 0;
+        size_t count = 0;
+        std::future<Batch> batch;                       // count > 1
+        std::future<std::vector<EvidenceSpan>> single;  // count == 1
+    };
+    std::deque<Request> inflight;
+    size_t next = 0;
+    std::string carried; // text of posting `next`, loaded but not fitting the last batch
+    bool have_carried = false;
+
+    try {
+        while (next < ids.size() || !inflight.empty()) {
+            while (next < ids.size() && inflight.size() < window) {
+                Request rq;
+                rq.first = next;
+
+                std::vector<std::string> batch_ids, texts;
+                size_t cost = 0;
+                while (next < ids.size() && batch_ids.size() < max_batch) {
+                    std::string text = have_carried ? std::move(carried) : load(next);
+                    have_carried = false;
+
+                    const size_t c = max_batch > 1 ? client.batch_cost(ids[next], text) : 0;
+                    if (!batch_ids.empty() && cost + c > limits.budget) {
+                        carried = std::move(text);
+                        have_carried = true;
+                        break;
+                    }
+                    cost += c;
+                    batch_ids.push_back(ids[next]);
+                    texts.push_back(std::move(text));
+                    ++next;
+                }
+
+                rq.count = batch_ids.size();
+                if (rq.count == 1) {
+                    rq.single = client.analyze_posting_async(std::move(batch_ids[0]), std::move(texts[0]));
+                } else {
+                    rq.batch = std::async(std::launch::async, [&client, bi = std::move(batch_ids), tx = std::move(texts)] {
+                        return client.analyze_batch(bi, tx);
+                    });
+                }
+                inflight.push_back(std::move(rq));
+            }
+
+            Request rq = std::move(inflight.front());
+            inflight.pop_front();
+            if (rq.count == 1) {
+                std::vector<EvidenceSpan> ev = rq.single.get();
+                on_result(rq.first, ev);
+            } else {
+                Batch evs = rq.batch.get();
+                evs.resize(rq.count);
+                for (size_t k = 0; k < rq.count; ++k) on_result(rq.first + k, evs[k]);
+            }
+        }
+    } catch (...) {
+        // let every request already sent finish before the client can go away
+        for (auto& rq : inflight) {
+            if (rq.single.valid()) rq.single.wait();
+            if (rq.batch.valid()) rq.batch.wait();
+        }
+        throw;
+    }
+}
+
+} // namespace llm
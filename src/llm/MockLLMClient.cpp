@@ -1,29 +1,35 @@
 #include "llm/MockLLMClient.hpp"
+#include "io/BinarySections.hpp"
 #include "nlohmann/json.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 
 namespace fs = std::filesystem;
 using json = nlohmann::json;
 
 namespace llm {
 
-MockLLMClient::MockLLMClient(const std::string& root_dir) : root_(root_dir) {}
+// Pack layout (little endian, every section padded to 8 bytes):
+//   "RMCK" u32 version, u64 n_postings, u64 n_spans, u64 n_skills, u64 n_strings
+//   strings    : u64 offs[n_strings + 1], bytes
+//   ids        : u64 offs[n + 1], bytes            (sorted)
+//   span_offs  : u64[n + 1]
+//   span_type, span_text, polarity, strength : u32[n_spans] each
+//   skill_offs : u64[n_spans + 1]
+//   raw, canonical : u32[n_skills] each
+//   confidence : f64[n_skills]
+static const char kMagic[4] = {'R', 'M', 'C', 'K'};
+static const uint32_t kVersion = 1;
 
-std::vector<EvidenceSpan> MockLLMClient::load_file_for_posting_id(const std::string& posting_id) {
+static std::vector<EvidenceSpan> parse_evidence(const json& j) {
     std::vector<EvidenceSpan> out;
 
-    fs::path p = root_ / (posting_id + ".json");
-    std::ifstream f(p);
-    if (!f) return out;
-
-    json j;
-    try {
-        f >> j;
-    } catch (...) {
-        return out;
-    }
-
     if (!j.is_object()) return out;
     if (!j.contains("evidence") || !j["evidence"].is_array()) return out;
 
@@ -57,13 +63,251 @@ std::vector<EvidenceSpan> MockLLMClient::load_file_for_posting_id(const std::str
     return out;
 }
 
+// every <id>.json in dir, parsed, sorted by id; unparsable files count as no evidence
+static bool read_fixture_dir(const fs::path& dir, std::vector<std::pair<std::string, std::vector<EvidenceSpan>>>& out,
+                             std::string* error) {
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file() || it->path().extension() != ".json") continue;
+
+        std::ifstream f(it->path(), std::ios::binary);
+        json j;
+        try {
+            f >> j;
+        } catch (...) {
+            j = json();
+        }
+        out.push_back({it->path().stem().string(), parse_evidence(j)});
+    }
+    if (ec) {
+        if (error) *error = "cannot list " + dir.string() + ": " + ec.message();
+        return false;
+    }
+
+    std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    return true;
+}
+
+static void write_pack_to(std::ostream& out, const std::vector<std::pair<std::string, std::vector<EvidenceSpan>>>& fx) {
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> sid;
+    auto intern = [&](const std::string& s) {
+        auto [it, added] = sid.emplace(s, (uint32_t)strings.size());
+        if (added) strings.push_back(s);
+        return it->second;
+    };
+
+    std::vector<uint64_t> span_offs(fx.size() + 1, 0), skill_offs(1, 0);
+    std::vector<uint32_t> span_type, span_text, polarity, strength, raw, canonical;
+    std::vector<double> confidence;
+
+    for (size_t k = 0; k < fx.size(); ++k) {
+        for (const EvidenceSpan& ev : fx[k].second) {
+            span_type.push_back(intern(ev.span_type));
+            span_text.push_back(intern(ev.span_text));
+            polarity.push_back(intern(ev.polarity));
+            strength.push_back(intern(ev.strength));
+            for (const SkillHit& sh : ev.skills) {
+                raw.push_back(intern(sh.raw));
+                canonical.push_back(intern(sh.canonical));
+                confidence.push_back(sh.confidence);
+            }
+            skill_offs.push_back(raw.size());
+        }
+        span_offs[k + 1] = span_type.size();
+    }
+
+    SectionWriter w{out};
+    w.bytes(kMagic, sizeof(kMagic));
+    w.pod(kVersion);
+    w.pod((uint64_t)fx.size());
+    w.pod((uint64_t)span_type.size());
+    w.pod((uint64_t)raw.size());
+    w.pod((uint64_t)strings.size());
+
+    w.strtab(strings.size(), [&](size_t i) { return std::string_view(strings[i]); });
+    w.strtab(fx.size(), [&](size_t k) { return std::string_view(fx[k].first); });
+
+    w.array(span_offs);
+    for (const auto* col : {&span_type, &span_text, &polarity, &strength}) {
+        w.array(*col);
+        w.pad();
+    }
+    w.array(skill_offs);
+    for (const auto* col : {&raw, &canonical}) {
+        w.array(*col);
+        w.pad();
+    }
+    w.array(confidence);
+}
+
+MockLLMClient::MockLLMClient(const std::string& root_dir) : root_(root_dir) {}
+
+bool MockLLMClient::write_pack(const std::string& dir, const std::string& path, size_t* postings, std::string* error) {
+    std::vector<std::pair<std::string, std::vector<EvidenceSpan>>> fx;
+    if (!read_fixture_dir(dir, fx, error)) return false;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        if (error) *error = "cannot write " + path;
+        return false;
+    }
+    write_pack_to(out, fx);
+    out.flush();
+    if (!out) {
+        if (error) *error = "write failed: " + path;
+        return false;
+    }
+    if (postings) *postings = fx.size();
+    return true;
+}
+
+bool MockLLMClient::load() {
+    std::call_once(once_, [this] { loaded_ = load_once(); });
+    return loaded_;
+}
+
+bool MockLLMClient::load_once() {
+    std::error_code ec;
+    if (fs::is_directory(root_, ec)) {
+        // a directory goes through the same bytes a pack file holds
+        std::vector<std::pair<std::string, std::vector<EvidenceSpan>>> fx;
+        if (!read_fixture_dir(root_, fx, &error_)) return false;
+        std::ostringstream ss;
+        write_pack_to(ss, fx);
+        data_ = ss.str();
+    } else {
+        std::ifstream in(root_, std::ios::binary);
+        if (!in) {
+            error_ = "no mock fixtures at " + root_.string();
+            return false;
+        }
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        data_ = ss.str();
+    }
+
+    if (!parse()) {
+        error_ = "not a mock fixture pack: " + root_.string();
+        return false;
+    }
+    return true;
+}
+
+bool MockLLMClient::parse() {
+    SectionReader r{data_.data(), data_.size()};
+
+    const char* magic = r.take(sizeof(kMagic));
+    if (!magic || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) return false;
+    if (r.pod<uint32_t>() != kVersion) return false;
+
+    const uint64_t n = r.pod<uint64_t>();
+    const uint64_t n_spans = r.pod<uint64_t>();
+    const uint64_t n_skills = r.pod<uint64_t>();
+    const uint64_t n_strings = r.pod<uint64_t>();
+    if (!r.ok || n > 0xFFFFFFFFull || n_strings > 0xFFFFFFFFull) return false;
+
+    auto read_strtab = [&](size_t count, StrTab& t) {
+        t.offs = r.array<uint64_t>(count + 1);
+        uint64_t total = 0;
+        if (!t.offs || !r.offsets(t.offs, count, total)) return false;
+        t.bytes = r.array<char>((size_t)total);
+        r.pad();
+        return r.ok;
+    };
+
+    auto read_offs = [&](const uint64_t*& offs, size_t count, uint64_t expect) {
+        offs = r.array<uint64_t>(count + 1);
+        uint64_t total = 0;
+        return offs && r.offsets(offs, count, total) && total == expect;
+    };
+
+    auto read_ids = [&](const uint32_t*& col, uint64_t rows) {
+        col = r.array<uint32_t>((size_t)rows);
+        r.pad();
+        if (!r.ok) return false;
+        for (uint64_t k = 0; k < rows; ++k) {
+            if (col[k] >= n_strings) return false;
+        }
+        return true;
+    };
+
+    if (!read_strtab((size_t)n_strings, strings_)) return false;
+    if (!read_strtab((size_t)n, ids_)) return false;
+
+    if (!read_offs(span_offs_, (size_t)n, n_spans)) return false;
+    for (const uint32_t** col : {&span_type_, &span_text_, &polarity_, &strength_}) {
+        if (!read_ids(*col, n_spans)) return false;
+    }
+    if (!read_offs(skill_offs_, (size_t)n_spans, n_skills)) return false;
+    for (const uint32_t** col : {&raw_, &canonical_}) {
+        if (!read_ids(*col, n_skills)) return false;
+    }
+    confidence_ = r.array<double>((size_t)n_skills);
+    if (!r.ok) return false;
+
+    n_ = (size_t)n;
+    return true;
+}
+
+std::optional<size_t> MockLLMClient::find(std::string_view posting_id) const {
+    size_t lo = 0, hi = n_;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (str_at(ids_, mid) < posting_id) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < n_ && str_at(ids_, lo) == posting_id) return lo;
+    return std::nullopt;
+}
+
+std::vector<EvidenceSpan> MockLLMClient::evidence(size_t i) const {
+    std::vector<EvidenceSpan> out;
+    out.reserve((size_t)(span_offs_[i + 1] - span_offs_[i]));
+    for (uint64_t s = span_offs_[i]; s < span_offs_[i + 1]; ++s) {
+        EvidenceSpan ev;
+        ev.span_type = str(span_type_[s]);
+        ev.span_text = str(span_text_[s]);
+        ev.polarity = str(polarity_[s]);
+        ev.strength = str(strength_[s]);
+        for (uint64_t k = skill_offs_[s]; k < skill_offs_[s + 1]; ++k) {
+            SkillHit sh;
+            sh.raw = str(raw_[k]);
+            sh.canonical = str(canonical_[k]);
+            sh.confidence = confidence_[k];
+            ev.skills.push_back(std::move(sh));
+        }
+        out.push_back(std::move(ev));
+    }
+    return out;
+}
+
+void MockLLMClient::set_latency(double base_ms, double jitter_ms) {
+    latency_ms_ = std::max(0.0, base_ms);
+    jitter_ms_ = std::max(0.0, jitter_ms);
+}
+
+void MockLLMClient::wait(const std::string& posting_id) const {
+    if (latency_ms_ <= 0.0 && jitter_ms_ <= 0.0) return;
+
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : posting_id) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    const double ms = latency_ms_ + jitter_ms_ * (double)(h % 1000) / 1000.0;
+    std::this_thread::sleep_for(std::chrono::microseconds((long long)(ms * 1000.0)));
+}
+
 std::vector<EvidenceSpan> MockLLMClient::evidence_for_posting_id(const std::string& posting_id) {
-    return load_file_for_posting_id(posting_id);
+    if (!load()) return {};
+    auto i = find(posting_id);
+    return i ? evidence(*i) : std::vector<EvidenceSpan>{};
 }
 
 std::vector<Span> MockLLMClient::segment_for_posting_id(const std::string& posting_id) {
     std::vector<Span> spans;
-    auto evs = load_file_for_posting_id(posting_id);
+    auto evs = evidence_for_posting_id(posting_id);
     spans.reserve(evs.size());
     for (const auto& ev : evs) {
         Span sp;
@@ -77,7 +321,8 @@ std::vector<Span> MockLLMClient::segment_for_posting_id(const std::string& posti
 // Day 3 (B): ignore text, use posting_id to fetch mock evidence
 std::vector<EvidenceSpan> MockLLMClient::analyze_posting(const std::string& posting_id,
                                                         const std::string&) {
-    return load_file_for_posting_id(posting_id);
+    wait(posting_id);
+    return evidence_for_posting_id(posting_id);
 }
 
 std::vector<Span> MockLLMClient::segment(const std::string&) {
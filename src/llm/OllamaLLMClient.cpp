@@ -1,8 +1,11 @@
 #include "llm/OllamaLLMClient.hpp"
+#include "llm/JsonStream.hpp"
 #include "nlohmann/json.hpp"
 
-#include <windows.h>
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
+#include <iostream>
 #include <sstream>
 
 namespace fs = std::filesystem;
@@ -41,62 +44,76 @@ static std::string hex_u64(uint64_t x) {
     return out;
 }
 
-// Run a command and return exit code. (cmdline must be mutable for CreateProcess)
-static DWORD run_wait_exitcode(const std::string& cmdline_utf8) {
-    STARTUPINFOA si{};
-    si.cb = sizeof(si);
-
-    PROCESS_INFORMATION pi{};
-    std::string cmdline = cmdline_utf8;
-
-    BOOL ok = CreateProcessA(
-        NULL,
-        cmdline.data(),
-        NULL, NULL,
-        FALSE,
-        CREATE_NO_WINDOW,
-        NULL,
-        NULL,
-        &si,
-        &pi
-    );
+// rough prompt size for budgeting; llama-style tokenizers average ~4 chars per token on English
+static size_t estimate_tokens(const std::string& s) {
+    return (s.size() + 3) / 4;
+}
 
-    if (!ok) return (DWORD)-1;
+// output cap per posting in a batched request (10 evidence items fit comfortably)
+static const size_t kBatchPredictPerPosting = 1536;
+
+// OLLAMA_HOST (as the ollama CLI reads it), else the default local endpoint
+static std::string ollama_host(uint16_t& port) {
+    std::string host = "127.0.0.1";
+    port = 11434;
+    const char* env = std::getenv("OLLAMA_HOST");
+    if (env && *env && !parse_http_endpoint(env, 11434, host, port)) {
+        host = "127.0.0.1";
+        port = 11434;
+    }
+    if (host == "0.0.0.0") host = "127.0.0.1"; // a bind address, not a destination
+    return host;
+}
 
-    WaitForSingleObject(pi.hProcess, INFINITE);
+OllamaLLMClient::OllamaLLMClient(const std::string& model, const std::string& cache_dir, const HttpOptions& http,
+                                 bool stream)
+    : model_(model), cache_dir_(cache_dir), http_opts_(http), stream_(stream) {
+    host_ = ollama_host(port_);
+    ensure_dir(cache_dir_);
+    if (!cache_.open(cache_file(cache_dir_).string()))
+        std::cerr << "warning: cannot open LLM cache " << cache_file(cache_dir_).string() << " (responses not cached)\n";
+}
 
-    DWORD code = 0;
-    GetExitCodeProcess(pi.hProcess, &code);
+void OllamaLLMClient::set_batching(size_t max_postings, size_t prompt_tokens) {
+    batch_postings_ = std::max<size_t>(1, max_postings);
+    batch_tokens_ = prompt_tokens;
 
-    CloseHandle(pi.hThread);
-    CloseHandle(pi.hProcess);
+    // instructions + postings + every posting's output, rounded up to 1k
+    num_ctx_ = 0;
+    if (batch_postings_ > 1) {
+        const size_t need = 1024 + batch_tokens_ + kBatchPredictPerPosting * batch_postings_;
+        num_ctx_ = (need + 1023) / 1024 * 1024;
+    }
+}
 
-    return code;
+fs::path OllamaLLMClient::cache_file(const fs::path& cache_dir) {
+    return cache_dir / "llm_cache.kv";
 }
 
-OllamaLLMClient::OllamaLLMClient(const std::string& model, const std::string& cache_dir)
-    : model_(model), cache_dir_(cache_dir) {
-    ensure_dir(cache_dir_);
+CacheKey OllamaLLMClient::cache_key(const std::string& task, const std::string& input) const {
+    return cache_hash(task + "_v1\n" + model_ + "\n" + input);
 }
 
-std::string OllamaLLMClient::cache_key(const std::string& task, const std::string& input) const {
+// file name used by the old one-file-per-response cache
+std::string OllamaLLMClient::legacy_cache_name(const std::string& task, const std::string& input) const {
     std::string s = model_ + "\n" + task + "\n" + input;
-    return task + "_v1-" + hex_u64(fnv1a64(s));
+    return task + "_v1-" + hex_u64(fnv1a64(s)) + ".json";
 }
 
-bool OllamaLLMClient::load_cache(const std::string& key, std::string& out) const {
-    fs::path p = cache_dir_ / (key + ".json");
-    std::ifstream f(p, std::ios::in);
+bool OllamaLLMClient::load_cache(const std::string& task, const std::string& input, std::string& out) const {
+    const CacheKey key = cache_key(task, input);
+    if (cache_.get(key, out)) return true;
+
+    // responses cached by earlier versions are moved into the log on first use
+    std::ifstream f(cache_dir_ / legacy_cache_name(task, input), std::ios::in);
     if (!f) return false;
     out = read_all(f);
+    cache_.put(key, out);
     return true;
 }
 
-void OllamaLLMClient::save_cache(const std::string& key, const std::string& content) const {
-    fs::path p = cache_dir_ / (key + ".json");
-    std::ofstream f(p, std::ios::out | std::ios::trunc);
-    if (!f) return;
-    f << content;
+void OllamaLLMClient::save_cache(const std::string& task, const std::string& input, const std::string& content) const {
+    cache_.put(cache_key(task, input), content);
 }
 
 std::string OllamaLLMClient::prompt_analyzer_onecall(const std::string& posting_text) const {
@@ -136,6 +153,52 @@ Job posting:
     return p.str();
 }
 
+std::string OllamaLLMClient::prompt_analyzer_batch(const std::vector<std::string>& posting_texts) const {
+    std::ostringstream p;
+    p <<
+R"(You are extracting job-skill evidence from several job postings.
+Return ONLY valid JSON. No markdown. No commentary.
+
+Output schema:
+{
+  "postings": [
+    {
+      "id": "P1",
+      "evidence": [
+        {
+          "span_type": "requirement|preferred|responsibility|other",
+          "span_text": "...",
+          "polarity": "positive|negated",
+          "strength": "must|should|nice|unknown",
+          "skills": [
+            {"raw":"...","canonical":"...","confidence":0.0}
+          ]
+        }
+      ]
+    }
+  ]
+}
+
+Rules:
+- One entry per posting, in the order given, with the id from its <posting> tag.
+- Evidence for a posting must come from that posting's text only.
+- Only include spans that actually express requirements/preferences/responsibilities.
+- "skills" must be skills/tools/techniques that appear explicitly in span_text.
+- If a skill is explicitly NOT required, set polarity="negated".
+- Use strength="must" for required, "should" for preferred, "nice" for bonus/optional.
+- Keep span_text short (1-3 sentences or a bullet block).
+- Keep outputs small: at most 10 evidence items per posting, at most 5 skills per evidence item.
+- confidence in [0,1].
+- If nothing is found in a posting, return its entry with "evidence":[].
+
+Job postings:
+)";
+    for (size_t i = 0; i < posting_texts.size(); ++i) {
+        p << "<posting id=\"P" << (i + 1) << "\">\n" << posting_texts[i] << "\n</posting>\n";
+    }
+    return p.str();
+}
+
 std::string OllamaLLMClient::prompt_segmenter(const std::string& posting_text) const {
     std::ostringstream p;
     p <<
@@ -184,13 +247,7 @@ Span type: )" << span.type << "\n"
     return p.str();
 }
 
-std::string OllamaLLMClient::run_ollama_json(const std::string& prompt) const {
-    ensure_dir(cache_dir_);
-
-    fs::path payload = cache_dir_ / "ollama_payload.tmp.json";
-    fs::path resp    = cache_dir_ / "ollama_response.tmp.json";
-    fs::path err     = cache_dir_ / "ollama_curl_error.tmp.txt";
-
+std::string OllamaLLMClient::run_ollama_json(const std::string& prompt, size_t max_items, size_t num_predict) const {
     auto esc = [](const std::string& s) {
         std::string o;
         o.reserve(s.size() + 32);
@@ -207,48 +264,106 @@ std::string OllamaLLMClient::run_ollama_json(const std::string& prompt) const {
         return o;
     };
 
+    std::ostringstream payload;
+    payload << "{"
+            << "\"model\":\""  << esc(model_)  << "\","
+            << "\"prompt\":\"" << esc(prompt) << "\","
+            << "\"stream\":" << (stream_ ? "true" : "false") << ","
+            << "\"format\":\"json\","
+            << "\"options\":{"
+                << "\"temperature\":0,";
+    if (num_ctx_) payload << "\"num_ctx\":" << num_ctx_ << ",";
+    payload     << "\"num_predict\":" << num_predict
+            << "}"
+            << "}";
+
+    ++requests_;
+    prompt_tokens_ += estimate_tokens(prompt);
+
+    CallTrace* trace = active_trace();
+    if (trace) trace->prompt_tokens += estimate_tokens(prompt);
+    auto mark_first_byte = [trace] {
+        if (trace && !trace->got_first_byte) {
+            trace->got_first_byte = true;
+            trace->first_byte = std::chrono::steady_clock::now();
+        }
+    };
+
+    std::unique_ptr<HttpClient> http;
     {
-        std::ofstream f(payload, std::ios::out | std::ios::trunc);
-        if (!f) return "";
-
-        f << "{"
-          << "\"model\":\""  << esc(model_)  << "\","
-          << "\"prompt\":\"" << esc(prompt) << "\","
-          << "\"stream\":false,"
-          << "\"format\":\"json\","
-          << "\"options\":{"
-              << "\"temperature\":0,"
-              << "\"num_predict\":3072"
-          << "}"
-          << "}";
+        std::lock_guard<std::mutex> lk(pool_mu_);
+        if (!idle_.empty()) {
+            http = std::move(idle_.back());
+            idle_.pop_back();
+        }
     }
+    if (!http) http = std::make_unique<HttpClient>(host_, port_, http_opts_);
+
+    // streaming: the body is NDJSON, one {"response":"<token(s)>","done":false} per line.
+    // The tokens go through a JsonStream and the connection is dropped (which stops the
+    // generation) as soon as the object closes or reaches max_items, instead of waiting
+    // out trailing whitespace or a runaway list.
+    HttpResponse resp;
+    JsonStream js(max_items);
+    std::string pending; // incomplete NDJSON line
+    auto feed_line = [&](std::string::const_iterator a, std::string::const_iterator b) {
+        const json line = json::parse(a, b, nullptr, false);
+        if (!line.is_object()) return false;
+        auto it = line.find("response");
+        return it != line.end() && it->is_string() && js.feed(it->get_ref<const std::string&>());
+    };
+    auto on_body = [&](const char* p, size_t n) {
+        mark_first_byte();
+        if (resp.status != 200) {
+            resp.body.append(p, n);
+            return true;
+        }
+        pending.append(p, n);
+        size_t start = 0, eol;
+        while ((eol = pending.find('\n', start)) != std::string::npos) {
+            const bool complete = feed_line(pending.cbegin() + start, pending.cbegin() + eol);
+            start = eol + 1;
+            if (complete) return false;
+        }
+        pending.erase(0, start);
+        return true;
+    };
 
-    // write response to file (avoid pipe / quoting issues)
-    std::ostringstream cmd;
-    cmd << "cmd.exe /C curl.exe -s "
-        << "-o \"" << resp.string() << "\" "
-        << "http://127.0.0.1:11434/api/generate "
-        << "-H \"Content-Type: application/json\" "
-        << "--data-binary \"@" << payload.string() << "\" "
-        << "2> \"" << err.string() << "\"";
+    const bool sent = stream_ ? http->post_stream("/api/generate", "application/json", payload.str(), on_body, resp)
+                              : http->post("/api/generate", "application/json", payload.str(), resp);
+    const std::string err = http->last_error();
+    {
+        std::lock_guard<std::mutex> lk(pool_mu_);
+        idle_.push_back(std::move(http));
+    }
+    if (sent && !stream_) mark_first_byte(); // the whole body arrives at once
 
-    DWORD code = run_wait_exitcode(cmd.str());
-    if (code != 0) return "";
+    if (!sent) {
+        ++failures_;
+        std::cerr << "warning: ollama request failed: " << err << "\n";
+        return "";
+    }
+    if (resp.status != 200 || (!stream_ && resp.body.empty())) {
+        ++failures_;
+        std::cerr << "warning: ollama returned HTTP " << resp.status << "\n";
+        return "";
+    }
 
-    std::ifstream rf(resp, std::ios::in);
-    if (!rf) return "";
-    std::string out = read_all(rf);
-    if (out.empty()) return "";
+    if (stream_) {
+        if (!js.done() && !pending.empty()) feed_line(pending.cbegin(), pending.cend()); // unterminated last line
+        return js.text();
+    }
 
     try {
-        auto j = nlohmann::json::parse(out);
+        auto j = nlohmann::json::parse(resp.body);
         if (j.contains("response") && j["response"].is_string()) {
             return j["response"].get<std::string>();
         }
     } catch (...) {
-        return "";
     }
 
+    ++failures_;
+    std::cerr << "warning: ollama returned no response text\n";
     return "";
 }
 
@@ -308,7 +423,11 @@ std::vector<EvidenceSpan> OllamaLLMClient::parse_evidence_list_json(const std::s
     if (!j.is_object()) return out;
     if (!j.contains("evidence") || !j["evidence"].is_array()) return out;
 
+    // the first kMaxEvidenceItems entries, as a streamed answer is cut off: a longer
+    // (unstreamed or cached) answer gives the same result
+    size_t seen = 0;
     for (const auto& e : j["evidence"]) {
+        if (seen++ == kMaxEvidenceItems) break;
         if (!e.is_object()) continue;
 
         EvidenceSpan ev;
@@ -335,21 +454,31 @@ std::vector<EvidenceSpan> OllamaLLMClient::parse_evidence_list_json(const std::s
     return out;
 }
 
+bool OllamaLLMClient::cached_analysis(const std::string& input, std::vector<EvidenceSpan>& out) const {
+    std::string cached;
+    const bool hit = load_cache("analyze", input, cached);
+    if (CallTrace* trace = active_trace()) {
+        // input is posting_id + "\n" + text
+        trace->postings[input.substr(0, input.find('\n'))] = {cache_key("analyze", input), hit};
+    }
+    if (!hit) return false;
+
+    auto a = cached.find('{');
+    auto b = cached.rfind('}');
+    if (a != std::string::npos && b != std::string::npos && b > a) cached = cached.substr(a, b - a + 1);
+    out = parse_evidence_list_json(cached);
+    return true;
+}
+
 std::vector<EvidenceSpan> OllamaLLMClient::analyze_posting(const std::string& posting_id,
                                                           const std::string& posting_text) {
-    const std::string key = cache_key("analyze", posting_id + "\n" + posting_text);
+    const std::string input = posting_id + "\n" + posting_text;
 
-    std::string cached;
-    if (load_cache(key, cached)) {
-        auto a = cached.find('{');
-        auto b = cached.rfind('}');
-        std::string s = cached;
-        if (a != std::string::npos && b != std::string::npos && b > a) s = cached.substr(a, b - a + 1);
-        return parse_evidence_list_json(s);
-    }
+    std::vector<EvidenceSpan> cached;
+    if (cached_analysis(input, cached)) return cached;
 
     std::string prompt = prompt_analyzer_onecall(posting_text);
-    std::string out = run_ollama_json(prompt);
+    std::string out = run_ollama_json(prompt, kMaxEvidenceItems);
     if (out.empty()) return {};
 
     auto a = out.find('{');
@@ -357,15 +486,79 @@ std::vector<EvidenceSpan> OllamaLLMClient::analyze_posting(const std::string& po
     if (a != std::string::npos && b != std::string::npos && b > a) out = out.substr(a, b - a + 1);
 
     auto parsed = parse_evidence_list_json(out);
-    if (!parsed.empty()) save_cache(key, out);
+    if (!parsed.empty()) save_cache("analyze", input, out);
     return parsed;
 }
 
-std::vector<Span> OllamaLLMClient::segment(const std::string& posting_text) {
-    const std::string key = cache_key("segment", posting_text);
+LLMClient::BatchLimits OllamaLLMClient::batch_limits() const {
+    return BatchLimits{batch_postings_, batch_tokens_};
+}
+
+// cached postings cost nothing: analyze_batch answers them without asking the model
+size_t OllamaLLMClient::batch_cost(const std::string& posting_id, const std::string& posting_text) {
+    std::string cached;
+    if (load_cache("analyze", posting_id + "\n" + posting_text, cached)) return 0;
+    return estimate_tokens(posting_text) + 8; // + the <posting> tags
+}
+
+std::vector<std::vector<EvidenceSpan>> OllamaLLMClient::analyze_batch(const std::vector<std::string>& posting_ids,
+                                                                      const std::vector<std::string>& posting_texts) {
+    const size_t n = std::min(posting_ids.size(), posting_texts.size());
+    std::vector<std::vector<EvidenceSpan>> out(n);
+    std::vector<std::string> inputs(n);
+
+    std::vector<size_t> todo;
+    for (size_t i = 0; i < n; ++i) {
+        inputs[i] = posting_ids[i] + "\n" + posting_texts[i];
+        if (!cached_analysis(inputs[i], out[i])) todo.push_back(i);
+    }
+    if (todo.size() <= 1) {
+        for (size_t i : todo) out[i] = analyze_posting(posting_ids[i], posting_texts[i]);
+        return out;
+    }
 
+    std::vector<std::string> texts;
+    for (size_t i : todo) texts.push_back(posting_texts[i]);
+
+    const std::string resp = run_ollama_json(prompt_analyzer_batch(texts), todo.size(),
+                                             kBatchPredictPerPosting * todo.size());
+    if (resp.empty()) return out; // request failed (already reported)
+
+    // each entry is stored as its own {"evidence":[...]}, exactly what a single-posting
+    // request for it would have cached
+    std::vector<bool> answered(todo.size(), false);
+    const json j = json::parse(resp, nullptr, false);
+    if (j.is_object() && j.contains("postings") && j["postings"].is_array()) {
+        for (const auto& e : j["postings"]) {
+            if (!e.is_object() || !e.contains("id") || !e["id"].is_string()) continue;
+            const std::string tag = e["id"].get<std::string>();
+            if (tag.size() < 2 || tag[0] != 'P') continue;
+            const size_t k = (size_t)std::strtoul(tag.c_str() + 1, nullptr, 10) - 1;
+            if (k >= todo.size() || answered[k]) continue;
+
+            json one = json::object();
+            one["evidence"] = (e.contains("evidence") && e["evidence"].is_array()) ? e["evidence"] : json::array();
+            if (one["evidence"].size() > kMaxEvidenceItems) {
+                one["evidence"].erase(one["evidence"].begin() + kMaxEvidenceItems, one["evidence"].end());
+            }
+            const std::string text = one.dump();
+
+            answered[k] = true;
+            out[todo[k]] = parse_evidence_list_json(text);
+            if (!out[todo[k]].empty()) save_cache("analyze", inputs[todo[k]], text);
+        }
+    }
+
+    // postings the model skipped: ask for them one at a time
+    for (size_t k = 0; k < todo.size(); ++k) {
+        if (!answered[k]) out[todo[k]] = analyze_posting(posting_ids[todo[k]], posting_texts[todo[k]]);
+    }
+    return out;
+}
+
+std::vector<Span> OllamaLLMClient::segment(const std::string& posting_text) {
     std::string cached;
-    if (load_cache(key, cached)) return parse_spans_json(cached);
+    if (load_cache("segment", posting_text, cached)) return parse_spans_json(cached);
 
     std::string prompt = prompt_segmenter(posting_text);
     std::string out = run_ollama_json(prompt);
@@ -375,15 +568,15 @@ std::vector<Span> OllamaLLMClient::segment(const std::string& posting_text) {
     auto b = out.rfind('}');
     if (a != std::string::npos && b != std::string::npos && b > a) out = out.substr(a, b - a + 1);
 
-    save_cache(key, out);
+    save_cache("segment", posting_text, out);
     return parse_spans_json(out);
 }
 
 EvidenceSpan OllamaLLMClient::extract(const Span& span) {
-    const std::string key = cache_key("extract", span.type + "\n" + span.text);
+    const std::string input = span.type + "\n" + span.text;
 
     std::string cached;
-    if (load_cache(key, cached)) return parse_evidence_json(cached);
+    if (load_cache("extract", input, cached)) return parse_evidence_json(cached);
 
     std::string prompt = prompt_extractor(span);
     std::string out = run_ollama_json(prompt);
@@ -393,7 +586,7 @@ EvidenceSpan OllamaLLMClient::extract(const Span& span) {
     auto b = out.rfind('}');
     if (a != std::string::npos && b != std::string::npos && b > a) out = out.substr(a, b - a + 1);
 
-    save_cache(key, out);
+    save_cache("extract", input, out);
     return parse_evidence_json(out);
 }
 
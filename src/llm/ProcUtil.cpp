@@ -1,75 +1,340 @@
 #include "llm/ProcUtil.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
 #include <windows.h>
 
+#include <mutex>
+#else
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
 namespace procutil {
 
-std::string run_capture_stdout(const std::string& cmdline_utf8) {
+using Clock = std::chrono::steady_clock;
+
+// Appends to `buf`, growing it geometrically; past `cap` bytes the data is dropped.
+struct Sink {
+    std::string* buf = nullptr;
+    size_t cap = 0;
+    bool truncated = false;
+
+    void append(const char* p, size_t n) {
+        const size_t room = buf->size() < cap ? cap - buf->size() : 0;
+        if (n > room) {
+            truncated = true;
+            n = room;
+        }
+        if (buf->capacity() - buf->size() < n) buf->reserve(std::max(buf->capacity() * 2, buf->size() + n));
+        buf->append(p, n);
+    }
+};
+
+#ifdef _WIN32
+
+// argv -> one command line, quoted the way CommandLineToArgvW splits it
+static std::string quote_args(const std::vector<std::string>& argv) {
+    std::string cmd;
+    for (const std::string& a : argv) {
+        if (!cmd.empty()) cmd += ' ';
+        if (!a.empty() && a.find_first_of(" \t\n\v\"") == std::string::npos) {
+            cmd += a;
+            continue;
+        }
+        cmd += '"';
+        size_t backslashes = 0;
+        for (char c : a) {
+            if (c == '\\') {
+                ++backslashes;
+                continue;
+            }
+            if (c == '"') cmd.append(backslashes * 2 + 1, '\\');
+            else cmd.append(backslashes, '\\');
+            backslashes = 0;
+            cmd += c;
+        }
+        cmd.append(backslashes * 2, '\\');
+        cmd += '"';
+    }
+    return cmd;
+}
+
+// Anonymous pipes can't be waited on alongside the process, so each one is drained
+// by its own thread while this one waits for the process with the timeout.
+static RunResult run_cmdline(std::string cmdline, const RunOptions& opts) {
+    RunResult res;
+
+    // inheritable handles go to every process created while they exist; keep two
+    // runs from handing each other's pipe ends to their children
+    static std::mutex spawn_mu;
+    std::unique_lock<std::mutex> spawn_lk(spawn_mu);
+
     SECURITY_ATTRIBUTES sa{};
     sa.nLength = sizeof(sa);
     sa.bInheritHandle = TRUE;
-    sa.lpSecurityDescriptor = NULL;
-
-    HANDLE readPipe = NULL;
-    HANDLE writePipe = NULL;
 
-    if (!CreatePipe(&readPipe, &writePipe, &sa, 0)) {
-        return "";
+    HANDLE out_r = NULL, out_w = NULL, err_r = NULL, err_w = NULL;
+    if (!CreatePipe(&out_r, &out_w, &sa, 0)) {
+        res.error = "CreatePipe failed";
+        return res;
     }
+    if (!opts.merge_stderr && !CreatePipe(&err_r, &err_w, &sa, 0)) {
+        CloseHandle(out_r);
+        CloseHandle(out_w);
+        res.error = "CreatePipe failed";
+        return res;
+    }
+
+    // the read ends stay with us
+    SetHandleInformation(out_r, HANDLE_FLAG_INHERIT, 0);
+    if (err_r) SetHandleInformation(err_r, HANDLE_FLAG_INHERIT, 0);
 
-    // Ensure the read end is not inherited
-    SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+    HANDLE nul = CreateFileA("NUL", GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, 0, NULL);
 
     STARTUPINFOA si{};
     si.cb = sizeof(si);
     si.dwFlags = STARTF_USESTDHANDLES;
-    si.hStdInput  = GetStdHandle(STD_INPUT_HANDLE);
-    si.hStdOutput = writePipe;
-    si.hStdError  = writePipe;
+    si.hStdInput  = nul;
+    si.hStdOutput = out_w;
+    si.hStdError  = opts.merge_stderr ? out_w : err_w;
 
     PROCESS_INFORMATION pi{};
-    std::string cmdline = cmdline_utf8; // CreateProcessA needs a mutable buffer
-
-    BOOL ok = CreateProcessA(
-        NULL,
-        cmdline.data(),
-        NULL,
-        NULL,
-        TRUE,
-        CREATE_NO_WINDOW,
-        NULL,
-        NULL,
-        &si,
-        &pi
-    );
-
-    // Parent no longer needs write end
-    CloseHandle(writePipe);
+    BOOL ok = CreateProcessA(NULL, cmdline.data(), NULL, NULL, TRUE, CREATE_NO_WINDOW, NULL, NULL, &si, &pi);
+
+    // the child has its copies now
+    CloseHandle(out_w);
+    if (err_w) CloseHandle(err_w);
+    if (nul != INVALID_HANDLE_VALUE) CloseHandle(nul);
+    spawn_lk.unlock();
 
     if (!ok) {
-        CloseHandle(readPipe);
-        return "";
+        CloseHandle(out_r);
+        if (err_r) CloseHandle(err_r);
+        res.error = "CreateProcess failed (" + std::to_string((unsigned long)GetLastError()) + ")";
+        return res;
     }
+    res.started = true;
 
-    std::string out;
-    out.reserve(8192);
-
-    char buf[4096];
-    DWORD n = 0;
+    Sink out_sink{&res.out, opts.max_output};
+    Sink err_sink{&res.err, opts.max_output};
+    auto drain = [](HANDLE h, Sink* sink) {
+        char buf[16384];
+        DWORD n = 0;
+        while (ReadFile(h, buf, sizeof(buf), &n, NULL) && n > 0) sink->append(buf, n);
+    };
+    std::thread t_out(drain, out_r, &out_sink);
+    std::thread t_err;
+    if (err_r) t_err = std::thread(drain, err_r, &err_sink);
 
-    while (true) {
-        BOOL r = ReadFile(readPipe, buf, sizeof(buf), &n, NULL);
-        if (!r || n == 0) break;
-        out.append(buf, buf + n);
+    const DWORD wait_ms = opts.timeout_ms > 0 ? (DWORD)opts.timeout_ms : INFINITE;
+    if (WaitForSingleObject(pi.hProcess, wait_ms) == WAIT_TIMEOUT) {
+        res.timed_out = true;
+        TerminateProcess(pi.hProcess, 1);
+        WaitForSingleObject(pi.hProcess, INFINITE);
+        // a grandchild may still hold the pipes open; don't wait for it
+        CancelSynchronousIo(t_out.native_handle());
+        if (t_err.joinable()) CancelSynchronousIo(t_err.native_handle());
     }
 
-    CloseHandle(readPipe);
+    t_out.join();
+    if (t_err.joinable()) t_err.join();
+    CloseHandle(out_r);
+    if (err_r) CloseHandle(err_r);
 
-    WaitForSingleObject(pi.hProcess, INFINITE);
+    DWORD code = 0;
+    if (!res.timed_out && GetExitCodeProcess(pi.hProcess, &code)) res.exit_code = (int)code;
     CloseHandle(pi.hThread);
     CloseHandle(pi.hProcess);
 
-    return out;
+    res.truncated = out_sink.truncated || err_sink.truncated;
+    return res;
+}
+
+RunResult run(const std::vector<std::string>& argv, const RunOptions& opts) {
+    if (argv.empty()) {
+        RunResult res;
+        res.error = "empty argv";
+        return res;
+    }
+    return run_cmdline(quote_args(argv), opts);
+}
+
+std::string run_capture_stdout(const std::string& cmdline_utf8, int timeout_ms) {
+    RunOptions opts;
+    opts.timeout_ms = timeout_ms;
+    opts.merge_stderr = true;
+    // /S: cmd strips just the outer quotes, leaving any inside the command alone
+    RunResult res = run_cmdline("cmd.exe /S /C \"" + cmdline_utf8 + "\"", opts);
+    return (res.started && !res.timed_out) ? std::move(res.out) : std::string();
+}
+
+#else
+
+static void close_fd(int& fd) {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+// close-on-exec from the start: a process spawned meanwhile by another thread must
+// not inherit our write end, or we would never see EOF. Only the dup2'd copies reach the child.
+static bool make_pipe(int fds[2]) {
+    return ::pipe2(fds, O_CLOEXEC) == 0;
+}
+
+RunResult run(const std::vector<std::string>& argv, const RunOptions& opts) {
+    RunResult res;
+    if (argv.empty()) {
+        res.error = "empty argv";
+        return res;
+    }
+
+    int out_p[2] = {-1, -1}, err_p[2] = {-1, -1};
+    if (!make_pipe(out_p) || (!opts.merge_stderr && !make_pipe(err_p))) {
+        res.error = std::string("pipe: ") + std::strerror(errno);
+        close_fd(out_p[0]);
+        close_fd(out_p[1]);
+        return res;
+    }
+
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_addopen(&fa, 0, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&fa, out_p[1], 1);
+    posix_spawn_file_actions_adddup2(&fa, opts.merge_stderr ? out_p[1] : err_p[1], 2);
+
+    // own process group, so a timeout also takes down whatever the child started
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    std::vector<char*> args;
+    for (const std::string& a : argv) args.push_back(const_cast<char*>(a.c_str()));
+    args.push_back(nullptr);
+
+    pid_t pid = -1;
+    const int rc = posix_spawnp(&pid, args[0], &fa, &attr, args.data(), environ);
+    posix_spawn_file_actions_destroy(&fa);
+    posix_spawnattr_destroy(&attr);
+
+    close_fd(out_p[1]);
+    close_fd(err_p[1]);
+    if (rc != 0) {
+        close_fd(out_p[0]);
+        close_fd(err_p[0]);
+        res.error = "spawn " + argv[0] + ": " + std::strerror(rc);
+        return res;
+    }
+    res.started = true;
+
+    const bool limited = opts.timeout_ms > 0;
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(limited ? opts.timeout_ms : 0);
+    auto ms_left = [&]() -> int {
+        if (!limited) return -1;
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        return left > 0 ? (int)left : 0;
+    };
+
+    Sink sinks[2] = {{&res.out, opts.max_output}, {&res.err, opts.max_output}};
+    int fds[2] = {out_p[0], err_p[0]};
+    for (int fd : fds) {
+        if (fd >= 0) fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    // read both pipes until they close (or time runs out)
+    char buf[65536];
+    while (fds[0] >= 0 || fds[1] >= 0) {
+        pollfd p[2];
+        int np = 0, which[2];
+        for (int i = 0; i < 2; ++i) {
+            if (fds[i] < 0) continue;
+            p[np] = pollfd{fds[i], POLLIN, 0};
+            which[np++] = i;
+        }
+
+        const int left = ms_left();
+        if (left == 0) {
+            res.timed_out = true;
+            break;
+        }
+        const int n = ::poll(p, (nfds_t)np, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int k = 0; k < np; ++k) {
+            if (!(p[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            const int i = which[k];
+            for (;;) {
+                const ssize_t got = ::read(fds[i], buf, sizeof(buf));
+                if (got > 0) {
+                    sinks[i].append(buf, (size_t)got);
+                    continue;
+                }
+                if (got < 0 && errno == EINTR) continue;
+                if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                close_fd(fds[i]); // EOF or error
+                break;
+            }
+        }
+    }
+    close_fd(fds[0]);
+    close_fd(fds[1]);
+
+    // the pipes closed; the process may still be running
+    int status = 0;
+    for (;;) {
+        if (res.timed_out) {
+            ::kill(-pid, SIGKILL);
+            while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+            break;
+        }
+        const pid_t w = ::waitpid(pid, &status, WNOHANG);
+        if (w == pid) break;
+        if (w < 0 && errno != EINTR) break;
+        if (ms_left() == 0) {
+            res.timed_out = true;
+            continue;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    if (!res.timed_out) {
+        if (WIFEXITED(status)) res.exit_code = WEXITSTATUS(status);
+        else if (WIFSIGNALED(status)) res.term_signal = WTERMSIG(status);
+    } else if (WIFSIGNALED(status)) {
+        res.term_signal = WTERMSIG(status);
+    }
+    res.truncated = sinks[0].truncated || sinks[1].truncated;
+    return res;
+}
+
+std::string run_capture_stdout(const std::string& cmdline_utf8, int timeout_ms) {
+    RunOptions opts;
+    opts.timeout_ms = timeout_ms;
+    opts.merge_stderr = true;
+    RunResult res = run({"/bin/sh", "-c", cmdline_utf8}, opts);
+    return (res.started && !res.timed_out) ? std::move(res.out) : std::string();
+}
+
+#endif
+
+std::future<RunResult> run_async(std::vector<std::string> argv, RunOptions opts) {
+    return std::async(std::launch::async, [argv = std::move(argv), opts] { return run(argv, opts); });
 }
 
 } // namespace procutil
@@ -52,13 +52,21 @@ static std::string norm_and_canon(const std::string& s) {
     return canonicalize_skill(normalize_tag(s));
 }
 
-static std::unordered_set<std::string> build_core_set(const RoleProfileLite& profile) {
-    std::unordered_set<std::string> out;
+static std::unordered_set<textutil::TokenId> build_core_set(const RoleProfileLite& profile) {
+    std::unordered_set<textutil::TokenId> out;
     out.reserve(profile.core_skills.size() * 2 + 8);
-    for (const auto& s : profile.core_skills) out.insert(norm_and_canon(s));
+    for (const auto& s : profile.core_skills) out.insert(textutil::intern(norm_and_canon(s)));
     return out;
 }
 
+// profile weight lookup by skill string; tags never seen by the profile are not interned
+static const double* find_weight(const RoleProfileLite& profile, const std::string& skill, textutil::TokenId& id) {
+    id = textutil::find_token(skill);
+    if (id == textutil::kNoToken) return nullptr;
+    auto it = profile.skill_weights.find(id);
+    return it == profile.skill_weights.end() ? nullptr : &it->second;
+}
+
 static double safe_norm(int tag_count) {
     return std::sqrt(1.0 + static_cast<double>(tag_count));
 }
@@ -69,6 +77,37 @@ static double semantic_contribution(const ScoreConfig& cfg, double profile_weigh
     return profile_weight * cfg.semantic_weight_scale * sim;
 }
 
+// tag -> best profile skill, for every tag with no exact match; filled in one batch
+using SemanticMemo = std::unordered_map<std::string, SemanticHit>;
+
+static void collect_unmatched(const std::vector<Bullet>& bullets, const RoleProfileLite& profile,
+                              std::unordered_set<std::string>& seen, std::vector<std::string>& out) {
+    for (const auto& b : bullets) {
+        for (const auto& t : b.tags) {
+            std::string tag = norm_and_canon(t);
+            if (tag.empty()) continue;
+            textutil::TokenId id = textutil::kNoToken;
+            if (find_weight(profile, tag, id)) continue;
+            if (seen.insert(tag).second) out.push_back(std::move(tag));
+        }
+    }
+}
+
+static SemanticMemo match_unmatched_tags(const AbstractResume& resume, const RoleProfileLite& profile,
+                                         const SemanticMatcher& semantic) {
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> tags;
+    for (const auto& e : resume.experiences) collect_unmatched(e.bullets, profile, seen, tags);
+    for (const auto& p : resume.projects) collect_unmatched(p.bullets, profile, seen, tags);
+
+    std::vector<SemanticHit> hits = semantic.best_matches(tags);
+
+    SemanticMemo memo;
+    memo.reserve(tags.size());
+    for (size_t i = 0; i < tags.size() && i < hits.size(); ++i) memo.emplace(std::move(tags[i]), std::move(hits[i]));
+    return memo;
+}
+
 static void finalize_and_push(
     std::vector<ScoredBullet>& out,
     const Bullet& b,
@@ -76,9 +115,9 @@ static void finalize_and_push(
     const std::string& parent_id,
     const std::string& parent_title,
     const RoleProfileLite& profile,
-    const std::unordered_set<std::string>& core,
+    const std::unordered_set<textutil::TokenId>& core,
     const ScoreConfig& cfg,
-    const SemanticMatcher* semantic
+    const SemanticMemo* semantic
 ) {
     ScoredBullet sb;
     sb.bullet_id = b.id;
@@ -95,7 +134,7 @@ static void finalize_and_push(
     sb.score.tag_count = static_cast<int>(sb.tags.size());
 
     // De-dupe on "credited profile skill" so multiple tags mapping to same skill don't double count.
-    std::unordered_set<std::string> credited_skills;
+    std::unordered_set<textutil::TokenId> credited_skills;
     credited_skills.reserve(sb.tags.size() * 2 + 8);
 
     double raw = 0.0;
@@ -105,13 +144,13 @@ static void finalize_and_push(
         if (tag.empty()) continue;
 
         // 1) Exact match
-        auto wit = profile.skill_weights.find(tag);
-        if (wit != profile.skill_weights.end()) {
+        textutil::TokenId skill_id = textutil::kNoToken;
+        if (const double* wit = find_weight(profile, tag, skill_id)) {
             const std::string matched_skill = tag;
 
-            if (!credited_skills.insert(matched_skill).second) continue;
+            if (!credited_skills.insert(skill_id).second) continue;
 
-            const double profile_w = wit->second;
+            const double profile_w = *wit;
             const double contrib = profile_w;
 
             raw += contrib;
@@ -126,7 +165,7 @@ static void finalize_and_push(
             ev.contribution = contrib;
             sb.match_evidence.push_back(std::move(ev));
 
-            if (core.find(matched_skill) != core.end()) {
+            if (core.find(skill_id) != core.end()) {
                 has_core = true;
                 sb.core_hits.push_back(matched_skill);
             }
@@ -135,18 +174,20 @@ static void finalize_and_push(
 
         // 2) Semantic match (embedding fallback) ONLY when exact failed
         if (cfg.semantic_enabled && semantic) {
-            SemanticHit hit = semantic->best_match(tag);
+            auto mit = semantic->find(tag);
+            if (mit == semantic->end()) continue;
+            const SemanticHit& hit = mit->second;
             if (!hit.ok) continue;
 
             const std::string matched_skill = hit.skill;
             if (matched_skill.empty()) continue;
 
-            auto pwit = profile.skill_weights.find(matched_skill);
-            if (pwit == profile.skill_weights.end()) continue;
+            const double* pwit = find_weight(profile, matched_skill, skill_id);
+            if (!pwit) continue;
 
-            if (!credited_skills.insert(matched_skill).second) continue;
+            if (!credited_skills.insert(skill_id).second) continue;
 
-            const double profile_w = pwit->second;
+            const double profile_w = *pwit;
             const double sim = hit.similarity;
 
             if (sim < cfg.semantic_threshold) continue;
@@ -166,7 +207,7 @@ static void finalize_and_push(
             ev.contribution = contrib;
             sb.match_evidence.push_back(std::move(ev));
 
-            if (core.find(matched_skill) != core.end()) {
+            if (core.find(skill_id) != core.end()) {
                 has_core = true;
                 sb.core_hits.push_back(matched_skill);
             }
@@ -212,15 +253,20 @@ std::vector<ScoredBullet> score_bullets(
     for (const auto& p : resume.projects) approx += p.bullets.size();
     scored.reserve(approx);
 
+    // a tag shared by many bullets is embedded and looked up once
+    SemanticMemo memo;
+    if (cfg.semantic_enabled && semantic) memo = match_unmatched_tags(resume, profile, *semantic);
+    const SemanticMemo* sem = (cfg.semantic_enabled && semantic) ? &memo : nullptr;
+
     for (const auto& e : resume.experiences) {
         for (const auto& b : e.bullets) {
-            finalize_and_push(scored, b, "Experience", e.id, e.title, profile, core, cfg, semantic);
+            finalize_and_push(scored, b, "Experience", e.id, e.title, profile, core, cfg, sem);
         }
     }
 
     for (const auto& p : resume.projects) {
         for (const auto& b : p.bullets) {
-            finalize_and_push(scored, b, "Project", p.id, p.name, profile, core, cfg, semantic);
+            finalize_and_push(scored, b, "Project", p.id, p.name, profile, core, cfg, sem);
         }
     }
 
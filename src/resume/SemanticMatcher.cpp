@@ -1,8 +1,16 @@
 #include "resume/SemanticMatcher.hpp"
+#include "io/FileStamp.hpp"
+#include "io/Hash.hpp"
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -109,6 +117,16 @@ static bool looks_like_real_skill_target(const std::string& s) {
     return has_long_token;
 }
 
+std::vector<SemanticHit> SemanticMatcher::best_matches(const std::vector<std::string>& texts) const {
+    std::vector<SemanticHit> out;
+    out.reserve(texts.size());
+    for (const auto& t : texts) out.push_back(best_match(t));
+    return out;
+}
+
+// texts per embed_batch() call; bounds the padded input tensor
+static constexpr size_t kQueryBatch = 256;
+
 class SemanticMatcherImpl final : public SemanticMatcher {
 public:
     SemanticMatcherImpl(EmbeddingIndex idx, const MiniLmEmbedder* emb, SemanticMatcherConfig cfg)
@@ -128,8 +146,61 @@ public:
         auto hits = m_idx.topk(qv, k);
         if (hits.empty()) return SemanticHit{};
 
-        const auto& h = hits[0];
+        return to_hit(hits[0]);
+    }
+
+    // Distinct queries are embedded together and scored in one pass over the index;
+    // repeats share the result.
+    std::vector<SemanticHit> best_matches(const std::vector<std::string>& texts) const override {
+        std::vector<SemanticHit> out(texts.size());
+        if (!m_emb) return out;
+        if (m_idx.size() == 0 || m_idx.dim() == 0) return out;
+
+        std::vector<std::string> queries;
+        std::unordered_map<std::string, size_t> slot;
+        std::vector<size_t> which(texts.size(), SIZE_MAX);
+        for (size_t i = 0; i < texts.size(); ++i) {
+            std::string q = norm_and_canon(texts[i]);
+            if (q.empty()) continue;
+            auto ins = slot.emplace(q, queries.size());
+            if (ins.second) queries.push_back(std::move(q));
+            which[i] = ins.first->second;
+        }
+
+        const size_t dim = m_idx.dim();
+        const size_t k = (m_cfg.topk == 0) ? 1 : m_cfg.topk;
+        std::vector<SemanticHit> hits(queries.size());
+
+        for (size_t at = 0; at < queries.size(); at += kQueryBatch) {
+            const size_t end = std::min(queries.size(), at + kQueryBatch);
+            const std::vector<std::string> chunk(queries.begin() + at, queries.begin() + end);
+            const auto vecs = m_emb->embed_batch(chunk);
+            if (vecs.size() != chunk.size()) continue;
+
+            // queries that embedded to the wrong size get no hit, as in best_match()
+            std::vector<float> packed;
+            std::vector<size_t> rows;
+            packed.reserve(chunk.size() * dim);
+            for (size_t j = 0; j < vecs.size(); ++j) {
+                if (vecs[j].size() != dim) continue;
+                packed.insert(packed.end(), vecs[j].begin(), vecs[j].end());
+                rows.push_back(at + j);
+            }
+
+            const auto top = m_idx.topk_batch(packed, k);
+            for (size_t j = 0; j < top.size() && j < rows.size(); ++j) {
+                if (!top[j].empty()) hits[rows[j]] = to_hit(top[j][0]);
+            }
+        }
 
+        for (size_t i = 0; i < texts.size(); ++i) {
+            if (which[i] != SIZE_MAX) out[i] = hits[which[i]];
+        }
+        return out;
+    }
+
+private:
+    SemanticHit to_hit(const EmbHit& h) const {
         SemanticHit out;
         out.similarity = h.score;
 
@@ -143,21 +214,19 @@ public:
         return out;
     }
 
-private:
     EmbeddingIndex m_idx;
     const MiniLmEmbedder* m_emb = nullptr;
     SemanticMatcherConfig m_cfg;
 };
 
-static EmbeddingIndex build_index_from_profile(
-    const std::map<std::string, double>& profile_skill_weights,
-    const MiniLmEmbedder& embedder
+static std::vector<std::string> profile_skill_targets(
+    const std::unordered_map<textutil::TokenId, double>& profile_skill_weights
 ) {
     std::vector<std::string> skills;
     skills.reserve(profile_skill_weights.size());
 
     for (const auto& kv : profile_skill_weights) {
-        const std::string s = norm_and_canon(kv.first);
+        const std::string s = norm_and_canon(std::string(textutil::token_str(kv.first)));
         if (s.empty()) continue;
 
         // Only include high-quality targets to prevent junk matches like "engineers"
@@ -169,52 +238,183 @@ static EmbeddingIndex build_index_from_profile(
     // Deduplicate deterministically
     std::sort(skills.begin(), skills.end());
     skills.erase(std::unique(skills.begin(), skills.end()), skills.end());
+    return skills;
+}
 
-    std::vector<float> packed;
+// ---------- skill vector cache ----------
+//
+// One file can serve many profiles: it keeps a vector per skill text (the union of
+// every profile written through it), all embedded by the model/vocab named by the
+// header fingerprint. A profile takes the vectors of the skills it has and embeds
+// only the rest; a cache with another fingerprint counts as empty.
+//
+//   "RSKIDX01", u64 fingerprint, u32 dim, u32 count,
+//   then per skill (sorted): u32 length, skill, dim x f32
+
+static const char kCacheMagic[8] = {'R', 'S', 'K', 'I', 'D', 'X', '0', '1'};
+
+// bump when skill normalization/filtering or the embedding call changes
+static const char* kCacheVersion = "skill_index_v1";
+
+static std::string file_contents(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// the model by stamp (it is large), the vocab by contents
+static uint64_t embedder_fingerprint(const SemanticMatcherConfig& cfg) {
+    uint64_t h = kFnvOffset;
+    hash_str(h, kCacheVersion);
+    hash_str(h, cfg.model_path.empty() ? std::string("-") : file_stamp(cfg.model_path));
+    hash_str(h, cfg.vocab_path.empty() ? std::string() : file_contents(cfg.vocab_path));
+    return h;
+}
+
+struct SkillVectors {
     size_t dim = 0;
+    std::map<std::string, std::vector<float>> by_skill;
+};
 
-    for (const auto& s : skills) {
-        std::vector<float> v = embedder.embed(s);
-        if (v.empty()) continue;
+// false if missing, damaged or from another embedder
+static bool load_skill_vectors(const std::string& path, uint64_t fp, SkillVectors& out) {
+    const std::string data = file_contents(path);
+    if (data.size() < sizeof(kCacheMagic) + 16 || std::memcmp(data.data(), kCacheMagic, sizeof(kCacheMagic)) != 0) {
+        return false;
+    }
 
-        if (dim == 0) dim = v.size();
-        if (v.size() != dim) {
-            throw std::runtime_error("SemanticMatcher: inconsistent embedding dim");
-        }
+    size_t at = sizeof(kCacheMagic);
+    auto take = [&](void* p, size_t n) {
+        if (n > data.size() - at) return false;
+        std::memcpy(p, data.data() + at, n);
+        at += n;
+        return true;
+    };
 
-        packed.insert(packed.end(), v.begin(), v.end());
+    uint64_t got_fp = 0;
+    uint32_t dim = 0, n = 0;
+    if (!take(&got_fp, 8) || !take(&dim, 4) || !take(&n, 4)) return false;
+    if (got_fp != fp || dim == 0) return false;
+
+    SkillVectors sv;
+    sv.dim = dim;
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t len = 0;
+        if (!take(&len, 4) || len > data.size() - at) return false;
+        std::string skill(data.data() + at, len);
+        at += len;
+
+        std::vector<float> v(dim);
+        if (!take(v.data(), sizeof(float) * dim)) return false;
+        sv.by_skill.emplace(std::move(skill), std::move(v));
     }
 
-    EmbeddingIndex idx;
-    if (dim == 0 || skills.empty()) {
-        return idx;
+    out = std::move(sv);
+    return true;
+}
+
+// written under a private name and renamed into place, so concurrent runs sharing
+// the cache never read a half-written file
+static bool save_skill_vectors(const std::string& path, uint64_t fp, const SkillVectors& sv) {
+    std::string buf(kCacheMagic, sizeof(kCacheMagic));
+    auto put = [&buf](const void* p, size_t n) { buf.append((const char*)p, n); };
+    const uint32_t dim = (uint32_t)sv.dim;
+    const uint32_t n = (uint32_t)sv.by_skill.size();
+    put(&fp, 8);
+    put(&dim, 4);
+    put(&n, 4);
+    for (const auto& [skill, v] : sv.by_skill) {
+        const uint32_t len = (uint32_t)skill.size();
+        put(&len, 4);
+        put(skill.data(), len);
+        put(v.data(), sizeof(float) * v.size());
     }
 
-    idx.set(std::move(skills), std::move(packed), dim);
-    return idx;
+    std::error_code ec;
+    const fs::path target(path);
+    if (target.has_parent_path()) fs::create_directories(target.parent_path(), ec);
+
+    std::random_device rd;
+    const fs::path tmp = fs::path(path + ".tmp-" + std::to_string(((uint64_t)rd() << 32) ^ rd()));
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(buf.data(), (std::streamsize)buf.size());
+        out.close();
+        if (out.fail()) {
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+    fs::rename(tmp, target, ec);
+    if (ec) fs::remove(tmp, ec);
+    return !ec;
 }
 
 std::unique_ptr<SemanticMatcher> build_profile_semantic_matcher(
-    const std::map<std::string, double>& profile_skill_weights,
+    const std::unordered_map<textutil::TokenId, double>& profile_skill_weights,
     const MiniLmEmbedder& embedder,
-    const SemanticMatcherConfig& cfg
+    const SemanticMatcherConfig& cfg,
+    SemanticIndexStats* stats
 ) {
-    // Try loading cached index if requested and file exists
-    if (!cfg.cache_path.empty()) {
-        EmbeddingIndex cached;
-        if (cached.load(cfg.cache_path)) {
-            return std::make_unique<SemanticMatcherImpl>(std::move(cached), &embedder, cfg);
+    std::vector<std::string> skills = profile_skill_targets(profile_skill_weights);
+
+    const bool use_cache = !cfg.cache_path.empty();
+    const uint64_t fp = use_cache ? embedder_fingerprint(cfg) : 0;
+
+    SkillVectors sv;
+    const bool loaded = use_cache && load_skill_vectors(cfg.cache_path, fp, sv);
+
+    std::vector<std::string> missing;
+    for (const auto& s : skills) {
+        if (sv.by_skill.find(s) == sv.by_skill.end()) missing.push_back(s);
+    }
+
+    size_t embedded = 0;
+    for (size_t at = 0; at < missing.size(); at += kQueryBatch) {
+        const size_t end = std::min(missing.size(), at + kQueryBatch);
+        const auto vecs = embedder.embed_batch(std::vector<std::string>(missing.begin() + at, missing.begin() + end));
+
+        for (size_t j = 0; j < vecs.size(); ++j) {
+            const auto& v = vecs[j];
+            if (v.empty()) continue;
+
+            if (sv.dim == 0) sv.dim = v.size();
+            if (v.size() != sv.dim) {
+                throw std::runtime_error("SemanticMatcher: inconsistent embedding dim");
+            }
+
+            sv.by_skill[missing[at + j]] = v;
+            ++embedded;
         }
     }
 
-    EmbeddingIndex idx = build_index_from_profile(profile_skill_weights, embedder);
+    std::vector<std::string> ids;
+    std::vector<float> packed;
+    ids.reserve(skills.size());
+    packed.reserve(skills.size() * sv.dim);
+    for (auto& s : skills) {
+        auto it = sv.by_skill.find(s);
+        if (it == sv.by_skill.end()) continue; // failed to embed
+        packed.insert(packed.end(), it->second.begin(), it->second.end());
+        ids.push_back(std::move(s));
+    }
+
+    bool written = false;
+    if (use_cache && (!loaded || embedded > 0) && sv.dim > 0) {
+        written = save_skill_vectors(cfg.cache_path, fp, sv);
+    }
 
-    // Save cache if requested
-    if (!cfg.cache_path.empty()) {
-        fs::create_directories(fs::path(cfg.cache_path).parent_path());
-        (void)idx.save(cfg.cache_path);
+    if (stats) {
+        stats->skills = ids.size();
+        stats->embedded = embedded;
+        stats->reused = ids.size() - std::min(ids.size(), embedded);
+        stats->cache_written = written;
     }
 
+    EmbeddingIndex idx;
+    if (sv.dim > 0 && !ids.empty()) idx.set(std::move(ids), std::move(packed), sv.dim);
+
     return std::make_unique<SemanticMatcherImpl>(std::move(idx), &embedder, cfg);
 }
 